@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A/B-сравнение результатов бенчмарков: два набора JSON-файлов (повторные
+// прогоны базовой и проверяемой сборки), по каждой метрике - медианы с
+// доверительными интервалами, изменение медианы с бутстрэп-интервалом и
+// U-критерий Манна-Уитни. Понимает формат examples/common/benchmark_json.h
+// ("results"/"samples") и render_benchmark ("scenes"/"samples_ms").
+// Единица наблюдения - прогон: замеры внутри файла (кадры одного прогона)
+// не независимы, поэтому каждый файл сводится к медиане по метрике, и
+// статистика считается по прогонам.
+// Код выхода 1 - есть значимые регрессии
+
+// ============================================================================
+// Минимальный разбор JSON
+// ============================================================================
+
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* Find(const char* key) const {
+        for (const auto& [name, value] : object) {
+            if (name == key) {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    bool Parse(JsonValue& value) {
+        return ParseValue(value) && (SkipSpace(), position_ == text_.size());
+    }
+
+private:
+    const std::string& text_;
+    size_t position_ = 0;
+
+    void SkipSpace() {
+        while (position_ < text_.size() && std::strchr(" \t\r\n", text_[position_])) {
+            ++position_;
+        }
+    }
+
+    bool Consume(char c) {
+        SkipSpace();
+        if (position_ < text_.size() && text_[position_] == c) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    bool ConsumeWord(const char* word) {
+        size_t length = std::strlen(word);
+        if (text_.compare(position_, length, word) == 0) {
+            position_ += length;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseValue(JsonValue& value) {
+        SkipSpace();
+        if (position_ >= text_.size()) {
+            return false;
+        }
+
+        char c = text_[position_];
+        if (c == '{') {
+            ++position_;
+            value.type = JsonValue::Type::Object;
+            if (Consume('}')) {
+                return true;
+            }
+            do {
+                std::string key;
+                JsonValue member;
+                SkipSpace();
+                if (!ParseString(key) || !Consume(':') || !ParseValue(member)) {
+                    return false;
+                }
+                value.object.emplace_back(std::move(key), std::move(member));
+            } while (Consume(','));
+            return Consume('}');
+        }
+        if (c == '[') {
+            ++position_;
+            value.type = JsonValue::Type::Array;
+            if (Consume(']')) {
+                return true;
+            }
+            do {
+                JsonValue element;
+                if (!ParseValue(element)) {
+                    return false;
+                }
+                value.array.push_back(std::move(element));
+            } while (Consume(','));
+            return Consume(']');
+        }
+        if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return ParseString(value.string);
+        }
+        if (ConsumeWord("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return true;
+        }
+        if (ConsumeWord("false")) {
+            value.type = JsonValue::Type::Bool;
+            return true;
+        }
+        if (ConsumeWord("null")) {
+            value.type = JsonValue::Type::Null;
+            return true;
+        }
+
+        const char* begin = text_.c_str() + position_;
+        char* end = nullptr;
+        value.number = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        value.type = JsonValue::Type::Number;
+        position_ += end - begin;
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        if (position_ >= text_.size() || text_[position_] != '"') {
+            return false;
+        }
+        for (++position_; position_ < text_.size(); ++position_) {
+            char c = text_[position_];
+            if (c == '"') {
+                ++position_;
+                return true;
+            }
+            if (c == '\\' && position_ + 1 < text_.size()) {
+                char escaped = text_[++position_];
+                switch (escaped) {
+                    case 'n': out.push_back('\n'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'u': out.push_back('?'); position_ += 4; break;     // Имена метрик - ASCII
+                    default: out.push_back(escaped); break;
+                }
+            } else {
+                out.push_back(c);
+            }
+        }
+        return false;
+    }
+};
+
+// ============================================================================
+// Загрузка результатов
+// ============================================================================
+
+struct Metric {
+    std::string unit;
+    bool lower_is_better = true;
+    std::vector<double> samples;    // По значению (медиане файла) на прогон
+};
+
+// Ключ - "бенчмарк/метрика"
+using ResultSet = std::map<std::string, Metric>;
+
+static double Median(std::vector<double> values);
+
+static bool LoadResults(const std::string& path, ResultSet& results) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    JsonValue root;
+    if (!JsonParser(text).Parse(root) || root.type != JsonValue::Type::Object) {
+        fprintf(stderr, "%s: invalid JSON\n", path.c_str());
+        return false;
+    }
+
+    const JsonValue* benchmark = root.Find("benchmark");
+    std::string prefix = benchmark && benchmark->type == JsonValue::Type::String ? benchmark->string + "/" : "";
+
+    const JsonValue* entries = root.Find("results");
+    bool render = false;
+    if (!entries) {
+        entries = root.Find("scenes");
+        render = true;
+    }
+    if (!entries || entries->type != JsonValue::Type::Array) {
+        fprintf(stderr, "%s: no \"results\" or \"scenes\" array\n", path.c_str());
+        return false;
+    }
+
+    for (const JsonValue& entry : entries->array) {
+        const JsonValue* name = entry.Find("name");
+        const JsonValue* samples = entry.Find(render ? "samples_ms" : "samples");
+        if (!name || name->type != JsonValue::Type::String) {
+            continue;
+        }
+
+        Metric& metric = results[prefix + name->string];
+        const JsonValue* unit = entry.Find("unit");
+        const JsonValue* lower = entry.Find("lower_is_better");
+        metric.unit = unit && unit->type == JsonValue::Type::String ? unit->string : (render ? "ms" : "");
+        metric.lower_is_better = lower && lower->type == JsonValue::Type::Bool ? lower->boolean : true;
+
+        std::vector<double> values;
+        if (samples && samples->type == JsonValue::Type::Array) {
+            for (const JsonValue& sample : samples->array) {
+                if (sample.type == JsonValue::Type::Number) {
+                    values.push_back(sample.number);
+                }
+            }
+        } else if (const JsonValue* p50 = entry.Find("p50_ms")) {
+            // render_benchmark --no-samples: медиана уже посчитана
+            values.push_back(p50->number);
+        }
+        if (!values.empty()) {
+            metric.samples.push_back(Median(std::move(values)));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Статистика
+// ============================================================================
+
+static double Median(std::vector<double> values) {
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+    if (values.size() % 2) {
+        return upper;
+    }
+    return (upper + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+}
+
+// Непараметрический интервал медианы по порядковым статистикам (биномиальный,
+// нормальное приближение); при малом n - весь размах
+static std::pair<double, double> MedianInterval(std::vector<double> values, double z) {
+    std::sort(values.begin(), values.end());
+    double n = static_cast<double>(values.size());
+    double half = z * std::sqrt(n) / 2.0;
+    long lower = static_cast<long>(std::floor(n / 2.0 - half));
+    long upper = static_cast<long>(std::ceil(n / 2.0 + half));
+    lower = std::max(0L, lower);
+    upper = std::min(static_cast<long>(values.size()) - 1, upper);
+    return {values[lower], values[upper]};
+}
+
+// Бутстрэп-интервал относительного изменения медианы B к A (в долях)
+static std::pair<double, double> BootstrapChange(const std::vector<double>& a, const std::vector<double>& b,
+                                                 double confidence, int resamples) {
+    std::mt19937_64 gen(12345);
+    std::vector<double> changes;
+    std::vector<double> sampleA(a.size());
+    std::vector<double> sampleB(b.size());
+    std::uniform_int_distribution<size_t> pickA(0, a.size() - 1);
+    std::uniform_int_distribution<size_t> pickB(0, b.size() - 1);
+
+    for (int r = 0; r < resamples; ++r) {
+        for (double& value : sampleA) {
+            value = a[pickA(gen)];
+        }
+        for (double& value : sampleB) {
+            value = b[pickB(gen)];
+        }
+        double medianA = Median(sampleA);
+        if (medianA != 0.0) {
+            changes.push_back(Median(sampleB) / medianA - 1.0);
+        }
+    }
+    if (changes.empty()) {
+        return {0.0, 0.0};
+    }
+
+    std::sort(changes.begin(), changes.end());
+    double tail = (1.0 - confidence) / 2.0;
+    size_t lower = static_cast<size_t>(tail * (changes.size() - 1));
+    size_t upper = static_cast<size_t>((1.0 - tail) * (changes.size() - 1));
+    return {changes[lower], changes[upper]};
+}
+
+// Наименьшее p точного двустороннего U-критерия при n и m прогонах:
+// все прогоны B по одну сторону от всех прогонов A
+static double MinimumP(size_t n, size_t m) {
+    double arrangements = 1.0;
+    for (size_t k = 1; k <= n; ++k) {
+        arrangements = arrangements * static_cast<double>(m + k) / static_cast<double>(k);
+    }
+    return std::min(1.0, 2.0 / arrangements);
+}
+
+// Двусторонний U-критерий Манна-Уитни. Без совпадений и при малых выборках -
+// точное распределение U, иначе нормальное приближение с поправкой на
+// совпадения и непрерывность
+static double MannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    size_t n = a.size();
+    size_t m = b.size();
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n + m);
+    for (double value : a) {
+        all.emplace_back(value, 0);
+    }
+    for (double value : b) {
+        all.emplace_back(value, 1);
+    }
+    std::sort(all.begin(), all.end());
+
+    // Средние ранги для совпадений
+    double rankSumA = 0.0;
+    double tieTerm = 0.0;
+    for (size_t i = 0; i < all.size(); ) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) {
+                rankSumA += rank;
+            }
+        }
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double u = rankSumA - n * (n + 1) / 2.0;
+    double mean = n * m / 2.0;
+
+    if (tieTerm == 0.0 && n * m <= 400) {
+        // count[k][u]: число размещений k элементов A среди первых позиций с данным U
+        std::vector<std::vector<double>> count(n + 1, std::vector<double>(n * m + 1, 0.0));
+        count[0][0] = 1.0;
+        for (size_t step = 1; step <= n + m; ++step) {
+            std::vector<std::vector<double>> next(n + 1, std::vector<double>(n * m + 1, 0.0));
+            for (size_t k = 0; k <= n && k <= step; ++k) {
+                size_t fromB = step - k;
+                if (fromB > m) {
+                    continue;
+                }
+                for (size_t value = 0; value <= n * m; ++value) {
+                    // Последний - из B: U не меняется; из A: U растет на число B перед ним
+                    double ways = fromB > 0 ? count[k][value] : 0.0;
+                    if (k > 0 && value >= fromB) {
+                        ways += count[k - 1][value - fromB];
+                    }
+                    next[k][value] = ways;
+                }
+            }
+            count.swap(next);
+        }
+
+        double total = 0.0;
+        double extreme = 0.0;
+        double distance = std::fabs(u - mean);
+        for (size_t value = 0; value <= n * m; ++value) {
+            total += count[n][value];
+            if (std::fabs(value - mean) >= distance - 1e-9) {
+                extreme += count[n][value];
+            }
+        }
+        return std::min(1.0, extreme / total);
+    }
+
+    double total = static_cast<double>(n + m);
+    double variance = n * m / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+    double z = (std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+    return std::min(1.0, std::erfc(std::max(0.0, z) / std::sqrt(2.0)));
+}
+
+// ============================================================================
+// Отчет
+// ============================================================================
+
+struct Options {
+    std::vector<std::string> baseline;
+    std::vector<std::string> candidate;
+    double alpha = 0.05;            // Порог значимости
+    double threshold = 0.02;        // Минимальное изменение медианы, считающееся существенным
+    double confidence = 0.95;
+    int resamples = 2000;
+};
+
+static void PrintUsage() {
+    fprintf(stderr,
+            "usage: benchmark_compare --baseline A1.json [A2.json ...] --candidate B1.json [B2.json ...]\n"
+            "                         [--alpha 0.05] [--threshold 2] [--confidence 95]\n"
+            "  each file is one run, reduced to its median per metric; at alpha 0.05\n"
+            "  four runs per side are enough for a verdict\n"
+            "  --threshold  minimum median change, %%, reported as a regression or improvement\n");
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<std::string>* files = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--baseline") {
+            files = &options.baseline;
+        } else if (arg == "--candidate") {
+            files = &options.candidate;
+        } else if (arg == "--alpha" && hasValue) {
+            options.alpha = std::atof(argv[++i]);
+        } else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::atof(argv[++i]) / 100.0;
+        } else if (arg == "--confidence" && hasValue) {
+            options.confidence = std::atof(argv[++i]) / 100.0;
+        } else if (files && arg.rfind("--", 0) != 0) {
+            files->push_back(arg);
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (options.baseline.empty() || options.candidate.empty() ||
+        options.confidence <= 0.0 || options.confidence >= 1.0) {
+        PrintUsage();
+        return 2;
+    }
+
+    ResultSet baseline;
+    ResultSet candidate;
+    for (const auto& path : options.baseline) {
+        if (!LoadResults(path, baseline)) {
+            return 2;
+        }
+    }
+    for (const auto& path : options.candidate) {
+        if (!LoadResults(path, candidate)) {
+            return 2;
+        }
+    }
+
+    // z для интервала медианы: обратная функция нормального распределения
+    // подбором по erfc (достаточно для отчета)
+    double z = 0.0;
+    while (std::erfc(z / std::sqrt(2.0)) > 1.0 - options.confidence) {
+        z += 0.001;
+    }
+
+    printf("baseline: %zu file(s), candidate: %zu file(s), alpha %.3g, threshold %.1f%%, CI %.0f%%\n\n",
+           options.baseline.size(), options.candidate.size(), options.alpha, options.threshold * 100.0,
+           options.confidence * 100.0);
+    int width = 24;
+    for (const auto& [name, metric] : baseline) {
+        width = std::max(width, static_cast<int>(name.size() + metric.unit.size() + 2));
+    }
+
+    printf("%-*s %8s %26s %26s %28s %9s  %s\n", width,
+           "metric", "runs A/B", "median A [CI]", "median B [CI]", "change [CI]", "p", "verdict");
+
+    int regressions = 0;
+    int improvements = 0;
+    for (const auto& [name, a] : baseline) {
+        auto it = candidate.find(name);
+        if (it == candidate.end()) {
+            printf("%-*s  missing in candidate\n", width, name.c_str());
+            continue;
+        }
+        const Metric& b = it->second;
+        if (a.samples.empty() || b.samples.empty()) {
+            printf("%-*s  no samples\n", width, name.c_str());
+            continue;
+        }
+
+        double medianA = Median(a.samples);
+        double medianB = Median(b.samples);
+        auto intervalA = MedianInterval(a.samples, z);
+        auto intervalB = MedianInterval(b.samples, z);
+        auto change = BootstrapChange(a.samples, b.samples, options.confidence, options.resamples);
+        double relative = medianA != 0.0 ? medianB / medianA - 1.0 : 0.0;
+        double p = MannWhitneyP(a.samples, b.samples);
+
+        // Хуже - рост для "меньше лучше" и падение для "больше лучше"
+        const char* verdict = "~";
+        if (MinimumP(a.samples.size(), b.samples.size()) >= options.alpha) {
+            // Прогонов слишком мало: значимость недостижима при любом результате
+            verdict = "too few runs";
+        } else if (p < options.alpha && std::fabs(relative) >= options.threshold) {
+            bool worse = a.lower_is_better ? relative > 0.0 : relative < 0.0;
+            verdict = worse ? "REGRESSION" : "improvement";
+            (worse ? regressions : improvements)++;
+        }
+
+        char sizes[32];
+        char columnA[64];
+        char columnB[64];
+        char columnChange[64];
+        std::snprintf(sizes, sizeof(sizes), "%zu/%zu", a.samples.size(), b.samples.size());
+        std::snprintf(columnA, sizeof(columnA), "%.4g [%.4g, %.4g]", medianA, intervalA.first, intervalA.second);
+        std::snprintf(columnB, sizeof(columnB), "%.4g [%.4g, %.4g]", medianB, intervalB.first, intervalB.second);
+        std::snprintf(columnChange, sizeof(columnChange), "%+.2f%% [%+.2f%%, %+.2f%%]",
+                      relative * 100.0, change.first * 100.0, change.second * 100.0);
+
+        std::string label = name + (a.unit.empty() ? "" : ", " + a.unit);
+        printf("%-*s %8s %26s %26s %28s %9.2g  %s\n",
+               width, label.c_str(), sizes, columnA, columnB, columnChange, p, verdict);
+    }
+
+    for (const auto& [name, b] : candidate) {
+        if (!baseline.count(name)) {
+            printf("%-*s  new in candidate\n", width, name.c_str());
+        }
+    }
+
+    printf("\n%d regression(s), %d improvement(s)\n", regressions, improvements);
+    return regressions > 0 ? 1 : 0;
+}
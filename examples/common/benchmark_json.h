@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Машиночитаемые результаты бенчмарков для benchmark_compare:
+// {"benchmark": имя, "results": [{"name", "unit", "lower_is_better", "samples": [...]}]}.
+// Один прогон - одно или несколько значений на метрику; повторные прогоны
+// сравниваются как наборы файлов
+class BenchmarkJson {
+public:
+    explicit BenchmarkJson(std::string benchmark) : benchmark_(std::move(benchmark)) {}
+
+    void Add(const std::string& name, double value, const char* unit, bool lower_is_better) {
+        AddSamples(name, std::vector<double>{value}, unit, lower_is_better);
+    }
+
+    void AddSamples(const std::string& name, std::vector<double> samples, const char* unit, bool lower_is_better) {
+        results_.push_back({name, unit, lower_is_better, std::move(samples)});
+    }
+
+    // Пустой путь - ничего не пишется
+    bool Write(const std::string& path) const {
+        if (path.empty()) {
+            return true;
+        }
+
+        FILE* out = fopen(path.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "cannot open %s\n", path.c_str());
+            return false;
+        }
+
+        fprintf(out, "{\n  \"benchmark\": \"%s\",\n  \"results\": [\n", benchmark_.c_str());
+        for (size_t r = 0; r < results_.size(); ++r) {
+            const Result& result = results_[r];
+            fprintf(out, "    {\"name\": \"%s\", \"unit\": \"%s\", \"lower_is_better\": %s, \"samples\": [",
+                    result.name.c_str(), result.unit, result.lower_is_better ? "true" : "false");
+            for (size_t i = 0; i < result.samples.size(); ++i) {
+                fprintf(out, "%s%.6g", i ? ", " : "", result.samples[i]);
+            }
+            fprintf(out, "]}%s\n", r + 1 < results_.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+        fclose(out);
+        return true;
+    }
+
+    // Извлекает "--json FILE" из argv, чтобы позиционные аргументы не сдвигались
+    static std::string TakeOption(int& argc, char** argv) {
+        std::string path;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+                path = argv[i + 1];
+                for (int j = i; j + 2 < argc; ++j) {
+                    argv[j] = argv[j + 2];
+                }
+                argc -= 2;
+                argv[argc] = nullptr;
+                break;
+            }
+        }
+        return path;
+    }
+
+private:
+    struct Result {
+        std::string name;
+        const char* unit;
+        bool lower_is_better;
+        std::vector<double> samples;
+    };
+
+    std::string benchmark_;
+    std::vector<Result> results_;
+};
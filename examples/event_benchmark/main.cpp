@@ -0,0 +1,237 @@
+#include "src/events/event_system.h"
+#include "examples/common/benchmark_json.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WxeUI::events;
+
+class BenchmarkEvent : public Event {
+public:
+    DEFINE_EVENT(BenchmarkEvent)
+
+    BenchmarkEvent(uint64_t sequence, int priority) : sequence_(sequence) { SetPriority(priority); }
+
+    uint64_t GetSequence() const { return sequence_; }
+
+private:
+    uint64_t sequence_;
+};
+
+struct ProducerResult {
+    size_t producers = 0;
+    double events_per_second = 0.0;
+    double enqueue_p50_ns = 0.0;
+    double enqueue_p99_ns = 0.0;
+    double enqueue_p999_ns = 0.0;
+    EventQueueStats stats;
+};
+
+static double Percentile(std::vector<uint32_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static ProducerResult RunProducers(size_t producers, size_t events_per_producer, OverflowPolicy policy) {
+    EventDispatcher dispatcher;
+    dispatcher.SetMaxQueueSize(EventDispatcher::kBandCapacity);
+    dispatcher.SetOverflowPolicy(policy);
+    dispatcher.SetBackpressureTimeout(std::chrono::microseconds(100000));
+
+    std::atomic<uint64_t> delivered{0};
+    dispatcher.Subscribe<BenchmarkEvent>([&](const BenchmarkEvent&) {
+        delivered.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<std::vector<uint32_t>> latencies(producers);
+    std::vector<std::thread> threads;
+    std::atomic<bool> start{false};
+
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            // Канал на производителя: порядок внутри потока, параллелизм между потоками
+            EventChannel channel = EventDispatcher::CreateChannel();
+            auto& samples = latencies[p];
+            samples.reserve(events_per_producer);
+
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < events_per_producer; ++i) {
+                // Приоритеты распределены по всем полосам
+                int priority = static_cast<int>(i % 4) * 5 - 1;
+
+                auto begin = std::chrono::steady_clock::now();
+                dispatcher.DispatchTo<BenchmarkEvent>(channel, i, priority);
+                auto end = std::chrono::steady_clock::now();
+
+                samples.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Ждем, пока потоки обработки доставят все принятые события
+    const uint64_t total = producers * events_per_producer;
+    for (;;) {
+        EventQueueStats stats = dispatcher.GetQueueStats();
+        if (stats.processed + stats.dropped + stats.coalesced >= total && dispatcher.GetQueueSize() == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<uint32_t> merged;
+    merged.reserve(total);
+    for (const auto& samples : latencies) {
+        merged.insert(merged.end(), samples.begin(), samples.end());
+    }
+
+    ProducerResult result;
+    result.producers = producers;
+    result.events_per_second = delivered.load() / std::chrono::duration<double>(end - begin).count();
+    result.enqueue_p50_ns = Percentile(merged, 0.50);
+    result.enqueue_p99_ns = Percentile(merged, 0.99);
+    result.enqueue_p999_ns = Percentile(merged, 0.999);
+    result.stats = dispatcher.GetQueueStats();
+    return result;
+}
+
+struct ListenerContentionResult {
+    double events_per_second = 0.0;
+    double subscribe_p50_ns = 0.0;
+    double subscribe_p99_ns = 0.0;
+    double subscribe_max_ns = 0.0;
+    size_t subscriptions = 0;
+};
+
+// Потоки обработки доставляют события медленному слушателю, пока отдельный поток
+// непрерывно подписывается и отписывается: подписка не должна ждать слушателей
+static ListenerContentionResult RunListenerContention(size_t events, int workers, std::chrono::microseconds slowListener) {
+    EventDispatcher dispatcher;
+    dispatcher.SetProcessingThreadCount(workers);
+    dispatcher.SetMaxQueueSize(EventDispatcher::kBandCapacity);
+    dispatcher.SetOverflowPolicy(OverflowPolicy::BACKPRESSURE);
+    dispatcher.SetBackpressureTimeout(std::chrono::microseconds(1000000));
+
+    std::atomic<uint64_t> delivered{0};
+    dispatcher.Subscribe<BenchmarkEvent>([&](const BenchmarkEvent& event) {
+        if (event.GetSequence() % 64 == 0) {
+            std::this_thread::sleep_for(slowListener);
+        }
+        delivered.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool> done{false};
+    std::vector<uint32_t> subscribeLatencies;
+    std::thread churn([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            auto begin = std::chrono::steady_clock::now();
+            SubscriptionToken token = dispatcher.Subscribe<BenchmarkEvent>([](const BenchmarkEvent&) {});
+            dispatcher.Unsubscribe(token);
+            auto end = std::chrono::steady_clock::now();
+
+            subscribeLatencies.push_back(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+
+    auto begin = std::chrono::steady_clock::now();
+    // Без упорядочивания: измеряется параллельная доставка, а не порядок канала
+    for (size_t i = 0; i < events; ++i) {
+        dispatcher.DispatchTo<BenchmarkEvent>(kUnorderedChannel, i, 0);
+    }
+    while (delivered.load(std::memory_order_relaxed) < events) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    done.store(true, std::memory_order_release);
+    churn.join();
+
+    ListenerContentionResult result;
+    result.events_per_second = events / std::chrono::duration<double>(end - begin).count();
+    result.subscriptions = subscribeLatencies.size();
+    result.subscribe_p50_ns = Percentile(subscribeLatencies, 0.50);
+    result.subscribe_p99_ns = Percentile(subscribeLatencies, 0.99);
+    result.subscribe_max_ns = Percentile(subscribeLatencies, 1.0);
+    return result;
+}
+
+static void RunListenerBenchmark(size_t events, BenchmarkJson& json) {
+    printf("=== Listener Contention Benchmark (%zu events, slow listener every 64th event) ===\n", events);
+    printf("%-10s %12s %14s %14s %14s %14s\n",
+           "workers", "slow us", "events/sec", "sub p50 ns", "sub p99 ns", "sub max ns");
+
+    for (int workers : {1, 2, 4, 8}) {
+        for (int slowUs : {0, 200}) {
+            ListenerContentionResult r = RunListenerContention(events, workers, std::chrono::microseconds(slowUs));
+            printf("%-10d %12d %14.0f %14.0f %14.0f %14.0f\n",
+                   workers, slowUs, r.events_per_second, r.subscribe_p50_ns, r.subscribe_p99_ns, r.subscribe_max_ns);
+
+            std::string suffix = " workers " + std::to_string(workers) + " slow " + std::to_string(slowUs) + "us";
+            json.Add("events/sec" + suffix, r.events_per_second, "events/s", false);
+            json.Add("subscribe p99" + suffix, r.subscribe_p99_ns, "ns", true);
+        }
+    }
+}
+
+static OverflowPolicy ParsePolicy(const char* name) {
+    if (std::strcmp(name, "drop") == 0) return OverflowPolicy::DROP_OLDEST_LOWEST;
+    if (std::strcmp(name, "coalesce") == 0) return OverflowPolicy::COALESCE;
+    return OverflowPolicy::BACKPRESSURE;
+}
+
+int main(int argc, char** argv) {
+    std::string json_path = BenchmarkJson::TakeOption(argc, argv);
+    size_t events_per_producer = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const char* policy_name = argc > 2 ? argv[2] : "backpressure";
+    if (std::strcmp(policy_name, "listeners") == 0) {
+        BenchmarkJson json("event_benchmark listeners");
+        RunListenerBenchmark(events_per_producer, json);
+        return json.Write(json_path) ? 0 : 1;
+    }
+
+    OverflowPolicy policy = ParsePolicy(policy_name);
+
+    printf("=== Event Queue Benchmark (%zu events/producer, policy %s, %u hw threads) ===\n",
+           events_per_producer, policy_name, std::thread::hardware_concurrency());
+    printf("%-10s %14s %12s %12s %12s %10s %10s %10s\n",
+           "producers", "events/sec", "p50 ns", "p99 ns", "p99.9 ns", "dropped", "coalesced", "bp waits");
+
+    BenchmarkJson json(std::string("event_benchmark ") + policy_name);
+    for (size_t producers : {1, 2, 4, 8, 16}) {
+        ProducerResult r = RunProducers(producers, events_per_producer, policy);
+        printf("%-10zu %14.0f %12.0f %12.0f %12.0f %10llu %10llu %10llu\n",
+               r.producers, r.events_per_second, r.enqueue_p50_ns, r.enqueue_p99_ns, r.enqueue_p999_ns,
+               static_cast<unsigned long long>(r.stats.dropped),
+               static_cast<unsigned long long>(r.stats.coalesced),
+               static_cast<unsigned long long>(r.stats.backpressure_waits));
+
+        std::string suffix = " x" + std::to_string(producers);
+        json.Add("events/sec" + suffix, r.events_per_second, "events/s", false);
+        json.Add("enqueue p50" + suffix, r.enqueue_p50_ns, "ns", true);
+        json.Add("enqueue p99" + suffix, r.enqueue_p99_ns, "ns", true);
+    }
+
+    return json.Write(json_path) ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "src/rendering/frame_pacer.h"
+#include "examples/common/benchmark_json.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WxeUI;
+using Clock = rendering::FramePacer::Clock;
+
+// Безоконная проверка точности FramePacer: цикл кадров с имитацией работы
+// (активное ожидание 20..60% интервала) при разных частотах. Сравниваются:
+// - sleep_for(интервал - время кадра) - прежняя схема;
+// - сон ОС до абсолютного срока без активного ожидания;
+// - FramePacer (сон до срока минус порог + активное ожидание).
+// Ошибка срока - опоздание начала кадра относительно сетки, дрейф -
+// расхождение начала последнего кадра с сеткой с момента старта
+
+struct PacingResult {
+    std::vector<double> errorsUs;       // Опоздание начала кадра относительно своего срока
+    double driftUs = 0.0;               // Конец прогона: фактическое - идеальное время
+    uint64_t missed = 0;
+};
+
+enum class Strategy { SLEEP_REMAINDER, ABSOLUTE_SLEEP, HYBRID };
+
+static const char* GetStrategyName(Strategy strategy) {
+    switch (strategy) {
+        case Strategy::SLEEP_REMAINDER: return "sleep_for remainder";
+        case Strategy::ABSOLUTE_SLEEP: return "absolute sleep";
+        case Strategy::HYBRID: return "sleep + spin";
+    }
+    return "";
+}
+
+static void SimulateWork(Clock::duration duration) {
+    auto end = Clock::now() + duration;
+    while (Clock::now() < end) {
+    }
+}
+
+static PacingResult RunPacing(Strategy strategy, float fps, int frames, uint32_t seed) {
+    rendering::FramePacer pacer(fps);
+    pacer.EnableVSync(false);
+    if (strategy == Strategy::ABSOLUTE_SLEEP) {
+        pacer.SetSpinThreshold(Clock::duration::zero());
+    }
+
+    Clock::duration interval = pacer.GetFrameInterval();
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> load(0.2, 0.6);
+
+    PacingResult result;
+    result.errorsUs.reserve(static_cast<size_t>(frames));
+
+    pacer.Reset();
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start;             // Срок начала текущего кадра
+    Clock::time_point frameStart = start;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        auto work = std::chrono::duration_cast<Clock::duration>(interval * load(gen));
+        SimulateWork(work);
+
+        if (strategy == Strategy::SLEEP_REMAINDER) {
+            // Срок неявный: начало кадра + интервал
+            auto elapsed = Clock::now() - frameStart;
+            deadline = frameStart + interval;
+            if (elapsed < interval) {
+                std::this_thread::sleep_for(interval - elapsed);
+            } else {
+                result.missed++;
+            }
+        } else {
+            deadline = pacer.GetNextDeadline();
+            pacer.WaitForNextFrame();
+        }
+
+        frameStart = Clock::now();
+        result.errorsUs.push_back(std::chrono::duration<double, std::micro>(frameStart - deadline).count());
+    }
+
+    if (strategy != Strategy::SLEEP_REMAINDER) {
+        result.missed = pacer.GetJitterStats().missedDeadlines;
+    }
+    result.driftUs = std::chrono::duration<double, std::micro>(frameStart - (start + interval * frames)).count();
+    return result;
+}
+
+static double Percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char** argv) {
+    std::string json_path = BenchmarkJson::TakeOption(argc, argv);
+    double seconds = 2.0;
+    double max_p99_us = 0.0;            // > 0: код выхода 1, если p99 FramePacer хуже
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-p99-us") == 0 && i + 1 < argc) {
+            max_p99_us = std::atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: frame_pacing_benchmark [--seconds S] [--max-p99-us US] [--json FILE]\n");
+            return 2;
+        }
+    }
+
+    printf("=== Frame Pacing Benchmark (%.1f s per run, spin threshold %.0f us) ===\n", seconds,
+           std::chrono::duration<double, std::micro>(rendering::FramePacer::CalibrateSpinThreshold()).count());
+    printf("%-6s %-20s %10s %10s %10s %10s %12s %8s\n",
+           "fps", "strategy", "p50 us", "p99 us", "p99.9 us", "max us", "drift us", "missed");
+
+    BenchmarkJson json("frame_pacing_benchmark");
+    bool failed = false;
+    for (float fps : {60.0f, 120.0f, 144.0f, 240.0f}) {
+        int frames = std::max(10, static_cast<int>(fps * seconds));
+        for (Strategy strategy : {Strategy::SLEEP_REMAINDER, Strategy::ABSOLUTE_SLEEP, Strategy::HYBRID}) {
+            PacingResult r = RunPacing(strategy, fps, frames, 7);
+            double p99 = Percentile(r.errorsUs, 0.99);
+            printf("%-6.0f %-20s %10.1f %10.1f %10.1f %10.1f %12.0f %8llu\n", fps, GetStrategyName(strategy),
+                   Percentile(r.errorsUs, 0.50), p99, Percentile(r.errorsUs, 0.999),
+                   *std::max_element(r.errorsUs.begin(), r.errorsUs.end()), r.driftUs,
+                   static_cast<unsigned long long>(r.missed));
+
+            std::string name = std::string(GetStrategyName(strategy)) + " " + std::to_string(static_cast<int>(fps)) + " fps";
+            json.AddSamples("deadline error " + name, r.errorsUs, "us", true);
+
+            if (strategy == Strategy::HYBRID && max_p99_us > 0.0 && p99 > max_p99_us) {
+                failed = true;
+            }
+        }
+    }
+
+    if (failed) {
+        fprintf(stderr, "FramePacer p99 deadline error exceeds %.1f us\n", max_p99_us);
+    }
+    return json.Write(json_path) && !failed ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "src/rendering/frame_scheduler.h"
+#include "examples/common/benchmark_json.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WxeUI;
+using Clock = rendering::SchedulerClock::Clock;
+
+// Моделирование FrameScheduler на имитируемых часах: синтетические нагрузки
+// (стоимость кадра - доля интервала), старт сразу после показа предыдущего
+// кадра против старта "точно в срок". Возраст ввода - от начала кадра (сбор
+// ввода) до показа; пропуск - кадр закончен после своего срока, потеря -
+// срок без нового кадра (пропуск или срок, сорванный длинным кадром);
+// jit% - доля кадров, начатых по прогнозу.
+// Результат детерминирован: одинаков на любой машине
+
+struct Workload {
+    const char* name;
+    std::function<double(int, std::mt19937&)> cost;     // Номер кадра -> доля интервала
+};
+
+static std::vector<Workload> MakeWorkloads(int frames) {
+    return {
+        {"steady", [](int, std::mt19937& gen) {
+            return std::normal_distribution<double>(0.25, 0.02)(gen);
+        }},
+        {"noisy", [](int, std::mt19937& gen) {
+            return 0.3 * std::lognormal_distribution<double>(0.0, 0.35)(gen);
+        }},
+        {"spiky", [](int frame, std::mt19937& gen) {
+            double base = std::normal_distribution<double>(0.25, 0.02)(gen);
+            return frame % 30 == 29 ? base * 3.0 : base;
+        }},
+        {"ramp", [frames](int frame, std::mt19937& gen) {
+            double t = static_cast<double>(frame) / frames;
+            return (0.15 + 0.55 * t) * std::normal_distribution<double>(1.0, 0.05)(gen);
+        }},
+        {"heavy", [](int, std::mt19937& gen) {
+            return std::normal_distribution<double>(0.85, 0.05)(gen);
+        }},
+    };
+}
+
+struct SimulationResult {
+    rendering::FrameScheduler::Stats stats;
+    std::vector<double> inputAgeMs;
+};
+
+static SimulationResult Simulate(const Workload& workload, float fps, bool justInTime, int frames) {
+    rendering::SimulatedSchedulerClock clock(std::chrono::microseconds(100), 3);
+    rendering::FrameScheduler::Config config;
+    config.targetFPS = fps;
+    config.justInTime = justInTime;
+    rendering::FrameScheduler scheduler(clock, config);
+
+    std::mt19937 gen(11);
+    double interval = 1.0 / fps;
+    SimulationResult result;
+    result.inputAgeMs.reserve(static_cast<size_t>(frames));
+
+    for (int frame = 0; frame < frames; ++frame) {
+        auto timing = scheduler.BeginFrame();
+        double fraction = std::max(0.01, workload.cost(frame, gen));
+        auto cost = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(fraction * interval));
+        clock.Advance(cost);
+        scheduler.EndFrame(timing);
+
+        auto shown = std::max(timing.deadline, timing.start + cost);
+        result.inputAgeMs.push_back(std::chrono::duration<double, std::milli>(shown - timing.start).count());
+    }
+
+    result.stats = scheduler.GetStats();
+    return result;
+}
+
+static double Percentile(std::vector<double> values, double p) {
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char** argv) {
+    std::string json_path = BenchmarkJson::TakeOption(argc, argv);
+    int frames = argc > 1 ? std::atoi(argv[1]) : 3600;
+    frames = std::max(frames, 100);
+
+    printf("=== Frame Scheduler Simulation (%d frames, wake delay up to 100 us) ===\n", frames);
+    printf("%-6s %-8s %-12s %12s %12s %10s %10s %10s %8s %12s\n",
+           "fps", "workload", "mode", "age p50 ms", "age p99 ms", "missed %", "skipped", "dropped %", "jit %", "margin ms");
+
+    BenchmarkJson json("frame_scheduler_benchmark");
+    for (float fps : {60.0f, 120.0f}) {
+        for (const Workload& workload : MakeWorkloads(frames)) {
+            for (bool justInTime : {false, true}) {
+                SimulationResult r = Simulate(workload, fps, justInTime, frames);
+                double missed = 100.0 * static_cast<double>(r.stats.missedDeadlines) / frames;
+                double dropped = 100.0 * static_cast<double>(r.stats.droppedFrames) / frames;
+                double jit = 100.0 * static_cast<double>(r.stats.justInTimeFrames) / frames;
+                const char* mode = justInTime ? "just-in-time" : "immediate";
+                printf("%-6.0f %-8s %-12s %12.2f %12.2f %10.2f %10llu %10.2f %8.1f %12.2f\n",
+                       fps, workload.name, mode, Percentile(r.inputAgeMs, 0.50), Percentile(r.inputAgeMs, 0.99),
+                       missed, static_cast<unsigned long long>(r.stats.skippedDeadlines), dropped, jit, r.stats.marginMs);
+
+                std::string name = std::string(workload.name) + " " + mode + " " +
+                                   std::to_string(static_cast<int>(fps)) + " fps";
+                json.Add("input age p50 " + name, Percentile(r.inputAgeMs, 0.50), "ms", true);
+                json.Add("input age p99 " + name, Percentile(r.inputAgeMs, 0.99), "ms", true);
+                json.Add("missed " + name, missed, "%", true);
+                json.Add("dropped " + name, dropped, "%", true);
+            }
+        }
+    }
+
+    return json.Write(json_path) ? 0 : 1;
+}
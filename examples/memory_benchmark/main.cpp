@@ -0,0 +1,287 @@
+#include "src/memory/memory_manager.h"
+#include "examples/common/benchmark_json.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WxeUI::Memory;
+
+// Эталон: прежний first-fit пул (линейный поиск по std::vector<Block>,
+// сортировка и слияние при каждом освобождении) - для сравнения с TLSF
+class LegacyFirstFitPool {
+public:
+    explicit LegacyFirstFitPool(size_t size) : memory_(malloc(size)), size_(size) {
+        blocks_.push_back({memory_, size_, false});
+    }
+
+    ~LegacyFirstFitPool() { free(memory_); }
+
+    void* Allocate(size_t size) {
+        size_t aligned = (size + 15) & ~size_t(15);
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            if (!blocks_[i].in_use && blocks_[i].size >= aligned) {
+                if (blocks_[i].size > aligned + sizeof(Block)) {
+                    blocks_.push_back({static_cast<char*>(blocks_[i].ptr) + aligned, blocks_[i].size - aligned, false});
+                }
+                blocks_[i].size = aligned;
+                blocks_[i].in_use = true;
+                return blocks_[i].ptr;
+            }
+        }
+        return nullptr;
+    }
+
+    void Deallocate(void* ptr) {
+        for (auto& block : blocks_) {
+            if (block.ptr == ptr && block.in_use) {
+                block.in_use = false;
+                Merge();
+                return;
+            }
+        }
+    }
+
+    size_t GetFragmentation() const {
+        size_t total_free = 0, largest_free = 0;
+        for (const auto& block : blocks_) {
+            if (!block.in_use) {
+                total_free += block.size;
+                largest_free = std::max(largest_free, block.size);
+            }
+        }
+        return total_free ? ((total_free - largest_free) * 100) / total_free : 0;
+    }
+
+private:
+    struct Block {
+        void* ptr;
+        size_t size;
+        bool in_use;
+    };
+
+    void Merge() {
+        std::sort(blocks_.begin(), blocks_.end(), [](const Block& a, const Block& b) { return a.ptr < b.ptr; });
+        for (size_t i = 0; i + 1 < blocks_.size(); ) {
+            if (!blocks_[i].in_use && !blocks_[i + 1].in_use &&
+                static_cast<char*>(blocks_[i].ptr) + blocks_[i].size == blocks_[i + 1].ptr) {
+                blocks_[i].size += blocks_[i + 1].size;
+                blocks_.erase(blocks_.begin() + i + 1);
+                continue;
+            }
+            ++i;
+        }
+    }
+
+    void* memory_;
+    size_t size_;
+    std::vector<Block> blocks_;
+};
+
+// Операция сценария: выделение (size > 0) или освобождение слота
+struct Operation {
+    size_t slot;
+    size_t size;
+};
+
+// UI-подобное распределение размеров: строки и мелкие векторы, глиф-раны и пути,
+// небольшие битмапы, изредка поверхности слоев
+static size_t SampleUISize(std::mt19937& rng) {
+    std::uniform_int_distribution<int> bucket(0, 99);
+    int b = bucket(rng);
+
+    if (b < 60) return std::uniform_int_distribution<size_t>(16, 128)(rng);
+    if (b < 90) return std::uniform_int_distribution<size_t>(129, 4 * 1024)(rng);
+    if (b < 99) return std::uniform_int_distribution<size_t>(4 * 1024, 64 * 1024)(rng);
+    return std::uniform_int_distribution<size_t>(64 * 1024, 1024 * 1024)(rng);
+}
+
+static std::vector<Operation> GenerateWorkload(size_t operation_count, size_t live_slots, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<bool> occupied(live_slots, false);
+    std::vector<Operation> operations;
+    operations.reserve(operation_count);
+
+    std::uniform_int_distribution<size_t> slot_dist(0, live_slots - 1);
+    for (size_t i = 0; i < operation_count; ++i) {
+        size_t slot = slot_dist(rng);
+        operations.push_back({slot, occupied[slot] ? 0 : SampleUISize(rng)});
+        occupied[slot] = !occupied[slot];
+    }
+
+    return operations;
+}
+
+struct BenchmarkResult {
+    std::string name;
+    double ops_per_second = 0.0;
+    size_t fragmentation = 0;
+    size_t failed = 0;
+};
+
+template<typename AllocFn, typename FreeFn, typename FragFn>
+static BenchmarkResult RunWorkload(const std::string& name, const std::vector<Operation>& operations,
+                                   size_t live_slots, AllocFn alloc, FreeFn release, FragFn fragmentation) {
+    BenchmarkResult result;
+    result.name = name;
+
+    std::vector<void*> slots(live_slots, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& op : operations) {
+        if (op.size > 0) {
+            slots[op.slot] = alloc(op.size);
+            if (!slots[op.slot]) {
+                result.failed++;
+            }
+        } else if (slots[op.slot]) {
+            release(slots[op.slot]);
+            slots[op.slot] = nullptr;
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.ops_per_second = operations.size() / elapsed;
+    result.fragmentation = fragmentation();
+
+    for (void* ptr : slots) {
+        if (ptr) {
+            release(ptr);
+        }
+    }
+
+    return result;
+}
+
+// Многопоточный сценарий: каждый поток держит кольцо живых мелких блоков
+// (строки, узлы списков отображения) и на каждой итерации заменяет старейший
+template<typename AllocFn, typename FreeFn>
+static double RunThreadedWorkload(size_t thread_count, size_t ops_per_thread, AllocFn alloc, FreeFn release) {
+    const size_t ring_size = 256;
+    std::vector<std::thread> threads;
+    std::atomic<bool> go{false};
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<uint32_t>(1000 + t));
+            std::uniform_int_distribution<size_t> size_dist(16, 1024);
+            std::vector<size_t> sizes(ops_per_thread);
+            for (auto& size : sizes) {
+                size = size_dist(rng);
+            }
+            std::vector<void*> ring(ring_size, nullptr);
+
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < ops_per_thread; ++i) {
+                void*& slot = ring[i % ring_size];
+                if (slot) {
+                    release(slot);
+                }
+                slot = alloc(sizes[i]);
+            }
+            for (void* ptr : ring) {
+                if (ptr) {
+                    release(ptr);
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Выделение и освобождение считаются отдельными операциями
+    return (2.0 * thread_count * ops_per_thread) / elapsed;
+}
+
+static void RunThreadedBenchmark(size_t ops_per_thread, size_t pool_size, BenchmarkJson& json) {
+    printf("\n=== Multi-threaded small allocations (%zu ops/thread, 16..1024 B) ===\n", ops_per_thread);
+    printf("%-8s %18s %18s %18s\n", "threads", "pool (mutex)", "pool (magazines)", "malloc");
+
+    for (size_t thread_count : {1, 2, 4, 8, 16, 32}) {
+        MemoryPool::Config config;
+        config.initial_size = pool_size;
+        config.max_size = pool_size;
+
+        MemoryPool locked_pool(MemoryType::SYSTEM_RAM, config);
+        double locked = RunThreadedWorkload(thread_count, ops_per_thread,
+            [&](size_t size) { return locked_pool.Allocate(size); },
+            [&](void* ptr) { locked_pool.Deallocate(ptr); });
+
+        config.enable_thread_cache = true;
+        MemoryPool cached_pool(MemoryType::SYSTEM_RAM, config);
+        double cached = RunThreadedWorkload(thread_count, ops_per_thread,
+            [&](size_t size) { return cached_pool.AllocateCached(size); },
+            [&](void* ptr) { cached_pool.DeallocateCached(ptr); });
+
+        double system = RunThreadedWorkload(thread_count, ops_per_thread,
+            [](size_t size) { return malloc(size); },
+            [](void* ptr) { free(ptr); });
+
+        printf("%-8zu %18.0f %18.0f %18.0f\n", thread_count, locked, cached, system);
+
+        std::string suffix = " x" + std::to_string(thread_count);
+        json.Add("pool (mutex)" + suffix, locked, "ops/s", false);
+        json.Add("pool (magazines)" + suffix, cached, "ops/s", false);
+        json.Add("malloc" + suffix, system, "ops/s", false);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string json_path = BenchmarkJson::TakeOption(argc, argv);
+    size_t operation_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t live_slots = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+    size_t ops_per_thread = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200000;
+    const size_t pool_size = 64 * 1024 * 1024;
+
+    auto operations = GenerateWorkload(operation_count, live_slots, 42);
+    std::vector<BenchmarkResult> results;
+
+    {
+        LegacyFirstFitPool legacy(pool_size);
+        results.push_back(RunWorkload("first-fit (legacy)", operations, live_slots,
+            [&](size_t size) { return legacy.Allocate(size); },
+            [&](void* ptr) { legacy.Deallocate(ptr); },
+            [&] { return legacy.GetFragmentation(); }));
+    }
+
+    {
+        MemoryPool::Config config;
+        config.initial_size = pool_size;
+        config.max_size = pool_size;
+        MemoryPool pool(MemoryType::SYSTEM_RAM, config);
+        results.push_back(RunWorkload("MemoryPool (TLSF)", operations, live_slots,
+            [&](size_t size) { return pool.Allocate(size); },
+            [&](void* ptr) { pool.Deallocate(ptr); },
+            [&] { return pool.GetFragmentation(); }));
+    }
+
+    results.push_back(RunWorkload("malloc", operations, live_slots,
+        [](size_t size) { return malloc(size); },
+        [](void* ptr) { free(ptr); },
+        [] { return size_t(0); }));
+
+    printf("=== Memory Pool Benchmark (%zu ops, %zu live slots) ===\n", operation_count, live_slots);
+    printf("%-22s %16s %14s %8s\n", "allocator", "ops/sec", "fragmentation", "failed");
+    BenchmarkJson json("memory_benchmark");
+    for (const auto& r : results) {
+        printf("%-22s %16.0f %13zu%% %8zu\n", r.name.c_str(), r.ops_per_second, r.fragmentation, r.failed);
+        json.Add(r.name, r.ops_per_second, "ops/s", false);
+    }
+
+    RunThreadedBenchmark(ops_per_thread, pool_size, json);
+
+    return json.Write(json_path) ? 0 : 1;
+}
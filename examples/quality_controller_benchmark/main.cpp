@@ -0,0 +1,224 @@
+#include "src/rendering/quality_controller.h"
+#include "examples/common/benchmark_json.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WxeUI;
+
+// Моделирование QualityController на синтетических сценах. Стоимость кадра
+// = нагрузка сцены * стоимость настроек ступени * шум; стоимость настроек
+// складывается из ручек лестницы (тени - самая дорогая, поэтому соседние
+// с ней ступени - приманка для колебаний). Для сравнения - прежняя схема
+// FrameHigh::AdjustQuality: шаг -0.1/+0.05 по мгновенному FPS каждый кадр.
+// Разворот - смена ступени в сторону, противоположную предыдущей смене;
+// в стационарных сценах регулятор должен сойтись почти без разворотов
+
+struct Scenario {
+    const char* name;
+    bool stationary;                                        // Нагрузка не меняется - разворотов быть не должно
+    std::function<double(int, std::mt19937&)> load;         // Номер кадра -> нагрузка (1.0 - потолок ровно в бюджет)
+};
+
+struct SimulationResult {
+    uint64_t changes = 0;
+    uint64_t reversals = 0;
+    uint64_t failedUpgrades = 0;
+    double overBudgetPercent = 0.0;
+    double meanQuality = 0.0;
+    size_t finalRung = 0;
+    int lastChangeFrame = 0;
+};
+
+// Стоимость настроек относительно потолка по умолчанию (~1.0)
+static double SettingsCost(const rendering::QualitySettings& s) {
+    double cost = 0.30;
+    switch (s.antiAliasing) {
+        case rendering::AntiAliasingType::MSAA_8X: cost += 0.30; break;
+        case rendering::AntiAliasingType::MSAA_4X: cost += 0.15; break;
+        case rendering::AntiAliasingType::MSAA_2X: cost += 0.08; break;
+        case rendering::AntiAliasingType::TAA: cost += 0.06; break;
+        case rendering::AntiAliasingType::FXAA: cost += 0.03; break;
+        case rendering::AntiAliasingType::None: break;
+    }
+    if (s.enableBlur) {
+        cost += 0.04 + 0.10 * s.blurQuality;
+    }
+    if (s.enableShadows) {
+        cost += 0.25;
+    }
+    cost += 0.12 * s.fragmentCacheScale * s.fragmentCacheScale;
+    cost += 0.06 / (1.0 + s.lodBias);
+    return cost;
+}
+
+static std::vector<Scenario> MakeScenarios(int frames, double boundaryLoad) {
+    auto jitter = [](std::mt19937& gen, double sigma) {
+        return std::lognormal_distribution<double>(0.0, sigma)(gen);
+    };
+    return {
+        {"light", true, [jitter](int, std::mt19937& gen) { return 0.55 * jitter(gen, 0.08); }},
+        {"heavy", true, [jitter](int, std::mt19937& gen) { return 1.60 * jitter(gen, 0.08); }},
+        {"boundary", true, [jitter, boundaryLoad](int, std::mt19937& gen) { return boundaryLoad * jitter(gen, 0.08); }},
+        {"noisy", true, [jitter](int, std::mt19937& gen) { return 1.10 * jitter(gen, 0.30); }},
+        {"spikes", true, [jitter](int frame, std::mt19937& gen) {
+            return (frame % 90 == 89 ? 4.0 : 1.0) * 0.90 * jitter(gen, 0.08);
+        }},
+        {"step", false, [jitter, frames](int frame, std::mt19937& gen) {
+            bool heavy = frame >= frames / 3 && frame < 2 * frames / 3;
+            return (heavy ? 1.5 : 0.8) * jitter(gen, 0.08);
+        }},
+        {"throttle", false, [jitter, frames](int frame, std::mt19937& gen) {
+            return (0.7 + 0.7 * frame / frames) * jitter(gen, 0.08);
+        }},
+    };
+}
+
+class Recorder {
+public:
+    void Record(int frame, size_t rung) {
+        if (frame > 0 && rung != rung_) {
+            int direction = rung > rung_ ? 1 : -1;
+            if (direction_ != 0 && direction != direction_) {
+                result_.reversals++;
+            }
+            direction_ = direction;
+            result_.changes++;
+            result_.lastChangeFrame = frame;
+        }
+        rung_ = rung;
+    }
+
+    SimulationResult& Result() { return result_; }
+
+private:
+    SimulationResult result_;
+    size_t rung_ = 0;
+    int direction_ = 0;
+};
+
+static SimulationResult SimulateController(const Scenario& scenario, const std::vector<rendering::QualitySettings>& ladder,
+                                           float budgetMs, int frames) {
+    rendering::QualityController::Config config;
+    config.targetFrameMs = budgetMs;
+    rendering::QualityController controller(config);
+    controller.SetLadder(ladder);
+
+    std::mt19937 gen(5);
+    Recorder recorder;
+    uint64_t overBudget = 0;
+    double qualitySum = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        recorder.Record(frame, controller.GetRung());
+        double frameMs = budgetMs * scenario.load(frame, gen) * SettingsCost(controller.GetSettings());
+        overBudget += frameMs > budgetMs ? 1 : 0;
+        qualitySum += controller.GetQuality();
+        controller.AddFrame(static_cast<float>(frameMs));
+    }
+
+    SimulationResult& result = recorder.Result();
+    result.failedUpgrades = controller.GetStats().failedUpgrades;
+    result.overBudgetPercent = 100.0 * static_cast<double>(overBudget) / frames;
+    result.meanQuality = qualitySum / frames;
+    result.finalRung = controller.GetRung();
+    return result;
+}
+
+// Прежняя схема с общим уровнем 0..1; старт - с потолка, как у регулятора
+static SimulationResult SimulateLegacy(const Scenario& scenario, const std::vector<rendering::QualitySettings>& ladder,
+                                       float budgetMs, int frames) {
+    std::mt19937 gen(5);
+    Recorder recorder;
+    uint64_t overBudget = 0;
+    double qualitySum = 0.0;
+    float quality = 1.0f;
+    float targetFPS = 1000.0f / budgetMs;
+    auto top = static_cast<float>(ladder.size() - 1);
+    for (int frame = 0; frame < frames; ++frame) {
+        auto rung = static_cast<size_t>(std::lround(quality * top));
+        recorder.Record(frame, rung);
+        double frameMs = budgetMs * scenario.load(frame, gen) * SettingsCost(ladder[rung]);
+        overBudget += frameMs > budgetMs ? 1 : 0;
+        qualitySum += static_cast<double>(rung) / top;
+
+        float currentFPS = 1000.0f / static_cast<float>(frameMs);
+        if (currentFPS < targetFPS * 0.8f) {
+            quality = std::max(0.1f, quality - 0.1f);
+        } else if (currentFPS > targetFPS * 1.1f) {
+            quality = std::min(1.0f, quality + 0.05f);
+        }
+    }
+
+    SimulationResult& result = recorder.Result();
+    result.overBudgetPercent = 100.0 * static_cast<double>(overBudget) / frames;
+    result.meanQuality = qualitySum / frames;
+    result.finalRung = static_cast<size_t>(std::lround(quality * top));
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::string json_path = BenchmarkJson::TakeOption(argc, argv);
+    int frames = 3600;
+    int max_reversals = 2;              // Предел разворотов регулятора в стационарной сцене
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::max(std::atoi(argv[++i]), 300);
+        } else if (std::strcmp(argv[i], "--max-reversals") == 0 && i + 1 < argc) {
+            max_reversals = std::atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: quality_controller_benchmark [--frames N] [--max-reversals N] [--json FILE]\n");
+            return 2;
+        }
+    }
+
+    const float budgetMs = 1000.0f / 60.0f;
+    std::vector<rendering::QualitySettings> ladder = rendering::QualityController::BuildLadder(rendering::QualitySettings{});
+
+    // Приманка: без теней p90 чуть ниже порога повышения, с тенями - выше
+    // порога понижения
+    size_t shadowRung = 0;
+    while (shadowRung + 1 < ladder.size() && !ladder[shadowRung].enableShadows) {
+        shadowRung++;
+    }
+    rendering::QualityController::Config defaults;
+    double boundaryLoad = (defaults.upgradeBelow - 0.03) / (SettingsCost(ladder[shadowRung - 1]) * 1.1);
+
+    printf("=== Quality Controller Simulation (%d frames at 60 fps, %zu rungs) ===\n", frames, ladder.size());
+    printf("%-10s %-8s %8s %10s %8s %12s %10s %8s %12s\n",
+           "scenario", "mode", "changes", "reversals", "failed", "over budget%", "quality", "final", "last change");
+
+    BenchmarkJson json("quality_controller_benchmark");
+    bool failed = false;
+    for (const Scenario& scenario : MakeScenarios(frames, boundaryLoad)) {
+        for (bool legacy : {true, false}) {
+            SimulationResult r = legacy ? SimulateLegacy(scenario, ladder, budgetMs, frames)
+                                        : SimulateController(scenario, ladder, budgetMs, frames);
+            const char* mode = legacy ? "legacy" : "pid";
+            printf("%-10s %-8s %8llu %10llu %8llu %12.2f %10.2f %8zu %12d\n", scenario.name, mode,
+                   static_cast<unsigned long long>(r.changes), static_cast<unsigned long long>(r.reversals),
+                   static_cast<unsigned long long>(r.failedUpgrades), r.overBudgetPercent, r.meanQuality,
+                   r.finalRung, r.lastChangeFrame);
+
+            std::string name = std::string(scenario.name) + " " + mode;
+            json.Add("reversals " + name, static_cast<double>(r.reversals), "count", true);
+            json.Add("over budget " + name, r.overBudgetPercent, "%", true);
+            json.Add("quality " + name, r.meanQuality, "ratio", false);
+
+            if (!legacy && scenario.stationary && r.reversals > static_cast<uint64_t>(max_reversals)) {
+                failed = true;
+            }
+        }
+    }
+
+    if (failed) {
+        fprintf(stderr, "QualityController flaps: more than %d reversals in a stationary scene\n", max_reversals);
+    }
+    return json.Write(json_path) && !failed ? 0 : 1;
+}
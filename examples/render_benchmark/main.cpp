@@ -0,0 +1,399 @@
+#include "src/rendering/advanced_effects.h"
+#include "src/rendering/vector_graphics.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkSurface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WxeUI;
+
+// Безоконный бенчмарк времени кадра: сценарные сцены рисуются в растровый
+// SkSurface, N кадров прогрева и M замеряемых кадров на сцену, результат - JSON
+// с перцентилями и самими замерами для сравнения прогонов в CI.
+// Кадр зависит только от своего номера: все прогоны рисуют одно и то же
+
+struct BenchmarkOptions {
+    int width = 1280;
+    int height = 720;
+    int warmup = 20;
+    int iterations = 200;
+    std::string scene;          // Пусто - все сцены
+    std::string output;         // Пусто - stdout
+    bool samples = true;
+};
+
+struct Scene {
+    const char* name;
+    std::function<void(SkCanvas*, int)> render;     // canvas, номер кадра
+};
+
+// ============================================================================
+// Сцены
+// ============================================================================
+
+// Множество мелких прямоугольников с альфой: стоимость растеризации и смешивания
+static Scene MakeRectStorm(const BenchmarkOptions& options) {
+    struct Rect {
+        float x, y, w, h, dx, dy;
+        SkColor color;
+    };
+
+    auto rects = std::make_shared<std::vector<Rect>>();
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> pos(0.0f, 1.0f);
+    std::uniform_real_distribution<float> size(8.0f, 64.0f);
+    std::uniform_real_distribution<float> speed(-4.0f, 4.0f);
+    std::uniform_int_distribution<int> color(0, 255);
+    for (int i = 0; i < 5000; ++i) {
+        // Элементы списка инициализации вычисляются по порядку; аргументы вызова - нет
+        int r = color(gen);
+        int g = color(gen);
+        int b = color(gen);
+        rects->push_back({pos(gen) * options.width, pos(gen) * options.height, size(gen), size(gen),
+                          speed(gen), speed(gen), SkColorSetARGB(160, r, g, b)});
+    }
+
+    int width = options.width;
+    int height = options.height;
+    return {"rect_storm", [rects, width, height](SkCanvas* canvas, int frame) {
+        canvas->clear(SK_ColorBLACK);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (const Rect& rect : *rects) {
+            float x = std::fmod(rect.x + rect.dx * frame + width, static_cast<float>(width));
+            float y = std::fmod(rect.y + rect.dy * frame + height, static_cast<float>(height));
+            paint.setColor(rect.color);
+            canvas->drawRect(SkRect::MakeXYWH(x, y, rect.w, rect.h), paint);
+        }
+    }};
+}
+
+// Прокручиваемый список строк: глифы, отсечение, чередующийся фон
+static Scene MakeTextList(const BenchmarkOptions& options) {
+    auto rows = std::make_shared<std::vector<std::string>>();
+    for (int i = 0; i < 1000; ++i) {
+        rows->push_back("Item " + std::to_string(i) + " - fragment_" + std::to_string(i * 7919) +
+                        " cached 4096 bytes, last access " + std::to_string(i % 60) + " s ago");
+    }
+
+    int width = options.width;
+    int height = options.height;
+    return {"text_list", [rows, width, height](SkCanvas* canvas, int frame) {
+        canvas->clear(SK_ColorWHITE);
+
+        SkFont font;
+        font.setSize(15.0f);
+        font.setEdging(SkFont::Edging::kSubpixelAntiAlias);
+        SkPaint text;
+        text.setColor(SK_ColorBLACK);
+        SkPaint stripe;
+        stripe.setColor(SkColorSetRGB(240, 242, 245));
+
+        constexpr float kRowHeight = 22.0f;
+        float scroll = std::fmod(frame * 3.0f, static_cast<float>(rows->size()) * kRowHeight - height);
+        size_t first = static_cast<size_t>(scroll / kRowHeight);
+
+        canvas->save();
+        canvas->clipRect(SkRect::MakeWH(static_cast<float>(width), static_cast<float>(height)));
+        for (size_t i = first; i < rows->size(); ++i) {
+            float y = static_cast<float>(i) * kRowHeight - scroll;
+            if (y > height) {
+                break;
+            }
+            if (i % 2) {
+                canvas->drawRect(SkRect::MakeXYWH(0, y, static_cast<float>(width), kRowHeight), stripe);
+            }
+            const std::string& row = (*rows)[i];
+            canvas->drawSimpleText(row.data(), row.size(), SkTextEncoding::kUTF8, 12.0f, y + 16.0f, font, text);
+        }
+        canvas->restore();
+    }};
+}
+
+// Карточки с тенью и размытым фоном: saveLayer с фильтрами AdvancedEffects
+static Scene MakeEffectsStack(const BenchmarkOptions& options) {
+    auto effects = std::make_shared<rendering::AdvancedEffects>();
+
+    rendering::ShadowSettings shadowSettings;
+    shadowSettings.offsetX = 0.0f;
+    shadowSettings.offsetY = 6.0f;
+    shadowSettings.blurRadius = 12.0f;
+    sk_sp<SkImageFilter> shadow = effects->CreateDropShadow(shadowSettings);
+    sk_sp<SkImageFilter> blur = effects->CreateGaussianBlur(8.0f);
+
+    rendering::GradientSettings gradient;
+    gradient.colors = {SkColorSetRGB(30, 60, 120), SkColorSetRGB(200, 80, 140), SkColorSetRGB(250, 200, 90)};
+    sk_sp<SkShader> background = effects->CreateLinearGradient(
+        SkPoint::Make(0, 0), SkPoint::Make(static_cast<float>(options.width), static_cast<float>(options.height)), gradient);
+
+    return {"effects_stack", [effects, shadow, blur, background](SkCanvas* canvas, int frame) {
+        SkPaint backgroundPaint;
+        backgroundPaint.setShader(background);
+        canvas->drawPaint(backgroundPaint);
+
+        SkPaint card;
+        card.setAntiAlias(true);
+        card.setColor(SkColorSetARGB(230, 255, 255, 255));
+
+        for (int i = 0; i < 24; ++i) {
+            float x = 40.0f + (i % 6) * 200.0f + std::sin((frame + i * 7) * 0.05f) * 10.0f;
+            float y = 40.0f + (i / 6) * 160.0f;
+            SkRect bounds = SkRect::MakeXYWH(x, y, 170.0f, 130.0f);
+            SkRRect rrect = SkRRect::MakeRectXY(bounds, 12.0f, 12.0f);
+
+            // Размытая подложка под каждой третьей карточкой ("стекло")
+            if (i % 3 == 0) {
+                canvas->save();
+                canvas->clipRRect(rrect, true);
+                canvas->saveLayer(SkCanvas::SaveLayerRec(&bounds, nullptr, blur.get(), 0));
+                canvas->restore();
+                canvas->restore();
+            }
+
+            SkPaint layer;
+            layer.setImageFilter(shadow);
+            canvas->saveLayer(&bounds, &layer);
+            canvas->drawRRect(rrect, card);
+            canvas->restore();
+        }
+    }};
+}
+
+// Звезды и сплайны VectorGraphics: заливка, обводка, пунктир
+static Scene MakeVectorPaths(const BenchmarkOptions& options) {
+    auto graphics = std::make_shared<rendering::VectorGraphics>();
+    auto stars = std::make_shared<std::vector<SkPath>>();
+    auto splines = std::make_shared<std::vector<SkPath>>();
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(options.width));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(options.height));
+    std::uniform_real_distribution<float> radius(10.0f, 50.0f);
+    std::uniform_int_distribution<int> points(5, 12);
+
+    for (int i = 0; i < 300; ++i) {
+        SkPoint center = {x(gen), y(gen)};
+        float outer = radius(gen);
+        int count = points(gen);
+        stars->push_back(graphics->CreateStarPath(center, outer, outer * 0.45f, count));
+    }
+    for (int i = 0; i < 40; ++i) {
+        std::vector<SkPoint> control;
+        for (int j = 0; j < 12; ++j) {
+            control.push_back({x(gen), y(gen)});
+        }
+        splines->push_back(graphics->CreateSpline(control));
+    }
+
+    return {"vector_paths", [graphics, stars, splines](SkCanvas* canvas, int frame) {
+        canvas->clear(SkColorSetRGB(24, 26, 32));
+
+        rendering::VectorStyle starStyle;
+        starStyle.hasStroke = true;
+        starStyle.strokeColor = SK_ColorWHITE;
+        starStyle.strokeWidth = 1.5f;
+        starStyle.strokeJoin = SkPaint::kRound_Join;
+        for (size_t i = 0; i < stars->size(); ++i) {
+            starStyle.fillColor = SkColorSetARGB(200, static_cast<U8CPU>((i * 53) & 255), static_cast<U8CPU>((i * 97) & 255), 180);
+            canvas->save();
+            SkRect bounds = (*stars)[i].getBounds();
+            canvas->rotate(frame * 0.5f + static_cast<float>(i), bounds.centerX(), bounds.centerY());
+            graphics->DrawPath(canvas, (*stars)[i], starStyle);
+            canvas->restore();
+        }
+
+        rendering::VectorStyle splineStyle;
+        splineStyle.hasFill = false;
+        splineStyle.hasStroke = true;
+        splineStyle.strokeColor = SkColorSetARGB(220, 120, 220, 255);
+        splineStyle.strokeWidth = 3.0f;
+        splineStyle.strokeCap = SkPaint::kRound_Cap;
+        splineStyle.dashPattern = {12.0f, 6.0f};
+        splineStyle.dashOffset = static_cast<float>(frame);
+        for (const SkPath& spline : *splines) {
+            graphics->DrawPath(canvas, spline, splineStyle);
+        }
+    }};
+}
+
+// ============================================================================
+// Замер и отчет
+// ============================================================================
+
+struct SceneResult {
+    std::string name;
+    std::vector<double> samples;    // мс, в порядке кадров
+    uint64_t checksum = 0;
+};
+
+static double Percentile(const std::vector<double>& sorted, double percentile) {
+    // Ближайший ранг: значение, не меньшее percentile процентов замеров
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// FNV-1a последнего кадра: изменившийся результат рисования - не регрессия
+// скорости, а другая работа
+static uint64_t HashPixels(SkSurface* surface) {
+    SkPixmap pixmap;
+    uint64_t hash = 14695981039346656037ull;
+    if (!surface->peekPixels(&pixmap)) {
+        return 0;
+    }
+    for (int y = 0; y < pixmap.height(); ++y) {
+        const uint8_t* row = static_cast<const uint8_t*>(pixmap.addr(0, y));
+        size_t rowBytes = static_cast<size_t>(pixmap.width()) * pixmap.info().bytesPerPixel();
+        for (size_t x = 0; x < rowBytes; ++x) {
+            hash ^= row[x];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+static SceneResult RunScene(const Scene& scene, const BenchmarkOptions& options) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(options.width, options.height));
+    SkCanvas* canvas = surface->getCanvas();
+
+    SceneResult result;
+    result.name = scene.name;
+    result.samples.reserve(options.iterations);
+
+    int frame = 0;
+    for (int i = 0; i < options.warmup; ++i) {
+        scene.render(canvas, frame++);
+    }
+
+    for (int i = 0; i < options.iterations; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        scene.render(canvas, frame++);
+        auto end = std::chrono::steady_clock::now();
+        result.samples.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+
+    result.checksum = HashPixels(surface.get());
+    return result;
+}
+
+static void WriteJson(FILE* out, const BenchmarkOptions& options, const std::vector<SceneResult>& results) {
+    fprintf(out, "{\n  \"benchmark\": \"render_benchmark\",\n  \"backend\": \"raster\",\n");
+    fprintf(out, "  \"width\": %d,\n  \"height\": %d,\n  \"warmup\": %d,\n  \"iterations\": %d,\n  \"scenes\": [\n",
+            options.width, options.height, options.warmup, options.iterations);
+
+    for (size_t s = 0; s < results.size(); ++s) {
+        const SceneResult& result = results[s];
+        std::vector<double> sorted = result.samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        double mean = 0.0;
+        for (double sample : sorted) {
+            mean += sample;
+        }
+        mean /= static_cast<double>(sorted.size());
+        double variance = 0.0;
+        for (double sample : sorted) {
+            variance += (sample - mean) * (sample - mean);
+        }
+        double stddev = sorted.size() > 1 ? std::sqrt(variance / static_cast<double>(sorted.size() - 1)) : 0.0;
+
+        fprintf(out, "    {\n      \"name\": \"%s\",\n", result.name.c_str());
+        fprintf(out, "      \"mean_ms\": %.4f,\n      \"stddev_ms\": %.4f,\n      \"min_ms\": %.4f,\n",
+                mean, stddev, sorted.front());
+        fprintf(out, "      \"p50_ms\": %.4f,\n      \"p90_ms\": %.4f,\n      \"p99_ms\": %.4f,\n      \"max_ms\": %.4f,\n",
+                Percentile(sorted, 50.0), Percentile(sorted, 90.0), Percentile(sorted, 99.0), sorted.back());
+        fprintf(out, "      \"checksum\": \"%016llx\"", static_cast<unsigned long long>(result.checksum));
+
+        if (options.samples) {
+            fprintf(out, ",\n      \"samples_ms\": [");
+            for (size_t i = 0; i < result.samples.size(); ++i) {
+                fprintf(out, "%s%.4f", i ? ", " : "", result.samples[i]);
+            }
+            fprintf(out, "]");
+        }
+        fprintf(out, "\n    }%s\n", s + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void PrintUsage() {
+    fprintf(stderr,
+            "usage: render_benchmark [--scene NAME] [--warmup N] [--iterations N]\n"
+            "                        [--width W] [--height H] [--output FILE] [--no-samples]\n"
+            "scenes: rect_storm, text_list, effects_stack, vector_paths\n");
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scene" && hasValue) {
+            options.scene = argv[++i];
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::atoi(argv[++i]);
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::atoi(argv[++i]);
+        } else if (arg == "--width" && hasValue) {
+            options.width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && hasValue) {
+            options.height = std::atoi(argv[++i]);
+        } else if (arg == "--output" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "--no-samples") {
+            options.samples = false;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (options.width <= 0 || options.height <= 0 || options.iterations <= 0 || options.warmup < 0) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<Scene> scenes = {
+        MakeRectStorm(options),
+        MakeTextList(options),
+        MakeEffectsStack(options),
+        MakeVectorPaths(options),
+    };
+
+    std::vector<SceneResult> results;
+    for (const Scene& scene : scenes) {
+        if (!options.scene.empty() && options.scene != scene.name) {
+            continue;
+        }
+        fprintf(stderr, "%-14s ", scene.name);
+        results.push_back(RunScene(scene, options));
+        fprintf(stderr, "done\n");
+    }
+
+    if (results.empty()) {
+        fprintf(stderr, "unknown scene: %s\n", options.scene.c_str());
+        PrintUsage();
+        return 2;
+    }
+
+    FILE* out = options.output.empty() ? stdout : fopen(options.output.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "cannot open %s\n", options.output.c_str());
+        return 1;
+    }
+    WriteJson(out, options, results);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -1,13 +1,17 @@
 #include "cache/fragment_cache.h"
+#include "memory/memory_tags.h"
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
 #include <zlib.h>
 #include <thread>
+#include <utility>
 
 namespace WxeUI {
 namespace Cache {
 
+static const Memory::MemoryTagId kFragmentCacheTag = Memory::MemoryTags::Register("FragmentCache");
+
 // =============================================================================
 // LRUCache Implementation
 // =============================================================================
@@ -110,9 +114,18 @@ FragmentCache::FragmentCache(const Config& config)
 
 FragmentCache::~FragmentCache() {
     StopBackgroundTasks();
+
+    // Файлы L3 остаются на диске, данные записей в памяти освобождаются
+    for (const auto* cache : {&l1_cache_, &l2_cache_, &l3_cache_}) {
+        for (const auto& pair : *cache) {
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, pair.second->size);
+        }
+    }
 }
 
 bool FragmentCache::Get(const std::string& key, std::vector<uint8_t>& data) {
+    Memory::ScopedMemoryTag memory_tag(kFragmentCacheTag);
+
     // Проверяем L1 (GPU)
     if (GetFromLevel(key, data, CacheLevel::L1_GPU)) {
         stats_.hits++;
@@ -147,6 +160,8 @@ bool FragmentCache::Get(const std::string& key, std::vector<uint8_t>& data) {
 }
 
 bool FragmentCache::Put(const std::string& key, const std::vector<uint8_t>& data, CacheLevel preferred_level) {
+    Memory::ScopedMemoryTag memory_tag(kFragmentCacheTag);
+
     std::lock_guard<std::recursive_mutex> lock(main_mutex_);
     
     // Проверяем, помещается ли в предпочитаемый уровень
@@ -181,6 +196,7 @@ bool FragmentCache::Remove(const std::string& key) {
         auto it = l1_cache_.find(key);
         if (it != l1_cache_.end()) {
             stats_.total_size -= it->second->size;
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, it->second->size);
             l1_cache_.erase(it);
             l1_lru_->Remove(key);
             removed = true;
@@ -192,6 +208,7 @@ bool FragmentCache::Remove(const std::string& key) {
         auto it = l2_cache_.find(key);
         if (it != l2_cache_.end()) {
             stats_.total_size -= it->second->size;
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, it->second->size);
             l2_cache_.erase(it);
             l2_lru_->Remove(key);
             removed = true;
@@ -203,6 +220,7 @@ bool FragmentCache::Remove(const std::string& key) {
         auto it = l3_cache_.find(key);
         if (it != l3_cache_.end()) {
             stats_.total_size -= it->second->size;
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, it->second->size);
             l3_cache_.erase(it);
             l3_lru_->Remove(key);
             
@@ -224,18 +242,27 @@ void FragmentCache::Clear() {
     
     {
         std::lock_guard<std::mutex> l1_lock(l1_mutex_);
+        for (const auto& pair : l1_cache_) {
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, pair.second->size);
+        }
         l1_cache_.clear();
         l1_lru_->Clear();
     }
     
     {
         std::lock_guard<std::mutex> l2_lock(l2_mutex_);
+        for (const auto& pair : l2_cache_) {
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, pair.second->size);
+        }
         l2_cache_.clear();
         l2_lru_->Clear();
     }
     
     {
         std::lock_guard<std::mutex> l3_lock(l3_mutex_);
+        for (const auto& pair : l3_cache_) {
+            Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, pair.second->size);
+        }
         l3_cache_.clear();
         l3_lru_->Clear();
     }
@@ -253,12 +280,16 @@ void FragmentCache::Clear() {
 }
 
 void FragmentCache::Prefetch(const std::vector<std::string>& keys) {
+    Memory::ScopedMemoryTag memory_tag(kFragmentCacheTag);
+
     if (!prefetch_enabled_ || !prefetch_callback_) {
         return;
     }
     
     // Асинхронная предзагрузка
     std::thread([this, keys]() {
+        // Данные из prefetch_callback_ остаются в кэше - учитываем их на теге кэша
+        Memory::ScopedMemoryTag thread_tag(kFragmentCacheTag);
         for (const auto& key : keys) {
             std::vector<uint8_t> dummy;
             if (!Get(key, dummy)) {
@@ -446,28 +477,36 @@ bool FragmentCache::PutToLevel(const std::string& key, const std::vector<uint8_t
     
     entry->size = entry->data.size();
     
+    // Запись с тем же ключом на уровне заменяется вместе с ее данными
+    std::shared_ptr<CacheEntry> replaced;
+    
     switch (level) {
         case CacheLevel::L1_GPU: {
             std::lock_guard<std::mutex> lock(l1_mutex_);
-            l1_cache_[key] = entry;
+            replaced = std::exchange(l1_cache_[key], entry);
             l1_lru_->Access(key);
             break;
         }
         case CacheLevel::L2_RAM: {
             std::lock_guard<std::mutex> lock(l2_mutex_);
-            l2_cache_[key] = entry;
+            replaced = std::exchange(l2_cache_[key], entry);
             l2_lru_->Access(key);
             break;
         }
         case CacheLevel::L3_DISK: {
             std::lock_guard<std::mutex> lock(l3_mutex_);
-            l3_cache_[key] = entry;
+            replaced = std::exchange(l3_cache_[key], entry);
             l3_lru_->Access(key);
             
             // Сохраняем на диск
             if (!SaveToFile(key, entry->data)) {
                 l3_cache_.erase(key);
                 l3_lru_->Remove(key);
+                if (replaced) {
+                    stats_.total_size -= replaced->size;
+                    stats_.entry_count--;
+                    Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, replaced->size);
+                }
                 return false;
             }
             break;
@@ -477,7 +516,13 @@ bool FragmentCache::PutToLevel(const std::string& key, const std::vector<uint8_t
     }
     
     stats_.total_size += entry->size;
-    stats_.entry_count++;
+    Memory::MemoryTags::RecordAllocation(kFragmentCacheTag, entry->size);
+    if (replaced) {
+        stats_.total_size -= replaced->size;
+        Memory::MemoryTags::RecordDeallocation(kFragmentCacheTag, replaced->size);
+    } else {
+        stats_.entry_count++;
+    }
     
     return true;
 }
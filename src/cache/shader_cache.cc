@@ -0,0 +1,588 @@
+#include "cache/shader_cache.h"
+#include "cache/shader_file_watcher.h"
+#include "memory/memory_tags.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace WxeUI {
+namespace Cache {
+
+static const Memory::MemoryTagId kShaderCacheTag = Memory::MemoryTags::Register("ShaderCache");
+
+// =============================================================================
+// Cache Keys
+// =============================================================================
+
+std::string ShaderDefines::GetCacheKey() const {
+    // Порядок в unordered_map не определен - ключ из отсортированных пар
+    std::vector<std::pair<std::string, std::string>> sorted(defines.begin(), defines.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string key;
+    for (const auto& define : sorted) {
+        key += define.first;
+        key += '=';
+        key += define.second;
+        key += ';';
+    }
+    return key;
+}
+
+std::string ShaderDescriptor::GetCacheKey() const {
+    std::ostringstream key;
+    key << static_cast<int>(type) << '|' << static_cast<int>(language) << '|' << source_file << '|'
+        << entry_point << '|' << target_profile << '|' << defines.GetCacheKey() << '|'
+        << static_cast<int>(optimization) << '|' << (debug_info ? 1 : 0);
+    return key.str();
+}
+
+// =============================================================================
+// ShaderCache Implementation
+// =============================================================================
+
+#ifdef _WIN32
+struct ShaderCache::Win32ShaderData {};
+#endif
+
+ShaderCache::ShaderCache(const Config& config)
+    : config_(config) {
+}
+
+ShaderCache::~ShaderCache() {
+    Shutdown();
+
+    for (const auto& pair : cache_) {
+        Memory::MemoryTags::RecordDeallocation(kShaderCacheTag, pair.second->size);
+    }
+}
+
+bool ShaderCache::Initialize() {
+    if (config_.async_compilation && !compilation_active_.exchange(true)) {
+        uint32_t thread_count = std::max<uint32_t>(config_.compiler_threads, 1);
+        for (uint32_t i = 0; i < thread_count; ++i) {
+            compiler_threads_.emplace_back(&ShaderCache::CompilerWorker, this);
+        }
+    }
+
+    if (config_.enable_hot_reload) {
+        EnableHotReload(true);
+    }
+    return true;
+}
+
+void ShaderCache::Shutdown() {
+    EnableHotReload(false);
+
+    {
+        std::lock_guard<std::mutex> lock(compile_mutex_);
+        compilation_active_ = false;
+    }
+    compile_cv_.notify_all();
+
+    for (auto& thread : compiler_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    compiler_threads_.clear();
+}
+
+std::shared_ptr<ShaderBinary> ShaderCache::GetShader(const ShaderDescriptor& descriptor) {
+    return GetShader(GenerateCacheKey(descriptor));
+}
+
+std::shared_ptr<ShaderBinary> ShaderCache::GetShader(const std::string& cache_key) {
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+
+    auto it = cache_.find(cache_key);
+    if (it == cache_.end()) {
+        stats_.cache_misses++;
+        return nullptr;
+    }
+
+    stats_.cache_hits++;
+    it->second->last_access = std::chrono::steady_clock::now();
+    it->second->access_count++;
+    return it->second;
+}
+
+bool ShaderCache::CompileShader(const ShaderDescriptor& descriptor,
+                                const std::string& source_code,
+                                std::shared_ptr<ShaderBinary>& binary) {
+    Memory::ScopedMemoryTag memory_tag(kShaderCacheTag);
+
+    std::string cache_key = GenerateCacheKey(descriptor);
+    bool success = CompileShaderInternal(descriptor, source_code, binary);
+
+    // Неудачный результат тоже кэшируется (с логом): сломанный шейдер не
+    // перекомпилируется каждый кадр, а граф зависимостей перекомпилирует
+    // его при следующем сохранении исходника
+    {
+        std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+        auto it = cache_.find(cache_key);
+        if (it != cache_.end()) {
+            stats_.total_bytecode_size -= it->second->size;
+            Memory::MemoryTags::RecordDeallocation(kShaderCacheTag, it->second->size);
+        }
+        cache_[cache_key] = binary;
+        stats_.total_bytecode_size += binary->size;
+        Memory::MemoryTags::RecordAllocation(kShaderCacheTag, binary->size);
+    }
+
+    RecordDependencies(cache_key, descriptor);
+    return success;
+}
+
+bool ShaderCache::CompileShaderAsync(const ShaderDescriptor& descriptor,
+                                     const std::string& source_code,
+                                     CompileCallback callback) {
+    if (!compilation_active_) {
+        std::shared_ptr<ShaderBinary> binary;
+        bool success = CompileShader(descriptor, source_code, binary);
+        if (callback) {
+            callback(GenerateCacheKey(descriptor), success, binary->compile_log);
+        }
+        return success;
+    }
+
+    CompileTask task;
+    task.descriptor = descriptor;
+    task.source_code = source_code;
+    task.callback = std::move(callback);
+    task.submit_time = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(compile_mutex_);
+        compile_queue_.push(std::move(task));
+    }
+    compile_cv_.notify_one();
+    return true;
+}
+
+bool ShaderCache::RemoveShader(const std::string& cache_key) {
+    bool removed = EraseBinary(cache_key);
+
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+    UnlinkDependenciesLocked(cache_key);
+    if (file_watcher_) {
+        UpdateWatchedFiles();
+    }
+    return removed;
+}
+
+void ShaderCache::ClearCache() {
+    {
+        std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+        for (const auto& pair : cache_) {
+            Memory::MemoryTags::RecordDeallocation(kShaderCacheTag, pair.second->size);
+        }
+        cache_.clear();
+        stats_.total_bytecode_size = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+    dependency_records_.clear();
+    dependents_.clear();
+    if (file_watcher_) {
+        UpdateWatchedFiles();
+    }
+}
+
+void ShaderCache::CompilerWorker() {
+    while (true) {
+        CompileTask task;
+        {
+            std::unique_lock<std::mutex> lock(compile_mutex_);
+            compile_cv_.wait(lock, [this] { return !compile_queue_.empty() || !compilation_active_; });
+            if (!compilation_active_) {
+                return;
+            }
+            task = std::move(compile_queue_.front());
+            compile_queue_.pop();
+        }
+
+        std::shared_ptr<ShaderBinary> binary;
+        bool success = CompileShader(task.descriptor, task.source_code, binary);
+        if (task.callback) {
+            task.callback(GenerateCacheKey(task.descriptor), success, binary->compile_log);
+        }
+    }
+}
+
+bool ShaderCache::CompileShaderInternal(const ShaderDescriptor& descriptor,
+                                        const std::string& source_code,
+                                        std::shared_ptr<ShaderBinary>& binary) {
+    binary = std::make_shared<ShaderBinary>();
+    auto start = std::chrono::steady_clock::now();
+
+    bool success = false;
+    switch (descriptor.language) {
+        case ShaderLanguage::HLSL:
+            success = CompileHLSL(descriptor, source_code, binary->bytecode, binary->compile_log);
+            break;
+        case ShaderLanguage::GLSL:
+            success = CompileGLSL(descriptor, source_code, binary->bytecode, binary->compile_log);
+            break;
+        case ShaderLanguage::SPIRV:
+            success = CompileSPIRV(descriptor, source_code, binary->bytecode, binary->compile_log);
+            break;
+        case ShaderLanguage::MSL:
+            binary->compile_log = "MSL is not supported";
+            break;
+    }
+
+    binary->compile_time = std::chrono::steady_clock::now();
+    binary->last_access = binary->compile_time;
+    binary->compile_duration_ms = std::chrono::duration<double, std::milli>(binary->compile_time - start).count();
+    binary->compilation_successful = success;
+    binary->size = binary->bytecode.size();
+
+    uint64_t compilations = ++stats_.compilations;
+    if (!success) {
+        stats_.failed_compilations++;
+    }
+    double average = stats_.avg_compile_time_ms.load();
+    stats_.avg_compile_time_ms = average + (binary->compile_duration_ms - average) / static_cast<double>(compilations);
+    return success;
+}
+
+// Бэкенды компиляторов (DXC, glslang) еще не подключены: компиляция
+// завершается неудачей с логом, результат кэшируется как неудачный
+bool ShaderCache::CompileHLSL(const ShaderDescriptor&, const std::string&,
+                              std::vector<uint8_t>&, std::string& error_log) {
+    error_log = "HLSL compiler backend is not available in this build";
+    return false;
+}
+
+bool ShaderCache::CompileGLSL(const ShaderDescriptor&, const std::string&,
+                              std::vector<uint8_t>&, std::string& error_log) {
+    error_log = "GLSL compiler backend is not available in this build";
+    return false;
+}
+
+bool ShaderCache::CompileSPIRV(const ShaderDescriptor&, const std::string&,
+                               std::vector<uint8_t>&, std::string& error_log) {
+    error_log = "SPIR-V compiler backend is not available in this build";
+    return false;
+}
+
+std::string ShaderCache::GenerateCacheKey(const ShaderDescriptor& descriptor) const {
+    return descriptor.GetCacheKey();
+}
+
+bool ShaderCache::EraseBinary(const std::string& cache_key) {
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+
+    auto it = cache_.find(cache_key);
+    if (it == cache_.end()) {
+        return false;
+    }
+
+    stats_.total_bytecode_size -= it->second->size;
+    Memory::MemoryTags::RecordDeallocation(kShaderCacheTag, it->second->size);
+    cache_.erase(it);
+    return true;
+}
+
+// =============================================================================
+// Dependency Tracking
+// =============================================================================
+
+void ShaderCache::RecordDependencies(const std::string& cache_key, const ShaderDescriptor& descriptor) {
+    std::vector<ShaderDependency> dependencies;
+    std::set<std::string> visited;
+    ScanIncludes(NormalizePath(descriptor.source_file), dependencies, visited);
+
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+
+    UnlinkDependenciesLocked(cache_key);
+
+    for (const auto& dependency : dependencies) {
+        dependents_[dependency.path].insert(cache_key);
+    }
+
+    DependencyRecord& record = dependency_records_[cache_key];
+    record.descriptor = descriptor;
+    record.dependencies = std::move(dependencies);
+
+    if (file_watcher_) {
+        UpdateWatchedFiles();
+    }
+}
+
+std::vector<ShaderDependency> ShaderCache::GetDependencies(const std::string& cache_key) const {
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+
+    auto it = dependency_records_.find(cache_key);
+    return it != dependency_records_.end() ? it->second.dependencies : std::vector<ShaderDependency>{};
+}
+
+std::vector<std::string> ShaderCache::GetDependentShaders(const std::string& file_path) const {
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+
+    auto it = dependents_.find(NormalizePath(file_path));
+    if (it == dependents_.end()) {
+        return {};
+    }
+
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+void ShaderCache::InvalidateShader(const std::string& source_file) {
+    // Явная инвалидация: сбрасываем все пермутации, зависящие от файла, без проверки хэша
+    InvalidateDependents(source_file, false, false);
+}
+
+size_t ShaderCache::OnSourceFileChanged(const std::string& file_path) {
+    return InvalidateDependents(file_path, true, config_.recompile_on_change);
+}
+
+void ShaderCache::EnableHotReload(bool enable) {
+    std::unique_ptr<ShaderFileWatcher> stopped_watcher;
+
+    {
+        std::lock_guard<std::mutex> lock(dependency_mutex_);
+        config_.enable_hot_reload = enable;
+
+        if (enable && !file_watcher_) {
+            file_watcher_ = std::make_unique<ShaderFileWatcher>(
+                [this](const std::string& path) { OnSourceFileChanged(path); });
+            UpdateWatchedFiles();
+            file_watcher_->Start();
+        } else if (!enable) {
+            stopped_watcher = std::move(file_watcher_);
+        }
+    }
+
+    // Останавливаем вне блокировки: поток наблюдателя может ждать dependency_mutex_
+    if (stopped_watcher) {
+        stopped_watcher->Stop();
+    }
+}
+
+bool ShaderCache::IsHotReloadEnabled() const {
+    std::lock_guard<std::mutex> lock(dependency_mutex_);
+    return file_watcher_ != nullptr;
+}
+
+size_t ShaderCache::InvalidateDependents(const std::string& file_path, bool only_if_changed, bool recompile) {
+    Memory::ScopedMemoryTag memory_tag(kShaderCacheTag);
+
+    std::string path = NormalizePath(file_path);
+
+    std::string contents;
+    uint64_t current_hash = ReadFileContents(path, contents) ? HashContents(contents) : 0;
+
+    std::vector<std::string> invalidated;
+    std::vector<ShaderDescriptor> to_recompile;
+
+    {
+        std::lock_guard<std::mutex> lock(dependency_mutex_);
+
+        auto it = dependents_.find(path);
+        if (it == dependents_.end()) {
+            return 0;
+        }
+
+        for (const auto& cache_key : it->second) {
+            auto record_it = dependency_records_.find(cache_key);
+            if (record_it == dependency_records_.end()) {
+                continue;
+            }
+
+            auto& dependencies = record_it->second.dependencies;
+            auto dep_it = std::find_if(dependencies.begin(), dependencies.end(),
+                                       [&path](const ShaderDependency& d) { return d.path == path; });
+
+            // Файл сохранен без изменений (touch, повторная запись) - пермутация актуальна
+            if (only_if_changed && dep_it != dependencies.end() && dep_it->content_hash == current_hash) {
+                continue;
+            }
+
+            invalidated.push_back(cache_key);
+            to_recompile.push_back(record_it->second.descriptor);
+        }
+    }
+
+    // Записи графа остаются: перекомпиляция перезапишет их при сохранении
+    // результата, а без нее следующее сохранение файла снова найдет пермутацию
+    for (const auto& cache_key : invalidated) {
+        EraseBinary(cache_key);
+    }
+    stats_.invalidations += invalidated.size();
+
+    if (recompile) {
+        for (const auto& descriptor : to_recompile) {
+            ScheduleRecompile(descriptor);
+        }
+    }
+
+    return invalidated.size();
+}
+
+void ShaderCache::ScheduleRecompile(const ShaderDescriptor& descriptor) {
+    Memory::ScopedMemoryTag memory_tag(kShaderCacheTag);
+
+    std::string source_code;
+    if (!ReadFileContents(NormalizePath(descriptor.source_file), source_code)) {
+        return;
+    }
+
+    stats_.background_recompiles++;
+
+    // Граф обновляется новыми хэшами и списком #include при сохранении результата (CompileShader)
+    if (config_.async_compilation && compilation_active_) {
+        CompileTask task;
+        task.descriptor = descriptor;
+        task.source_code = std::move(source_code);
+        task.submit_time = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(compile_mutex_);
+            compile_queue_.push(std::move(task));
+        }
+        compile_cv_.notify_one();
+    } else {
+        std::shared_ptr<ShaderBinary> binary;
+        CompileShader(descriptor, source_code, binary);
+    }
+}
+
+void ShaderCache::UnlinkDependenciesLocked(const std::string& cache_key) {
+    auto it = dependency_records_.find(cache_key);
+    if (it == dependency_records_.end()) {
+        return;
+    }
+
+    for (const auto& dependency : it->second.dependencies) {
+        auto dep_it = dependents_.find(dependency.path);
+        if (dep_it != dependents_.end()) {
+            dep_it->second.erase(cache_key);
+            if (dep_it->second.empty()) {
+                dependents_.erase(dep_it);
+            }
+        }
+    }
+
+    dependency_records_.erase(it);
+}
+
+void ShaderCache::UpdateWatchedFiles() {
+    // Вызывается под dependency_mutex_
+    std::vector<std::string> files;
+    files.reserve(dependents_.size());
+
+    for (const auto& pair : dependents_) {
+        files.push_back(pair.first);
+    }
+
+    file_watcher_->SetWatchedFiles(files);
+}
+
+void ShaderCache::ScanIncludes(const std::string& file_path, std::vector<ShaderDependency>& dependencies,
+                               std::set<std::string>& visited) const {
+    if (!visited.insert(file_path).second) {
+        return; // Уже обработан (циклические или повторные #include)
+    }
+
+    std::string contents;
+    if (!ReadFileContents(file_path, contents)) {
+        // Отсутствующий файл тоже зависимость: его появление инвалидирует пермутацию
+        dependencies.emplace_back(file_path, 0);
+        return;
+    }
+
+    dependencies.emplace_back(file_path, HashContents(contents));
+
+    std::istringstream stream(contents);
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '#') {
+            continue;
+        }
+
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos || line.compare(pos, 7, "include") != 0) {
+            continue;
+        }
+
+        size_t open = line.find_first_of("\"<", pos + 7);
+        if (open == std::string::npos) {
+            continue;
+        }
+
+        char close_char = line[open] == '"' ? '"' : '>';
+        size_t close = line.find(close_char, open + 1);
+        if (close == std::string::npos) {
+            continue;
+        }
+
+        // Отсутствующие кандидаты поиска - тоже зависимости (с нулевым хэшем): файл,
+        // созданный позже, изменит разрешение #include и инвалидирует пермутацию
+        std::vector<std::string> missing_candidates;
+        std::string resolved = ResolveInclude(line.substr(open + 1, close - open - 1), file_path, missing_candidates);
+        for (const auto& candidate : missing_candidates) {
+            ScanIncludes(candidate, dependencies, visited);
+        }
+        if (!resolved.empty()) {
+            ScanIncludes(resolved, dependencies, visited);
+        }
+    }
+}
+
+std::string ShaderCache::ResolveInclude(const std::string& include_name, const std::string& including_file,
+                                        std::vector<std::string>& missing_candidates) const {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::path local = fs::path(including_file).parent_path() / include_name;
+    if (fs::exists(local, ec)) {
+        return NormalizePath(local.string());
+    }
+    missing_candidates.push_back(NormalizePath(local.string()));
+
+    for (const auto& directory : config_.include_directories) {
+        fs::path candidate = fs::path(directory) / include_name;
+        if (fs::exists(candidate, ec)) {
+            return NormalizePath(candidate.string());
+        }
+        missing_candidates.push_back(NormalizePath(candidate.string()));
+    }
+
+    return ""; // Системный или встроенный заголовок компилятора
+}
+
+std::string ShaderCache::NormalizePath(const std::string& path) {
+    std::error_code ec;
+    auto normalized = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path : normalized.string();
+}
+
+bool ShaderCache::ReadFileContents(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+uint64_t ShaderCache::HashContents(const std::string& contents) {
+    // FNV-1a 64
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : contents) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace Cache
+} // namespace WindowWinapi
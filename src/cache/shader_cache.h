@@ -10,6 +10,9 @@
 #include <thread>
 #include <queue>
 #include <set>
+#include <functional>
+#include <shared_mutex>
+#include <condition_variable>
 
 namespace WxeUI {
 namespace Cache {
@@ -104,6 +107,15 @@ struct ShaderBinary {
     }
 };
 
+// Зависимость скомпилированной пермутации (исходный файл или #include)
+struct ShaderDependency {
+    std::string path;               // Нормализованный путь к файлу
+    uint64_t content_hash;          // Хэш содержимого на момент компиляции
+    
+    ShaderDependency() : content_hash(0) {}
+    ShaderDependency(const std::string& p, uint64_t hash) : path(p), content_hash(hash) {}
+};
+
 struct ShaderProgram {
     std::string name;
     std::unordered_map<ShaderType, std::shared_ptr<ShaderBinary>> shaders;
@@ -136,6 +148,8 @@ struct ShaderCacheStats {
     std::atomic<uint64_t> failed_links{0};
     std::atomic<double> avg_compile_time_ms{0.0};
     std::atomic<size_t> total_bytecode_size{0};
+    std::atomic<uint64_t> invalidations{0};         // Инвалидированные пермутации
+    std::atomic<uint64_t> background_recompiles{0}; // Перекомпиляции при hot reload
     
     double GetHitRatio() const {
         auto total = cache_hits.load() + cache_misses.load();
@@ -149,9 +163,13 @@ struct ShaderCacheStats {
     }
 };
 
+class ShaderFileWatcher;
+
 class ShaderCache {
 public:
     struct Config {
+        Config() {}
+        
         size_t max_cache_size = 256 * 1024 * 1024;      // 256MB общий лимит
         size_t max_entries = 5000;                       // Макс количество шейдеров
         
@@ -174,6 +192,11 @@ public:
         std::string cache_directory = "shader_cache";
         bool compress_bytecode = true;                   // Сжимать bytecode
         
+        // Зависимости и hot reload
+        std::vector<std::string> include_directories;    // Пути поиска для #include
+        bool enable_hot_reload = false;                  // Следить за изменениями файлов
+        bool recompile_on_change = true;                 // Перекомпилировать в фоне
+        
         // Очистка
         std::chrono::seconds max_unused_time{600};       // 10 минут
         double cleanup_threshold = 0.9;                  // 90% заполнения
@@ -224,6 +247,15 @@ public:
     void ClearCache();
     void InvalidateShader(const std::string& source_file); // При изменении файла
     
+    // Граф зависимостей (#include) и hot reload
+    void RecordDependencies(const std::string& cache_key, const ShaderDescriptor& descriptor);
+    std::vector<ShaderDependency> GetDependencies(const std::string& cache_key) const;
+    std::vector<std::string> GetDependentShaders(const std::string& file_path) const;
+    size_t OnSourceFileChanged(const std::string& file_path); // Возвращает число инвалидированных пермутаций
+    
+    void EnableHotReload(bool enable);
+    bool IsHotReloadEnabled() const;
+    
     // Статистика
     ShaderCacheStats GetStats() const;
     void ResetStats();
@@ -264,6 +296,18 @@ private:
     std::mutex compile_mutex_;
     std::condition_variable compile_cv_;
     
+    // Граф зависимостей: cache_key -> файлы и file -> cache_keys
+    struct DependencyRecord {
+        ShaderDescriptor descriptor;
+        std::vector<ShaderDependency> dependencies; // Включая сам source_file
+    };
+    
+    std::unordered_map<std::string, DependencyRecord> dependency_records_;
+    std::unordered_map<std::string, std::set<std::string>> dependents_;
+    mutable std::mutex dependency_mutex_;
+    
+    std::unique_ptr<ShaderFileWatcher> file_watcher_;
+    
     // Platform-specific данные
 #ifdef _WIN32
     struct Win32ShaderData;
@@ -305,6 +349,21 @@ private:
     void UpdateAccessTime(std::shared_ptr<ShaderBinary> binary);
     void UpdateStats(bool cache_hit, double compile_time = 0.0);
     std::string GenerateCacheKey(const ShaderDescriptor& descriptor) const;
+    bool EraseBinary(const std::string& cache_key);    // Без изменения графа зависимостей
+    
+    // Зависимости
+    void ScanIncludes(const std::string& file_path, std::vector<ShaderDependency>& dependencies,
+                     std::set<std::string>& visited) const;
+    std::string ResolveInclude(const std::string& include_name, const std::string& including_file,
+                               std::vector<std::string>& missing_candidates) const;
+    void UnlinkDependenciesLocked(const std::string& cache_key);
+    size_t InvalidateDependents(const std::string& file_path, bool only_if_changed, bool recompile);
+    void ScheduleRecompile(const ShaderDescriptor& descriptor);
+    void UpdateWatchedFiles();
+    
+    static std::string NormalizePath(const std::string& path);
+    static bool ReadFileContents(const std::string& path, std::string& contents);
+    static uint64_t HashContents(const std::string& contents);
 };
 
 } // namespace Cache
@@ -0,0 +1,213 @@
+#include "cache/shader_file_watcher.h"
+#include <algorithm>
+#include <set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace WxeUI {
+namespace Cache {
+
+#ifdef __linux__
+struct ShaderFileWatcher::PlatformData {
+    int inotify_fd = -1;
+    std::unordered_map<int, std::string> wd_to_dir;
+    std::unordered_map<std::string, int> dir_to_wd;
+};
+#else
+struct ShaderFileWatcher::PlatformData {
+};
+#endif
+
+// =============================================================================
+// ShaderFileWatcher Implementation
+// =============================================================================
+
+ShaderFileWatcher::ShaderFileWatcher(ChangeCallback callback, const Config& config)
+    : config_(config), callback_(std::move(callback)) {
+    platform_data_ = std::make_unique<PlatformData>();
+}
+
+ShaderFileWatcher::~ShaderFileWatcher() {
+    Stop();
+}
+
+bool ShaderFileWatcher::Start() {
+    if (running_) {
+        return true;
+    }
+
+#ifdef __linux__
+    platform_data_->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (platform_data_->inotify_fd < 0) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        UpdatePlatformWatches();
+    }
+#endif
+
+    running_ = true;
+    watch_thread_ = std::thread(&ShaderFileWatcher::WatchThread, this);
+    return true;
+}
+
+void ShaderFileWatcher::Stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+
+    if (watch_thread_.joinable()) {
+        watch_thread_.join();
+    }
+
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (platform_data_->inotify_fd >= 0) {
+        close(platform_data_->inotify_fd);
+        platform_data_->inotify_fd = -1;
+    }
+    platform_data_->wd_to_dir.clear();
+    platform_data_->dir_to_wd.clear();
+#endif
+}
+
+void ShaderFileWatcher::SetWatchedFiles(const std::vector<std::string>& files) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    files_.clear();
+    files_.insert(files.begin(), files.end());
+
+    // Запоминаем текущее время модификации, чтобы не сработать на уже известных файлах
+    std::unordered_map<std::string, std::filesystem::file_time_type> write_times;
+    for (const auto& file : files_) {
+        std::error_code ec;
+        auto it = write_times_.find(file);
+        if (it != write_times_.end()) {
+            write_times[file] = it->second;
+        } else {
+            write_times[file] = std::filesystem::last_write_time(file, ec);
+        }
+    }
+    write_times_ = std::move(write_times);
+
+    UpdatePlatformWatches();
+}
+
+size_t ShaderFileWatcher::GetWatchedFileCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.size();
+}
+
+void ShaderFileWatcher::WatchThread() {
+    while (running_) {
+        std::vector<std::string> changed;
+
+#ifdef __linux__
+        pollfd pfd = {};
+        pfd.fd = platform_data_->inotify_fd;
+        pfd.events = POLLIN;
+
+        int ready = poll(&pfd, 1, static_cast<int>(config_.poll_interval.count()));
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            alignas(inotify_event) char buffer[4096];
+            std::set<std::string> unique_changes;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            ssize_t length;
+            while ((length = read(platform_data_->inotify_fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length; ) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+
+                    auto dir_it = platform_data_->wd_to_dir.find(event->wd);
+                    if (event->len == 0 || dir_it == platform_data_->wd_to_dir.end()) {
+                        continue;
+                    }
+
+                    std::string path = (std::filesystem::path(dir_it->second) / event->name).string();
+                    if (files_.count(path)) {
+                        unique_changes.insert(path);
+                    }
+                }
+            }
+
+            changed.assign(unique_changes.begin(), unique_changes.end());
+        }
+#else
+        std::this_thread::sleep_for(config_.poll_interval);
+        PollChanges(changed);
+#endif
+
+        // Callbacks вызываются без блокировки, чтобы они могли менять список файлов
+        for (const auto& path : changed) {
+            if (callback_) {
+                try {
+                    callback_(path);
+                } catch (...) {
+                    // Ошибка перекомпиляции не должна останавливать наблюдение
+                }
+            }
+        }
+    }
+}
+
+void ShaderFileWatcher::PollChanges(std::vector<std::string>& changed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& [path, last_time] : write_times_) {
+        std::error_code ec;
+        auto current = std::filesystem::last_write_time(path, ec);
+        if (!ec && current != last_time) {
+            last_time = current;
+            changed.push_back(path);
+        }
+    }
+}
+
+void ShaderFileWatcher::UpdatePlatformWatches() {
+#ifdef __linux__
+    if (platform_data_->inotify_fd < 0) {
+        return;
+    }
+
+    std::set<std::string> directories;
+    for (const auto& file : files_) {
+        directories.insert(std::filesystem::path(file).parent_path().string());
+    }
+
+    // Снимаем наблюдение с каталогов, в которых не осталось шейдеров
+    for (auto it = platform_data_->dir_to_wd.begin(); it != platform_data_->dir_to_wd.end(); ) {
+        if (!directories.count(it->first)) {
+            inotify_rm_watch(platform_data_->inotify_fd, it->second);
+            platform_data_->wd_to_dir.erase(it->second);
+            it = platform_data_->dir_to_wd.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& dir : directories) {
+        if (platform_data_->dir_to_wd.count(dir)) {
+            continue;
+        }
+
+        int wd = inotify_add_watch(platform_data_->inotify_fd, dir.c_str(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd >= 0) {
+            platform_data_->dir_to_wd[dir] = wd;
+            platform_data_->wd_to_dir[wd] = dir;
+        }
+    }
+#endif
+}
+
+} // namespace Cache
+} // namespace WindowWinapi
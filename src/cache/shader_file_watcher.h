@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
+
+namespace WxeUI {
+namespace Cache {
+
+// Наблюдение за исходниками шейдеров для hot reload.
+// Linux: inotify на каталогах (ловит и сохранение через rename, как делают редакторы).
+// Остальные платформы: опрос времени модификации файлов.
+class ShaderFileWatcher {
+public:
+    struct Config {
+        Config() {}
+
+        std::chrono::milliseconds poll_interval{250};   // Период опроса / таймаут poll()
+    };
+
+    using ChangeCallback = std::function<void(const std::string&)>; // Нормализованный путь
+
+public:
+    explicit ShaderFileWatcher(ChangeCallback callback, const Config& config = Config{});
+    ~ShaderFileWatcher();
+
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Полный список отслеживаемых файлов (заменяет предыдущий)
+    void SetWatchedFiles(const std::vector<std::string>& files);
+    size_t GetWatchedFileCount() const;
+
+private:
+    Config config_;
+    ChangeCallback callback_;
+
+    std::unordered_set<std::string> files_;
+    std::unordered_map<std::string, std::filesystem::file_time_type> write_times_;
+    mutable std::mutex mutex_;
+
+    std::thread watch_thread_;
+    std::atomic<bool> running_{false};
+
+    // Platform-specific данные
+    struct PlatformData;
+    std::unique_ptr<PlatformData> platform_data_;
+
+    void WatchThread();
+    void PollChanges(std::vector<std::string>& changed);
+    void UpdatePlatformWatches();
+};
+
+} // namespace Cache
+} // namespace WindowWinapi
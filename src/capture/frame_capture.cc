@@ -1,4 +1,5 @@
 #include "capture/frame_capture.h"
+#include "memory/memory_tags.h"
 #include <algorithm>
 #include <thread>
 #include <chrono>
@@ -15,6 +16,8 @@
 namespace WxeUI {
 namespace Capture {
 
+static const Memory::MemoryTagId kFrameCaptureTag = Memory::MemoryTags::Register("FrameCapture");
+
 #ifdef _WIN32
 struct FrameCapture::Win32CaptureData {
     ID3D11Device* device = nullptr;
@@ -124,6 +127,8 @@ bool FrameCapture::IsCapturing() const {
 }
 
 bool FrameCapture::CaptureFrame(std::vector<uint8_t>& frame_data, FrameInfo& info) {
+    Memory::ScopedMemoryTag memory_tag(kFrameCaptureTag);
+
     if (!initialized_) {
         return false;
     }
@@ -151,6 +156,8 @@ bool FrameCapture::CaptureFrame(std::vector<uint8_t>& frame_data, FrameInfo& inf
 }
 
 bool FrameCapture::CaptureFrame(std::vector<uint8_t>& frame_data, FrameInfo& info, const CaptureRegion& region) {
+    Memory::ScopedMemoryTag memory_tag(kFrameCaptureTag);
+
     if (!initialized_) {
         return false;
     }
@@ -173,6 +180,8 @@ bool FrameCapture::CaptureFrame(std::vector<uint8_t>& frame_data, FrameInfo& inf
 }
 
 bool FrameCapture::CaptureFrameScaled(std::vector<uint8_t>& frame_data, FrameInfo& info, const ScaleParams& scale_params) {
+    Memory::ScopedMemoryTag memory_tag(kFrameCaptureTag);
+
     std::vector<uint8_t> original_data;
     FrameInfo original_info;
     
@@ -541,6 +550,8 @@ bool FrameCapture::CaptureFrameInternalRegion(FrameBuffer& buffer, const Capture
 }
 
 void FrameCapture::WorkerThread() {
+    Memory::ScopedMemoryTag memory_tag(kFrameCaptureTag);
+
     while (workers_running_) {
         std::unique_lock<std::mutex> lock(buffer_mutex_);
         
@@ -1,46 +1,566 @@
 #include "events/event_system.h"
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 namespace WxeUI {
 namespace events {
 
+EventTypeId detail::AllocateEventTypeId() {
+    static std::atomic<EventTypeId> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+static int64_t SteadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 // EventDispatcher Implementation
 EventDispatcher::EventDispatcher() {
+    listeners_.store(new ListenerTable(), std::memory_order_release);
     StartProcessing();
 }
 
 EventDispatcher::~EventDispatcher() {
+    StopCoalescingTimer();
     StopProcessing();
+    DrainQueue();
+    
+    // Потоков обработки больше нет; DispatchImmediate во время разрушения не допускается
+    for (const RetiredListeners& retired : retiredListeners_) {
+        delete retired.table;
+    }
+    for (auto& ring : frameRings_) {
+        delete ring.load(std::memory_order_acquire);
+    }
+    delete listeners_.load(std::memory_order_acquire);
+}
+
+size_t EventDispatcher::GetPriorityBand(int priority) {
+    if (priority < 0) return 0;
+    if (priority == 0) return 1;
+    if (priority < 10) return 2;
+    return 3;
 }
 
-void EventDispatcher::Dispatch(std::unique_ptr<Event> event) {
+bool EventDispatcher::Dispatch(std::unique_ptr<Event> event) {
+    return DispatchEvent(event.release());
+}
+
+bool EventDispatcher::DispatchEvent(Event* event) {
     if (!event) {
+        return false;
+    }
+    
+    // Для событий не из пула - единственный виртуальный вызов на пути Dispatch
+    EventTypeId type = event->GetTypeId();
+    
+    if (coalescedTypeCount_.load(std::memory_order_acquire) != 0) {
+        if (const CoalescedType* coalesced = FindCoalescedType(type)) {
+            if (CoalescingSlot* slot = FindCoalescingSlot(type, event->channel_)) {
+                // Без вызовов FlushCoalesced() (нет цикла кадров) слот сбрасывает
+                // таймер автосброса - и последнее событие серии тоже
+                Coalesce(coalesced->options, *slot, event);
+                ArmCoalescingTimer();
+                return true;
+            }
+        }
+    }
+    
+    return Enqueue(event);
+}
+
+bool EventDispatcher::Enqueue(Event* raw) {
+    // Канал рендеринга минует полосы: его доставляет поток рендеринга окна, порядок - FIFO кольца
+    if (IsFrameChannel(raw->channel_)) {
+        MPMCQueue<Event*>* ring = FindFrameRing(raw->channel_);
+        if (ring && ring->TryPush(raw)) {
+            enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        Event::Destroy(raw);
+        droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    AssignTicket(raw);
+    size_t band = GetPriorityBand(raw->GetPriority());
+    
+    if (TryEnqueue(raw, band)) {
+        enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+        WakeWorker();
+        return true;
+    }
+    
+    switch (overflowPolicy_.load(std::memory_order_relaxed)) {
+        case OverflowPolicy::DROP_OLDEST_LOWEST:
+            if (EnqueueOrEvict(raw, band)) {
+                enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+                WakeWorker();
+                return true;
+            }
+            break;
+            
+        case OverflowPolicy::COALESCE: {
+            // Слот хранит новейшее событие полосы сверх лимита и учитывается в pendingEvents_;
+            // счетчик увеличивается до обмена, чтобы потребитель не опередил его
+            EventTypeId type = raw->GetTypeId();   // После обмена raw может забрать потребитель
+            pendingEvents_.fetch_add(1, std::memory_order_seq_cst);
+            Event* displaced = bands_[band].overflowSlot.exchange(raw, std::memory_order_acq_rel);
+            enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+            
+            if (displaced) {
+                pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+                
+                if (displaced->GetTypeId() == type) {
+                    Discard(displaced);
+                    coalescedEvents_.fetch_add(1, std::memory_order_relaxed);
+                } else if (!EnqueueOrEvict(displaced, band)) {
+                    Discard(displaced);
+                    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            
+            WakeWorker();
+            return true;
+        }
+        
+        case OverflowPolicy::BACKPRESSURE: {
+            backpressureWaits_.fetch_add(1, std::memory_order_relaxed);
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::microseconds(backpressureTimeoutUs_.load(std::memory_order_relaxed));
+            
+            for (int attempt = 0; std::chrono::steady_clock::now() < deadline && !shouldStop_; ++attempt) {
+                // Сначала уступаем квант, затем спим, чтобы не отнимать CPU у потребителей
+                if (attempt < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+                
+                if (TryEnqueue(raw, band)) {
+                    enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+                    WakeWorker();
+                    return true;
+                }
+            }
+            break;
+        }
+    }
+    
+    Discard(raw);
+    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+SubscriptionToken EventDispatcher::AddListener(EventTypeId type, EventListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    SubscriptionToken token = (static_cast<SubscriptionToken>(type) << kSubscriptionTypeShift) | nextSubscription_++;
+    
+    auto table = std::make_unique<ListenerTable>(*listeners_.load(std::memory_order_relaxed));
+    if (table->size() <= type) {
+        table->resize(type + 1);
+    }
+    
+    ListenerTable& updated = *table;
+    auto list = updated[type] ? std::make_shared<ListenerList>(*updated[type]) : std::make_shared<ListenerList>();
+    list->push_back({token, std::move(listener)});
+    updated[type] = std::move(list);
+    
+    PublishListeners(table.release());
+    return token;
+}
+
+bool EventDispatcher::Unsubscribe(SubscriptionToken token) {
+    if (token == kInvalidSubscription) {
+        return false;
+    }
+    
+    EventTypeId type = static_cast<EventTypeId>(token >> kSubscriptionTypeShift);
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    const ListenerTable& current = *listeners_.load(std::memory_order_relaxed);
+    if (type >= current.size() || !current[type]) {
+        return false;
+    }
+    
+    const ListenerList& list = *current[type];
+    auto it = std::find_if(list.begin(), list.end(), [token](const ListenerEntry& entry) { return entry.token == token; });
+    if (it == list.end()) {
+        return false;
+    }
+    
+    auto table = std::make_unique<ListenerTable>(current);
+    if (list.size() == 1) {
+        (*table)[type].reset();
+    } else {
+        auto remaining = std::make_shared<ListenerList>();
+        remaining->reserve(list.size() - 1);
+        for (const ListenerEntry& entry : list) {
+            if (entry.token != token) {
+                remaining->push_back(entry);
+            }
+        }
+        (*table)[type] = std::move(remaining);
+    }
+    
+    PublishListeners(table.release());
+    return true;
+}
+
+void EventDispatcher::RemoveListeners(EventTypeId type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    const ListenerTable& current = *listeners_.load(std::memory_order_relaxed);
+    if (type >= current.size() || !current[type]) {
+        return;
+    }
+    
+    auto table = std::make_unique<ListenerTable>(current);
+    (*table)[type].reset();
+    PublishListeners(table.release());
+}
+
+void EventDispatcher::PublishListeners(const ListenerTable* table) {
+    // Вызывается под mutex_. Все операции seq_cst: читатель, отметившийся в
+    // счетчике после exchange, гарантированно увидит уже новый снимок
+    const ListenerTable* previous = listeners_.exchange(table, std::memory_order_seq_cst);
+    listenersEpoch_.fetch_add(1, std::memory_order_seq_cst);
+    
+    retiredListeners_.push_back({previous, {false, false}});
+    retiredListenerCount_.store(retiredListeners_.size(), std::memory_order_relaxed);
+    ReclaimListeners();
+}
+
+void EventDispatcher::ReclaimListeners() {
+    // Вызывается под mutex_
+    for (uint32_t slot = 0; slot < 2; ++slot) {
+        if (activeReaders_[slot].count.load(std::memory_order_seq_cst) == 0) {
+            for (RetiredListeners& retired : retiredListeners_) {
+                retired.drained[slot] = true;
+            }
+        }
+    }
+    
+    auto reclaimable = [](const RetiredListeners& retired) { return retired.drained[0] && retired.drained[1]; };
+    for (const RetiredListeners& retired : retiredListeners_) {
+        if (reclaimable(retired)) {
+            delete retired.table;
+        }
+    }
+    retiredListeners_.erase(std::remove_if(retiredListeners_.begin(), retiredListeners_.end(), reclaimable),
+                            retiredListeners_.end());
+    retiredListenerCount_.store(retiredListeners_.size(), std::memory_order_relaxed);
+}
+
+const EventDispatcher::ListenerTable* EventDispatcher::AcquireListeners(uint32_t& slot) {
+    slot = listenersEpoch_.load(std::memory_order_seq_cst) & 1;
+    activeReaders_[slot].count.fetch_add(1, std::memory_order_seq_cst);
+    return listeners_.load(std::memory_order_seq_cst);
+}
+
+void EventDispatcher::ReleaseListeners(uint32_t slot) {
+    activeReaders_[slot].count.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void EventDispatcher::EnableCoalescing(EventTypeId type, const CoalescingOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    size_t count = coalescedTypeCount_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (coalescedTypes_[i].type == type) {
+            coalescedTypes_[i].options = options;
+            coalescedTypes_[i].enabled.store(true, std::memory_order_release);
+            return;
+        }
+    }
+    
+    if (count == kMaxCoalescedTypes) {
+        std::cerr << "Too many coalesced event types, type " << type << " is delivered as is" << std::endl;
         return;
     }
     
-    QueuedEvent queuedEvent;
-    queuedEvent.event = std::move(event);
-    queuedEvent.timestamp = std::chrono::steady_clock::now();
+    CoalescedType& coalesced = coalescedTypes_[count];
+    coalesced.type = type;
+    coalesced.options = options;
+    coalesced.enabled.store(true, std::memory_order_relaxed);
+    coalescedTypeCount_.store(count + 1, std::memory_order_release);
     
+    if (!coalescingTimer_) {
+        coalescingTimer_ = std::make_unique<std::thread>(&EventDispatcher::RunCoalescingTimer, this);
+    }
+}
+
+void EventDispatcher::DisableCoalescing(EventTypeId type) {
     {
-        std::lock_guard<std::mutex> lock(queueMutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         
-        // Проверка лимита очереди
-        if (eventQueue_.size() >= maxQueueSize_) {
-            // Удаление самого старого события с низким приоритетом
-            auto temp = std::priority_queue<QueuedEvent>();
-            while (!eventQueue_.empty() && temp.size() < maxQueueSize_ - 1) {
-                temp.push(eventQueue_.top());
-                eventQueue_.pop();
+        size_t count = coalescedTypeCount_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            if (coalescedTypes_[i].type == type) {
+                coalescedTypes_[i].enabled.store(false, std::memory_order_release);
+            }
+        }
+    }
+    
+    // Накопленное событие доставляется, а не теряется
+    FlushCoalesced();
+}
+
+const EventDispatcher::CoalescedType* EventDispatcher::FindCoalescedType(EventTypeId type) const {
+    size_t count = coalescedTypeCount_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        const CoalescedType& coalesced = coalescedTypes_[i];
+        if (coalesced.type == type && coalesced.enabled.load(std::memory_order_acquire)) {
+            return &coalesced;
+        }
+    }
+    return nullptr;
+}
+
+EventDispatcher::CoalescingSlot* EventDispatcher::FindCoalescingSlot(EventTypeId type, EventChannel channel) {
+    // Обычно пара уже заняла свой слот: одна загрузка ключа. Таблица полна -
+    // событие идет в очередь как есть
+    uint64_t key = CoalescingKey(type, channel);
+    size_t index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+    for (size_t probe = 0; probe < kCoalescingSlotCount; ++probe) {
+        CoalescingSlot& slot = coalescingSlots_[(index + probe) & (kCoalescingSlotCount - 1)];
+        uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+            return &slot;
+        }
+        if (current == key) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void EventDispatcher::Coalesce(const CoalescingOptions& options, CoalescingSlot& slot, Event* event) {
+    // Производитель высокочастотного ввода обычно один (поток окна); при гонке
+    // двух производителей второе событие сливается с первым в обратном порядке
+    for (;;) {
+        Event* older = slot.pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (!older) {
+            // Начало серии: срок автосброса - от него. Публикуется вместе с событием
+            slot.pendingSinceUs.store(SteadyNowUs(), std::memory_order_relaxed);
+        } else {
+            event->MergeFrom(*older);
+            event->coalescedCount_ += older->coalescedCount_ + 1;
+            coalescedEvents_.fetch_add(1, std::memory_order_relaxed);
+            
+            if (options.keep_history) {
+                auto& history = event->history_;
+                history = std::move(older->history_);
+                history.emplace_back(older);
+                if (history.size() > options.max_history) {
+                    history.erase(history.begin(), history.end() - static_cast<std::ptrdiff_t>(options.max_history));
+                }
+            } else {
+                Event::Destroy(older);
             }
-            eventQueue_ = std::move(temp);
         }
         
-        eventQueue_.push(std::move(queuedEvent));
+        // seq_cst - в паре с ArmCoalescingTimer(): таймер, снявший взвод,
+        // либо увидит событие в слоте, либо будет взведен заново
+        Event* expected = nullptr;
+        if (slot.pending.compare_exchange_strong(expected, event, std::memory_order_seq_cst)) {
+            return;
+        }
+    }
+}
+
+void EventDispatcher::ArmCoalescingTimer() {
+    if (coalescingTimerArmed_.load(std::memory_order_seq_cst) ||
+        coalescingTimerArmed_.exchange(true, std::memory_order_seq_cst)) {
+        return;
+    }
+    
+    // Взвод - раз на серию событий, блокировка здесь не на горячем пути
+    std::lock_guard<std::mutex> lock(coalescingTimerMutex_);
+    coalescingTimerCv_.notify_one();
+}
+
+void EventDispatcher::RunCoalescingTimer() {
+    std::unique_lock<std::mutex> lock(coalescingTimerMutex_);
+    while (!coalescingTimerStop_) {
+        if (!coalescingTimerArmed_.load(std::memory_order_seq_cst)) {
+            coalescingTimerCv_.wait(lock);
+            continue;
+        }
+        
+        // Взвод снимается до обхода слотов: событие, попавшее в пустой слот
+        // после него, взведет таймер снова
+        coalescingTimerArmed_.store(false, std::memory_order_seq_cst);
+        lock.unlock();
+        int64_t nextDeadlineUs = FlushExpiredCoalesced();
+        lock.lock();
+        
+        // Слоты с неистекшим сроком ждут ближайшего из них. Новая серия
+        // истекает не раньше: ее срок отсчитан от момента после обхода
+        if (nextDeadlineUs != std::numeric_limits<int64_t>::max()) {
+            coalescingTimerArmed_.store(true, std::memory_order_seq_cst);
+            coalescingTimerCv_.wait_until(lock, std::chrono::steady_clock::time_point{
+                std::chrono::microseconds(nextDeadlineUs)});
+        }
+    }
+}
+
+int64_t EventDispatcher::FlushExpiredCoalesced() {
+    int64_t now = SteadyNowUs();
+    int64_t interval = coalescingIntervalUs_.load(std::memory_order_relaxed);
+    int64_t nextDeadline = std::numeric_limits<int64_t>::max();
+    
+    for (CoalescingSlot& slot : coalescingSlots_) {
+        if (!slot.pending.load(std::memory_order_seq_cst)) {
+            continue;
+        }
+        
+        int64_t deadline = slot.pendingSinceUs.load(std::memory_order_relaxed) + interval;
+        if (deadline > now) {
+            nextDeadline = std::min(nextDeadline, deadline);
+        } else if (Event* event = slot.pending.exchange(nullptr, std::memory_order_seq_cst)) {
+            Enqueue(event);
+        }
+    }
+    return nextDeadline;
+}
+
+void EventDispatcher::StopCoalescingTimer() {
+    {
+        std::lock_guard<std::mutex> lock(coalescingTimerMutex_);
+        coalescingTimerStop_ = true;
+        coalescingTimerCv_.notify_one();
+    }
+    
+    if (coalescingTimer_ && coalescingTimer_->joinable()) {
+        coalescingTimer_->join();
+    }
+    coalescingTimer_.reset();
+}
+
+void EventDispatcher::FlushCoalesced() {
+    for (CoalescingSlot& slot : coalescingSlots_) {
+        if (Event* event = slot.pending.exchange(nullptr, std::memory_order_seq_cst)) {
+            Enqueue(event);
+        }
+    }
+}
+
+void EventDispatcher::FlushCoalesced(EventChannel channel) {
+    for (CoalescingSlot& slot : coalescingSlots_) {
+        uint64_t key = slot.key.load(std::memory_order_acquire);
+        if (key == 0 || static_cast<EventChannel>((key - 1) >> 32) != channel) {
+            continue;
+        }
+        if (Event* event = slot.pending.exchange(nullptr, std::memory_order_seq_cst)) {
+            Enqueue(event);
+        }
+    }
+}
+
+bool EventDispatcher::TryEnqueue(Event* event, size_t band) {
+    // Резервируем место до вставки: потребитель не уменьшит счетчик раньше нас
+    if (pendingEvents_.fetch_add(1, std::memory_order_seq_cst) >= maxQueueSize_.load(std::memory_order_relaxed)) {
+        pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    if (!bands_[band].ring.TryPush(event)) {
+        pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    return true;
+}
+
+bool EventDispatcher::EnqueueOrEvict(Event* event, size_t band) {
+    do {
+        if (TryEnqueue(event, band)) {
+            return true;
+        }
+    } while (EvictOldestLowest(band));
+    
+    return false;
+}
+
+bool EventDispatcher::EvictOldestLowest(size_t maxBand) {
+    // Полос мало, поэтому поиск младшей непустой - O(1)
+    for (size_t band = 0; band <= maxBand; ++band) {
+        Event* victim = nullptr;
+        if (bands_[band].ring.TryPop(victim)) {
+            pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+            droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+            Discard(victim);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EventDispatcher::TryDequeue(Event*& event) {
+    // Разблокированные головы каналов - первыми: за ними ждут запаркованные события
+    if (readyEvents_.TryPop(event)) {
+        pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    for (size_t band = kPriorityBandCount; band-- > 0; ) {
+        // Слот переполнения новее всех событий кольца - выдаем его после них
+        if (bands_[band].ring.TryPop(event) ||
+            (event = bands_[band].overflowSlot.exchange(nullptr, std::memory_order_acq_rel)) != nullptr) {
+            pendingEvents_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventDispatcher::WakeWorker() {
+    // Пара с ProcessEvents: либо поток увидит pendingEvents_ > 0, либо мы увидим спящего
+    if (sleepingWorkers_.load(std::memory_order_seq_cst) > 0) {
+        wakeSequence_.fetch_add(1, std::memory_order_release);
+        wakeSequence_.notify_one();
+    }
+}
+
+void EventDispatcher::DrainQueue() {
+    Event* event = nullptr;
+    while (TryDequeue(event)) {
+        Discard(event);
     }
     
-    queueCondition_.notify_one();
+    for (auto& ring : frameRings_) {
+        if (MPMCQueue<Event*>* frameEvents = ring.load(std::memory_order_acquire)) {
+            while (frameEvents->TryPop(event)) {
+                Event::Destroy(event);
+            }
+        }
+    }
+    
+    for (ChannelState& channel : channels_) {
+        std::lock_guard<std::mutex> lock(channel.mutex);
+        for (const auto& parked : channel.parked) {
+            Event::Destroy(parked.second);
+        }
+        channel.parked.clear();
+    }
+    
+    for (auto& slot : coalescingSlots_) {
+        Event::Destroy(slot.pending.exchange(nullptr, std::memory_order_acq_rel));
+    }
+}
+
+EventQueueStats EventDispatcher::GetQueueStats() const {
+    EventQueueStats stats;
+    stats.enqueued = enqueuedEvents_.load(std::memory_order_relaxed);
+    stats.processed = processedEvents_.load(std::memory_order_relaxed);
+    stats.dropped = droppedEvents_.load(std::memory_order_relaxed);
+    stats.coalesced = coalescedEvents_.load(std::memory_order_relaxed);
+    stats.backpressure_waits = backpressureWaits_.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void EventDispatcher::DispatchImmediate(std::unique_ptr<Event> event) {
@@ -56,12 +576,15 @@ void EventDispatcher::StartProcessing() {
         return;
     }
     
-    processing_ = true;
+    // Запуск потоков обработки
+    StartThreads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2));
+}
+
+void EventDispatcher::StartThreads(int count) {
     shouldStop_ = false;
+    processing_ = true;
     
-    // Запуск потоков обработки
-    int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
-    for (int i = 0; i < threadCount; ++i) {
+    for (int i = 0; i < count; ++i) {
         processingThreads_.emplace_back(std::make_unique<std::thread>(&EventDispatcher::ProcessEvents, this));
     }
 }
@@ -74,7 +597,8 @@ void EventDispatcher::StopProcessing() {
     shouldStop_ = true;
     processing_ = false;
     
-    queueCondition_.notify_all();
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    wakeSequence_.notify_all();
     
     for (auto& thread : processingThreads_) {
         if (thread && thread->joinable()) {
@@ -88,52 +612,230 @@ void EventDispatcher::StopProcessing() {
 void EventDispatcher::SetProcessingThreadCount(int count) {
     if (processing_) {
         StopProcessing();
-        processingThreads_.clear();
-        
-        for (int i = 0; i < count; ++i) {
-            processingThreads_.emplace_back(std::make_unique<std::thread>(&EventDispatcher::ProcessEvents, this));
-        }
-        
-        processing_ = true;
-        shouldStop_ = false;
+        StartThreads(std::max(1, count));
     }
 }
 
 void EventDispatcher::ProcessEvents() {
     while (!shouldStop_) {
-        std::unique_lock<std::mutex> lock(queueMutex_);
+        Event* raw = nullptr;
+        if (!TryDequeue(raw)) {
+            // Снятые снимки освобождаются и без новых подписок: слушатели, от которых
+            // отписались, не удерживают захваченные объекты до следующей подписки
+            if (retiredListenerCount_.load(std::memory_order_relaxed) != 0 && mutex_.try_lock()) {
+                ReclaimListeners();
+                mutex_.unlock();
+            }
+            
+            uint32_t sequence = wakeSequence_.load(std::memory_order_acquire);
+            sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+            
+            if (pendingEvents_.load(std::memory_order_seq_cst) == 0 && !shouldStop_) {
+                wakeSequence_.wait(sequence, std::memory_order_acquire);
+            }
+            
+            sleepingWorkers_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        
+        DeliverInOrder(raw);
+    }
+}
+
+EventChannel EventDispatcher::CreateChannel() {
+    static std::atomic<EventChannel> nextChannel{kFirstUserChannel};
+    return nextChannel.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventDispatcher::AssignTicket(Event* event) {
+    if (event->channel_ == kUnorderedChannel) {
+        return;
+    }
+    
+    // Ключи каналов типов и явных каналов не пересекаются
+    uint64_t key = event->channel_ == kDefaultChannel
+        ? static_cast<uint64_t>(event->GetTypeId()) << 1
+        : (static_cast<uint64_t>(event->channel_) << 1) | 1;
+    uint32_t slot = static_cast<uint32_t>(((key * 0x9E3779B97F4A7C15ull) >> 32) % kChannelSlotCount);
+    
+    event->channelSlot_ = slot;
+    event->sequence_ = channels_[slot].nextTicket.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventDispatcher::DeliverInOrder(Event* event) {
+    if (event->channel_ == kUnorderedChannel) {
+        Deliver(event);
+        return;
+    }
+    
+    ChannelState& channel = channels_[event->channelSlot_];
+    {
+        std::lock_guard<std::mutex> lock(channel.mutex);
+        if (event->sequence_ != channel.nextDelivery) {
+            // Предыдущее событие канала еще в очереди или доставляется другим потоком
+            Park(channel, event->sequence_, event);
+            return;
+        }
+    }
+    
+    // Билет текущий: доставляем событие и все запаркованные следом за ним
+    while (event) {
+        Deliver(event);
         
-        queueCondition_.wait(lock, [this] {
-            return !eventQueue_.empty() || shouldStop_;
-        });
+        std::lock_guard<std::mutex> lock(channel.mutex);
+        event = AdvanceChannel(channel);
+    }
+}
+
+void EventDispatcher::Deliver(Event* raw) {
+    Event::Ptr event(raw);
+    try {
+        DispatchToListeners(*event);
+    } catch (const std::exception& e) {
+        // Логирование ошибки
+        std::cerr << "Error processing event: " << e.what() << std::endl;
+    }
+    processedEvents_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventDispatcher::Park(ChannelState& channel, uint64_t sequence, Event* event) {
+    // Вызывается под channel.mutex
+    channel.parked.emplace_back(sequence, event);
+    std::push_heap(channel.parked.begin(), channel.parked.end(), std::greater<>());
+}
+
+Event* EventDispatcher::AdvanceChannel(ChannelState& channel) {
+    // Вызывается под channel.mutex. Куча по билету: следующий - на вершине.
+    // Запаркованных много, когда канал смешивает приоритеты: события старших
+    // полос извлекаются раньше и ждут предшественников из младших
+    for (;;) {
+        ++channel.nextDelivery;
         
-        if (shouldStop_) {
-            break;
+        if (channel.parked.empty() || channel.parked.front().first != channel.nextDelivery) {
+            return nullptr;
         }
         
-        if (!eventQueue_.empty()) {
-            QueuedEvent queuedEvent = eventQueue_.top();
-            eventQueue_.pop();
-            lock.unlock();
-            
-            try {
-                DispatchToListeners(*queuedEvent.event);
-            } catch (const std::exception& e) {
-                // Логирование ошибки
-                std::cerr << "Error processing event: " << e.what() << std::endl;
+        Event* next = channel.parked.front().second;
+        std::pop_heap(channel.parked.begin(), channel.parked.end(), std::greater<>());
+        channel.parked.pop_back();
+        
+        if (next) {
+            return next;
+        }
+        // Отмененный билет пропускается
+    }
+}
+
+void EventDispatcher::Discard(Event* event) {
+    // Отброшенное событие с билетом освобождает очередь своего канала
+    if (event->channel_ != kUnorderedChannel && !IsFrameChannel(event->channel_)) {
+        ChannelState& channel = channels_[event->channelSlot_];
+        Event* next = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            if (event->sequence_ != channel.nextDelivery) {
+                Park(channel, event->sequence_, nullptr);
+            } else {
+                next = AdvanceChannel(channel);
             }
         }
+        
+        // Следующее событие канала уже запарковано: его доставит поток обработки,
+        // а не поток производителя, вытеснивший событие
+        if (next) {
+            pendingEvents_.fetch_add(1, std::memory_order_seq_cst);
+            readyEvents_.TryPush(next);
+            WakeWorker();
+        }
     }
+    
+    Event::Destroy(event);
 }
 
-void EventDispatcher::DispatchToListeners(const Event& event) {
+EventChannel EventDispatcher::CreateFrameChannel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kMaxFrameChannels; ++i) {
+        if (frameChannelUsed_[i]) {
+            continue;
+        }
+        
+        if (!frameRings_[i].load(std::memory_order_relaxed)) {
+            frameRings_[i].store(new MPMCQueue<Event*>(kBandCapacity), std::memory_order_release);
+        }
+        frameChannelUsed_[i] = true;
+        return kFrameChannelFlag | static_cast<EventChannel>(i);
+    }
+    
+    std::cerr << "Too many frame channels, input is delivered by processing threads" << std::endl;
+    return kDefaultChannel;
+}
+
+void EventDispatcher::ReleaseFrameChannel(EventChannel channel) {
+    MPMCQueue<Event*>* ring = FindFrameRing(channel);
+    if (!ring) {
+        return;
+    }
+    
+    // Накопленные события канала не должны попасть к следующему владельцу номера
+    for (CoalescingSlot& slot : coalescingSlots_) {
+        uint64_t key = slot.key.load(std::memory_order_acquire);
+        if (key != 0 && static_cast<EventChannel>((key - 1) >> 32) == channel) {
+            Event::Destroy(slot.pending.exchange(nullptr, std::memory_order_seq_cst));
+        }
+    }
+    
+    Event* event = nullptr;
+    while (ring->TryPop(event)) {
+        Event::Destroy(event);
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
+    frameChannelUsed_[channel & ~kFrameChannelFlag] = false;
+}
+
+MPMCQueue<Event*>* EventDispatcher::FindFrameRing(EventChannel channel) const {
+    size_t index = channel & ~kFrameChannelFlag;
+    if (!IsFrameChannel(channel) || index >= kMaxFrameChannels) {
+        return nullptr;
+    }
+    return frameRings_[index].load(std::memory_order_acquire);
+}
+
+size_t EventDispatcher::DeliverFrameEvents(EventChannel channel) {
+    MPMCQueue<Event*>* frameEvents = FindFrameRing(channel);
+    if (!frameEvents) {
+        return 0;
+    }
+    
+    size_t count = frameEvents->SizeApprox();
+    size_t delivered = 0;
+    
+    Event* event = nullptr;
+    while (delivered < count && frameEvents->TryPop(event)) {
+        Deliver(event);
+        ++delivered;
+    }
+    return delivered;
+}
+
+void EventDispatcher::DispatchToListeners(const Event& event) {
+    // Слушатели вызываются без блокировок: снимок неизменяем, и слушатель
+    // может подписываться и отписываться (в т.ч. сам) прямо из обработчика
+    struct ReadGuard {
+        EventDispatcher* dispatcher;
+        uint32_t slot = 0;
+        const ListenerTable* table;
+        
+        explicit ReadGuard(EventDispatcher* owner) : dispatcher(owner), table(owner->AcquireListeners(slot)) {}
+        ~ReadGuard() { dispatcher->ReleaseListeners(slot); }
+    } guard(this);
     
-    auto it = listeners_.find(event.GetType());
-    if (it != listeners_.end()) {
-        for (const auto& listener : it->second) {
+    const ListenerTable& table = *guard.table;
+    EventTypeId type = event.GetTypeId();
+    if (type < table.size() && table[type]) {
+        for (const auto& entry : *table[type]) {
             try {
-                listener(event);
+                entry.listener(event);
                 
                 // Если событие было обработано, прекращаем дальнейшую обработку
                 if (event.IsHandled()) {
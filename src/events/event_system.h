@@ -1,20 +1,59 @@
 #pragma once
 
 #include <functional>
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <atomic>
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 #include <typeindex>
 #include <any>
+#include <new>
+#include <type_traits>
+
+#include "events/mpmc_queue.h"
 
 namespace WxeUI {
 namespace events {
 
+// Плотные целочисленные id типов событий: назначаются при первом обращении
+// к EventTypeIdOf<T>() и индексируют таблицы слушателей без хэширования
+using EventTypeId = uint32_t;
+constexpr EventTypeId kInvalidEventTypeId = ~EventTypeId(0);
+
+namespace detail {
+EventTypeId AllocateEventTypeId();
+}
+
+template<typename T>
+EventTypeId EventTypeIdOf() {
+    static const EventTypeId id = detail::AllocateEventTypeId();
+    return id;
+}
+
+// Каналы доставки: события одного канала доставляются строго в порядке
+// Dispatch, разные каналы обрабатываются параллельно
+using EventChannel = uint32_t;
+constexpr EventChannel kDefaultChannel = 0;         // Канал типа события
+constexpr EventChannel kUnorderedChannel = 1;       // Без упорядочивания - любым свободным потоком
+constexpr EventChannel kFirstUserChannel = 2;       // Далее - EventDispatcher::CreateChannel()
+constexpr EventChannel kFrameChannelFlag = 0x80000000u;  // Каналы потока рендеринга (CreateFrameChannel)
+
+class Event;
+
+// Возврат события в пул его типа (EventPool<T>)
+class EventPoolBase {
+public:
+    virtual void Release(Event* event) = 0;
+    
+protected:
+    ~EventPoolBase() = default;
+};
+
 // Базовый класс для всех событий
 class Event {
 public:
@@ -22,21 +61,148 @@ public:
     virtual std::type_index GetType() const = 0;
     virtual std::string GetName() const = 0;
     
+    // id типа кэшируется: события из Dispatch<T> получают его при создании,
+    // остальные - одним виртуальным вызовом при постановке в очередь
+    EventTypeId GetTypeId() const {
+        if (typeId_ == kInvalidEventTypeId) {
+            typeId_ = ResolveTypeId();
+        }
+        return typeId_;
+    }
+    
+    // Освобождение с учетом происхождения: пул или обычный delete
+    static void Destroy(Event* event) {
+        if (!event) {
+            return;
+        }
+        if (EventPoolBase* pool = event->pool_) {
+            pool->Release(event);
+        } else {
+            delete event;
+        }
+    }
+    
     bool IsHandled() const { return handled_; }
     void SetHandled(bool handled = true) { handled_ = handled; }
     
     int GetPriority() const { return priority_; }
     void SetPriority(int priority) { priority_ = priority; }
     
+    // Канал задается до Dispatch; приоритет не переупорядочивает события внутри канала
+    EventChannel GetChannel() const { return channel_; }
+    void SetChannel(EventChannel channel) { channel_ = channel; }
+    
+    // Слияние при коалесцировании (EventDispatcher::EnableCoalescing): вызывается
+    // у нового события с замещаемым старым того же типа. По умолчанию - latest wins,
+    // события с приращениями (сдвиг мыши, deltaTime) накапливают их здесь
+    virtual void MergeFrom(const Event& older) { (void)older; }
+    
+    // Сколько событий поглощено этим при коалесцировании
+    uint32_t GetCoalescedCount() const { return coalescedCount_; }
+    
+    struct Deleter {
+        void operator()(Event* event) const { Destroy(event); }
+    };
+    using Ptr = std::unique_ptr<Event, Deleter>;
+    
+    // Поглощенные события, старые первыми (только с CoalescingOptions::keep_history) -
+    // для росчерков и жестов, которым нужна вся траектория
+    const std::vector<Ptr>& GetHistory() const { return history_; }
+    
+protected:
+    virtual EventTypeId ResolveTypeId() const = 0;
+    
 private:
+    friend class EventDispatcher;
+    template<typename T> friend class EventPool;
+    
     bool handled_ = false;
     int priority_ = 0;
+    EventChannel channel_ = kDefaultChannel;
+    uint32_t channelSlot_ = 0;      // Назначаются в EventDispatcher::Enqueue
+    uint64_t sequence_ = 0;
+    uint32_t coalescedCount_ = 0;
+    mutable EventTypeId typeId_ = kInvalidEventTypeId;
+    EventPoolBase* pool_ = nullptr;
+    std::vector<Ptr> history_;
 };
 
 // Макрос для создания событий
 #define DEFINE_EVENT(EventClass) \
     std::type_index GetType() const override { return std::type_index(typeid(EventClass)); } \
-    std::string GetName() const override { return #EventClass; }
+    std::string GetName() const override { return #EventClass; } \
+protected: \
+    ::WxeUI::events::EventTypeId ResolveTypeId() const override { return ::WxeUI::events::EventTypeIdOf<EventClass>(); } \
+public:
+
+// Пул событий типа T: слэбы по kSlabSize объектов, свободные ячейки - в lock-free
+// очереди. В установившемся режиме Dispatch<T> не выделяет память; сверх
+// kMaxPooledEvents живых событий - обычный new (pool_ == nullptr)
+template<typename T>
+class EventPool final : public EventPoolBase {
+public:
+    static constexpr size_t kSlabSize = 64;
+    static constexpr size_t kMaxPooledEvents = 4096;
+    
+    // Пул не разрушается: события могут пережить статические объекты при выходе
+    static EventPool& Instance() {
+        static EventPool* instance = new EventPool();
+        return *instance;
+    }
+    
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        void* slot = nullptr;
+        if (!freeSlots_.TryPop(slot)) {
+            slot = Grow();
+        }
+        
+        if (!slot) {
+            T* event = new T(std::forward<Args>(args)...);
+            event->typeId_ = EventTypeIdOf<T>();
+            return event;
+        }
+        
+        T* event = new (slot) T(std::forward<Args>(args)...);
+        event->typeId_ = EventTypeIdOf<T>();
+        event->pool_ = this;
+        return event;
+    }
+    
+    void Release(Event* event) override {
+        T* typed = static_cast<T*>(event);
+        typed->~T();
+        freeSlots_.TryPush(static_cast<void*>(typed)); // Емкость очереди = числу ячеек
+    }
+    
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    
+    EventPool() = default;
+    
+    void* Grow() {
+        std::lock_guard<std::mutex> lock(slabMutex_);
+        if (slotCount_ + kSlabSize > kMaxPooledEvents) {
+            return nullptr;
+        }
+        
+        slabs_.push_back(std::make_unique<Slot[]>(kSlabSize));
+        slotCount_ += kSlabSize;
+        
+        Slot* slab = slabs_.back().get();
+        for (size_t i = 1; i < kSlabSize; ++i) {
+            freeSlots_.TryPush(static_cast<void*>(&slab[i]));
+        }
+        return &slab[0];
+    }
+    
+    MPMCQueue<void*> freeSlots_{kMaxPooledEvents};
+    std::mutex slabMutex_;
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    size_t slotCount_ = 0;
+};
 
 // Конкретные события
 class WindowResizeEvent : public Event {
@@ -61,13 +227,25 @@ class MouseMoveEvent : public Event {
 public:
     DEFINE_EVENT(MouseMoveEvent)
     
-    MouseMoveEvent(int x, int y) : x_(x), y_(y) {}
+    MouseMoveEvent(int x, int y, int deltaX = 0, int deltaY = 0)
+        : x_(x), y_(y), deltaX_(deltaX), deltaY_(deltaY) {}
     
     int GetX() const { return x_; }
     int GetY() const { return y_; }
     
+    // Сдвиг с предыдущего доставленного события (сумма по поглощенным)
+    int GetDeltaX() const { return deltaX_; }
+    int GetDeltaY() const { return deltaY_; }
+    
+    void MergeFrom(const Event& older) override {
+        const auto& previous = static_cast<const MouseMoveEvent&>(older);
+        deltaX_ += previous.deltaX_;
+        deltaY_ += previous.deltaY_;
+    }
+    
 private:
     int x_, y_;
+    int deltaX_, deltaY_;
 };
 
 class MouseButtonEvent : public Event {
@@ -134,6 +312,11 @@ public:
     
     float GetDeltaTime() const { return deltaTime_; }
     
+    // Поглощенные обновления не теряют время симуляции
+    void MergeFrom(const Event& older) override {
+        deltaTime_ += static_cast<const UpdateEvent&>(older).deltaTime_;
+    }
+    
 private:
     float deltaTime_;
 };
@@ -141,29 +324,126 @@ private:
 // Event listener
 using EventListener = std::function<void(const Event&)>;
 
+// Токен подписки для точечной отписки: старшие биты - id типа события,
+// младшие - порядковый номер подписки. 0 - недействительный токен
+using SubscriptionToken = uint64_t;
+constexpr SubscriptionToken kInvalidSubscription = 0;
+
+// Поведение Dispatch при заполненной очереди; все варианты O(1)
+enum class OverflowPolicy {
+    DROP_OLDEST_LOWEST, // Вытесняется самое старое событие младшей непустой полосы не выше новой;
+                        // если новое событие младше всех ожидающих - отбрасывается оно
+    COALESCE,           // Новое событие ждет в слоте переполнения своей полосы; следующее событие
+                        // того же типа заменяет его, другого типа - вытесняет как DROP_OLDEST_LOWEST
+    BACKPRESSURE        // Производитель ждет места до backpressure timeout, затем событие отбрасывается
+};
+
+// Коалесцирование высокочастотных событий одного типа (EnableCoalescing)
+struct CoalescingOptions {
+    CoalescingOptions() {}
+    
+    bool keep_history = false;  // Сохранять поглощенные события в Event::GetHistory()
+    size_t max_history = 64;    // Старейшие события сверх лимита отбрасываются
+};
+
+struct EventQueueStats {
+    uint64_t enqueued = 0;
+    uint64_t processed = 0;
+    uint64_t dropped = 0;
+    uint64_t coalesced = 0;             // Поглощено слотом переполнения или EnableCoalescing
+    uint64_t backpressure_waits = 0;    // Вызовы Dispatch, ждавшие места
+};
+
 // Event dispatcher
 class EventDispatcher {
 public:
     EventDispatcher();
     ~EventDispatcher();
     
-    // Подписка на события
-    template<typename T>
-    void Subscribe(EventListener listener) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        listeners_[std::type_index(typeid(T))].push_back(listener);
+    // Подписка на события. Слушатель принимает const T& (без приведения типов
+    // в коде слушателя) или const Event&. Подписка и отписка публикуют новый
+    // снимок таблицы слушателей и не ждут слушателей, выполняющихся сейчас
+    template<typename T, typename Listener>
+    SubscriptionToken Subscribe(Listener&& listener) {
+        EventListener wrapped;
+        if constexpr (std::is_invocable_v<Listener, const Event&>) {
+            wrapped = std::forward<Listener>(listener);
+        } else {
+            static_assert(std::is_invocable_v<Listener, const T&>, "listener must accept const T&");
+            wrapped = [fn = std::forward<Listener>(listener)](const Event& event) {
+                fn(static_cast<const T&>(event)); // id типа уже совпал
+            };
+        }
+        
+        return AddListener(EventTypeIdOf<T>(), std::move(wrapped));
     }
     
-    // Отписка от событий
+    // Отписка одного слушателя. Событие, уже взятое потоком обработки из старого
+    // снимка, еще может быть доставлено ему; false - токен не найден
+    bool Unsubscribe(SubscriptionToken token);
+    
+    // Отписка всех слушателей типа
     template<typename T>
     void Unsubscribe() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        listeners_[std::type_index(typeid(T))].clear();
+        RemoveListeners(EventTypeIdOf<T>());
     }
     
-    // Отправка событий
-    void Dispatch(std::unique_ptr<Event> event);
+    // Коалесцирование по типу: событие T не ставится в очередь сразу, а замещает
+    // ожидающее событие того же типа и канала (с MergeFrom) - ввод разных окон
+    // не сливается. Накопленное событие уходит в очередь в FlushCoalesced(канал) -
+    // раз за кадр окна - или по таймеру автосброса через интервал после первого
+    // события серии
+    template<typename T>
+    void EnableCoalescing(const CoalescingOptions& options = CoalescingOptions{}) {
+        EnableCoalescing(EventTypeIdOf<T>(), options);
+    }
+    
+    template<typename T>
+    void DisableCoalescing() {
+        DisableCoalescing(EventTypeIdOf<T>());
+    }
+    
+    // Все каналы (таймер, DisableCoalescing) или один канал - окно сбрасывает только свой
+    void FlushCoalesced();
+    void FlushCoalesced(EventChannel channel);
+    void SetCoalescingInterval(std::chrono::microseconds interval) { coalescingIntervalUs_ = interval.count(); }
+    
+    // Отправка событий. Dispatch не блокируется (кроме BACKPRESSURE);
+    // false - событие отброшено политикой переполнения
+    bool Dispatch(std::unique_ptr<Event> event);
+    
+    // Событие создается на месте в пуле своего типа - без выделения памяти
+    template<typename T, typename... Args>
+    bool Dispatch(Args&&... args) {
+        return DispatchEvent(EventPool<T>::Instance().Create(std::forward<Args>(args)...));
+    }
+    
+    template<typename T, typename... Args>
+    bool DispatchTo(EventChannel channel, Args&&... args) {
+        T* event = EventPool<T>::Instance().Create(std::forward<Args>(args)...);
+        event->SetChannel(channel);
+        return DispatchEvent(event);
+    }
+    
+    // Новый канал (например, на окно): ввод окна доставляется в исходном порядке
+    // и между типами событий
+    static EventChannel CreateChannel();
+    
+    // Канал окна, который доставляет поток рендеринга этого окна
+    // (DeliverFrameEvents), а не потоки обработки: у каждого канала свое кольцо.
+    // Не больше kMaxFrameChannels одновременно; kDefaultChannel - свободных нет
+    EventChannel CreateFrameChannel();
+    // После последнего DispatchTo в канал: ожидающие события отбрасываются,
+    // номер переиспользуется
+    void ReleaseFrameChannel(EventChannel channel);
+    static bool IsFrameChannel(EventChannel channel) { return (channel & kFrameChannelFlag) != 0; }
+    
+    // Доставка событий канала рендеринга в вызывающем потоке; вызывается
+    // потоком рендеринга окна в начале кадра. События, отправленные слушателями
+    // во время доставки, ждут следующего кадра. Возвращает число доставленных
+    size_t DeliverFrameEvents(EventChannel channel);
     void DispatchImmediate(std::unique_ptr<Event> event);
+    void DispatchImmediate(const Event& event) { DispatchToListeners(event); }
     
     // Управление потоками
     void StartProcessing();
@@ -171,38 +451,180 @@ public:
     bool IsProcessing() const { return processing_; }
     
     // Настройки
-    void SetMaxQueueSize(size_t maxSize) { maxQueueSize_ = maxSize; }
+    void SetMaxQueueSize(size_t maxSize) { maxQueueSize_ = std::min(std::max<size_t>(maxSize, 1), kBandCapacity); }
     void SetProcessingThreadCount(int count);
+    void SetOverflowPolicy(OverflowPolicy policy) { overflowPolicy_ = policy; }
+    OverflowPolicy GetOverflowPolicy() const { return overflowPolicy_; }
+    void SetBackpressureTimeout(std::chrono::microseconds timeout) { backpressureTimeoutUs_ = timeout.count(); }
     
     // Статистика
-    size_t GetQueueSize() const {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        return eventQueue_.size();
-    }
+    size_t GetQueueSize() const { return pendingEvents_.load(std::memory_order_relaxed); }
+    EventQueueStats GetQueueStats() const;
+    
+    // Полосы приоритета: < 0 - низкая, 0 - обычная, 1..9 - высокая, >= 10 - критическая.
+    // Старшие полосы обрабатываются первыми, внутри полосы - FIFO
+    static constexpr size_t kPriorityBandCount = 4;
+    static constexpr size_t kBandCapacity = 4096;
+    static constexpr size_t kMaxCoalescedTypes = 16;
+    static constexpr size_t kCoalescingSlotCount = 256;    // Пар (тип, канал); степень двойки
+    static constexpr size_t kChannelSlotCount = 64;
+    static constexpr size_t kMaxFrameChannels = 64;
+    static size_t GetPriorityBand(int priority);
     
 private:
-    struct QueuedEvent {
-        std::unique_ptr<Event> event;
-        std::chrono::steady_clock::time_point timestamp;
-        
-        bool operator<(const QueuedEvent& other) const {
-            return event->GetPriority() < other.event->GetPriority();
-        }
+    // Упорядочивание канала: Enqueue выдает событию билет, доставка идет строго
+    // по билетам. Поток, получивший событие не в свою очередь, паркует его и
+    // берет следующее; доставивший билет N сам доставляет запаркованный N+1.
+    // Каналы хэшируются в kChannelSlotCount слотов: совпадение слотов лишь
+    // сериализует каналы, порядок внутри канала сохраняется
+    struct ChannelState {
+        std::mutex mutex;
+        std::atomic<uint64_t> nextTicket{0};
+        uint64_t nextDelivery = 0;                          // Под mutex
+        std::vector<std::pair<uint64_t, Event*>> parked;    // Под mutex; min-куча по билету, nullptr - отмененный билет
     };
+
+    struct CoalescedType {
+        EventTypeId type = kInvalidEventTypeId;     // Записывается до публикации coalescedTypeCount_
+        CoalescingOptions options;
+        std::atomic<bool> enabled{false};
+    };
+
+    struct CoalescingSlot {
+        std::atomic<uint64_t> key{0};               // CoalescingKey(тип, канал); 0 - свободен
+        std::atomic<Event*> pending{nullptr};       // Накопленное событие до FlushCoalesced()
+        std::atomic<int64_t> pendingSinceUs{0};     // Первое событие серии - от него срок автосброса
+    };
+
+    struct PriorityBand {
+        MPMCQueue<Event*> ring{kBandCapacity};
+        std::atomic<Event*> overflowSlot{nullptr};  // COALESCE: новейшее событие сверх очереди
+    };
+    
+    struct ListenerEntry {
+        SubscriptionToken token;
+        EventListener listener;
+    };
+    
+    // Неизменяемые снимки (copy-on-write): списки по типам разделяются между
+    // версиями таблицы, подписка копирует только внешний вектор и один список
+    using ListenerList = std::vector<ListenerEntry>;
+    using ListenerTable = std::vector<std::shared_ptr<const ListenerList>>;    // Индекс - EventTypeId
     
-    std::unordered_map<std::type_index, std::vector<EventListener>> listeners_;
-    std::mutex mutex_;
+    static constexpr int kSubscriptionTypeShift = 40;
+    static constexpr size_t kCacheLineSize = 64;
     
-    std::priority_queue<QueuedEvent> eventQueue_;
-    mutable std::mutex queueMutex_;
-    std::condition_variable queueCondition_;
+    // Счетчик читателей своей четности эпохи - на отдельной кэш-линии
+    struct ReaderCounter {
+        std::atomic<uint32_t> count{0};
+        char padding[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+    };
+    
+    // Снятый с публикации снимок ждет, пока оба счетчика читателей хотя бы раз
+    // не окажутся нулевыми после снятия: тогда его не держит ни один читатель
+    struct RetiredListeners {
+        const ListenerTable* table;
+        bool drained[2];
+    };
+    
+    // Чтение без блокировок (упрощенный RCU): читатель отмечается в счетчике
+    // текущей эпохи и берет указатель - два атомарных RMW без ожидания. Писатель
+    // публикует новый снимок, сменяет эпоху (новые читатели идут в другой
+    // счетчик, старый стекает) и освобождает старые снимки без ожидания читателей
+    std::atomic<const ListenerTable*> listeners_{nullptr};
+    std::atomic<uint32_t> listenersEpoch_{0};
+    ReaderCounter activeReaders_[2];
+    std::vector<RetiredListeners> retiredListeners_;    // Под mutex_
+    std::atomic<size_t> retiredListenerCount_{0};
+    uint64_t nextSubscription_ = 1;                     // Под mutex_
+    std::mutex mutex_;                                  // Сериализует писателей: подписки, коалесцирование
+    
+    // Очередь без блокировок: кольцо MPMC на полосу приоритета. pendingEvents_
+    // резервируется до вставки, поэтому лимит maxQueueSize_ соблюдается точно
+    // (слоты COALESCE добавляют не больше kPriorityBandCount событий)
+    PriorityBand bands_[kPriorityBandCount];
+    std::atomic<size_t> pendingEvents_{0};
+    
+    // Ожидание потоков обработки: производитель будит их, только если кто-то спит
+    std::atomic<uint32_t> sleepingWorkers_{0};
+    std::atomic<uint32_t> wakeSequence_{0};
     
     std::vector<std::unique_ptr<std::thread>> processingThreads_;
     std::atomic<bool> processing_{false};
     std::atomic<bool> shouldStop_{false};
     
-    size_t maxQueueSize_ = 1000;
-    
+    std::atomic<size_t> maxQueueSize_{1000};
+    std::atomic<OverflowPolicy> overflowPolicy_{OverflowPolicy::DROP_OLDEST_LOWEST};
+    std::atomic<int64_t> backpressureTimeoutUs_{5000};
+    
+    std::atomic<uint64_t> enqueuedEvents_{0};
+    std::atomic<uint64_t> processedEvents_{0};
+    std::atomic<uint64_t> droppedEvents_{0};
+    std::atomic<uint64_t> coalescedEvents_{0};
+    std::atomic<uint64_t> backpressureWaits_{0};
+    
+    // Каналы. readyEvents_ - головы каналов, разблокированные отменой билета
+    // вне потока обработки (вытеснение при переполнении): их доставляют потоки
+    // обработки. В каждом слоте в любой момент не больше одной такой головы
+    ChannelState channels_[kChannelSlotCount];
+    MPMCQueue<Event*> readyEvents_{kChannelSlotCount};
+    
+    // Кольца каналов рендеринга - по номеру канала без kFrameChannelFlag. Кольцо
+    // создается с первым каналом своего номера и живет до разрушения диспетчера
+    std::atomic<MPMCQueue<Event*>*> frameRings_[kMaxFrameChannels] = {};
+    bool frameChannelUsed_[kMaxFrameChannels] = {};     // Под mutex_
+    
+    // Коалесцирование: типы и слоты не удаляются. Поиск типа - линейный по
+    // немногим типам, слота - открытая адресация по паре (тип, канал); занятый
+    // слот остается за своей парой
+    CoalescedType coalescedTypes_[kMaxCoalescedTypes];
+    std::atomic<size_t> coalescedTypeCount_{0};
+    CoalescingSlot coalescingSlots_[kCoalescingSlotCount];
+    std::atomic<int64_t> coalescingIntervalUs_{16667};     // Автосброс без кадров (~60Hz)
+    
+    // Таймер автосброса: поток заводится с первым коалесцируемым типом и спит,
+    // пока слоты пусты; событие, занявшее пустой слот, взводит его. Сроки - у
+    // слотов: сброс кадра одного окна не откладывает автосброс другого
+    std::unique_ptr<std::thread> coalescingTimer_;
+    std::mutex coalescingTimerMutex_;
+    std::condition_variable coalescingTimerCv_;
+    bool coalescingTimerStop_ = false;                      // Под coalescingTimerMutex_
+    std::atomic<bool> coalescingTimerArmed_{false};
+    
+    void EnableCoalescing(EventTypeId type, const CoalescingOptions& options);
+    void DisableCoalescing(EventTypeId type);
+    const CoalescedType* FindCoalescedType(EventTypeId type) const;
+    CoalescingSlot* FindCoalescingSlot(EventTypeId type, EventChannel channel);
+    static uint64_t CoalescingKey(EventTypeId type, EventChannel channel) {
+        return ((static_cast<uint64_t>(channel) << 32) | type) + 1;     // Тип kInvalidEventTypeId не коалесцируется
+    }
+    void Coalesce(const CoalescingOptions& options, CoalescingSlot& slot, Event* event);
+    int64_t FlushExpiredCoalesced();
+    void ArmCoalescingTimer();
+    void RunCoalescingTimer();
+    void StopCoalescingTimer();
+    bool DispatchEvent(Event* event);
+    bool Enqueue(Event* event);
+    bool TryEnqueue(Event* event, size_t band);
+    bool EnqueueOrEvict(Event* event, size_t band);
+    bool EvictOldestLowest(size_t maxBand);
+    bool TryDequeue(Event*& event);
+    void AssignTicket(Event* event);
+    void DeliverInOrder(Event* event);
+    void Deliver(Event* event);
+    void Park(ChannelState& channel, uint64_t sequence, Event* event);
+    Event* AdvanceChannel(ChannelState& channel);
+    void Discard(Event* event);
+    MPMCQueue<Event*>* FindFrameRing(EventChannel channel) const;
+    void WakeWorker();
+    void DrainQueue();
+    void StartThreads(int count);
+    SubscriptionToken AddListener(EventTypeId type, EventListener listener);
+    void RemoveListeners(EventTypeId type);
+    void PublishListeners(const ListenerTable* table);
+    void ReclaimListeners();
+    const ListenerTable* AcquireListeners(uint32_t& slot);
+    void ReleaseListeners(uint32_t slot);
     void ProcessEvents();
     void DispatchToListeners(const Event& event);
 };
@@ -215,9 +637,13 @@ public:
         return dispatcher;
     }
     
-    template<typename T>
-    static void Subscribe(EventListener listener) {
-        GetDispatcher().Subscribe<T>(listener);
+    template<typename T, typename Listener>
+    static SubscriptionToken Subscribe(Listener&& listener) {
+        return GetDispatcher().Subscribe<T>(std::forward<Listener>(listener));
+    }
+    
+    static bool Unsubscribe(SubscriptionToken token) {
+        return GetDispatcher().Unsubscribe(token);
     }
     
     template<typename T>
@@ -225,13 +651,32 @@ public:
         GetDispatcher().Unsubscribe<T>();
     }
     
-    static void Dispatch(std::unique_ptr<Event> event) {
-        GetDispatcher().Dispatch(std::move(event));
+    template<typename T>
+    static void EnableCoalescing(const CoalescingOptions& options = CoalescingOptions{}) {
+        GetDispatcher().EnableCoalescing<T>(options);
+    }
+    
+    static bool Dispatch(std::unique_ptr<Event> event) {
+        return GetDispatcher().Dispatch(std::move(event));
+    }
+    
+    template<typename T, typename... Args>
+    static bool Dispatch(Args&&... args) {
+        return GetDispatcher().Dispatch<T>(std::forward<Args>(args)...);
+    }
+    
+    template<typename T, typename... Args>
+    static bool DispatchTo(EventChannel channel, Args&&... args) {
+        return GetDispatcher().DispatchTo<T>(channel, std::forward<Args>(args)...);
     }
     
     static void DispatchImmediate(std::unique_ptr<Event> event) {
         GetDispatcher().DispatchImmediate(std::move(event));
     }
+    
+    static void DispatchImmediate(const Event& event) {
+        GetDispatcher().DispatchImmediate(event);
+    }
 };
 
 } // namespace events
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace WxeUI {
+namespace events {
+
+// Ограниченная lock-free очередь MPMC (схема Вьюкова): у каждой ячейки счетчик
+// sequence, производители и потребители занимают позиции одним CAS и не ждут
+// друг друга, пока очередь не пуста и не полна. Емкость - степень двойки.
+template<typename T>
+class MPMCQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "MPMCQueue stores values by copy");
+
+public:
+    explicit MPMCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // false - очередь полна
+    bool TryPush(T value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Ячейку еще не освободил потребитель предыдущего круга
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // false - очередь пуста
+    bool TryPop(T& value) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+    // Приблизительно: позиции читаются не атомарно друг относительно друга
+    size_t SizeApprox() const {
+        size_t enqueued = enqueuePos_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeuePos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    // Позиции производителей и потребителей на разных кэш-линиях
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    char padding0_[kCacheLineSize];
+    std::atomic<size_t> enqueuePos_{0};
+    char padding1_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeuePos_{0};
+    char padding2_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+} // namespace events
+} // namespace WxeUI
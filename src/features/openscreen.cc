@@ -4,6 +4,8 @@
 #include "rendering/quality_manager.h"
 #include "rendering/performance_monitor.h"
 #include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <thread>
 
 namespace WxeUI {
@@ -283,91 +285,122 @@ void FrameHigh::EnableAdaptiveRendering(bool enable) {
 
 void FrameHigh::SetQualityThresholds(float minFPS, float targetFPS) {
     // Настройка порогов качества для адаптивного рендеринга
-    rendering::QualityManager::SetPerformanceThresholds(minFPS, targetFPS);
+    if (window_) {
+        window_->GetQualityManager().SetPerformanceThresholds(minFPS, targetFPS);
+    }
 }
 
 void FrameHigh::RenderLoop() {
-    const auto targetFrameTime = std::chrono::nanoseconds(1000000000 / config_.targetFPS);
-    lastFrameTime_ = std::chrono::steady_clock::now();
+    // Кадры - по сетке абсолютных сроков; при justInTimeRendering кадр
+    // начинается за прогноз стоимости до срока. Ввод окна на время цикла идет
+    // через канал рендеринга и доставляется синхронно в начале Render(), перед
+    // layout, - к показу он старше лишь на время отрисовки. С VSync срок задает
+    // Present, ожидание не нужно
+    rendering::FrameScheduler::Config schedulerConfig = scheduler_.GetConfig();
+    schedulerConfig.targetFPS = static_cast<float>(config_.targetFPS);
+    schedulerConfig.justInTime = config_.justInTimeRendering;
+    schedulerConfig.externalPacing = config_.enableVSync;
+    scheduler_.SetConfig(schedulerConfig);
+    SeedFrameScheduler();
+    scheduler_.Reset();
+    scheduler_.ResetStats();
+    
+    if (window_ && config_.adaptiveRefreshRate) {
+        window_->GetQualityManager().SetTargetFrameRate(static_cast<float>(config_.targetFPS));
+    }
+    
+    // Ввод, отправленный до переключения, еще доставят потоки обработки
+    if (window_) {
+        window_->SetRenderThreadInput(true);
+    }
     
     while (!shouldStop_) {
-        auto frameStart = std::chrono::steady_clock::now();
+        rendering::FrameScheduler::FrameTiming timing = scheduler_.BeginFrame();
         
-        // Рендеринг кадра
+        // Рендеринг кадра; сбор ввода - в начале Render()
         if (window_ && window_->IsValid()) {
             window_->Render();
+            timing.inputLatch = std::max(timing.start, window_->GetInputLatchTime());
         }
         
-        auto frameEnd = std::chrono::steady_clock::now();
-        auto frameTime = frameEnd - frameStart;
+        auto frameTime = std::chrono::steady_clock::now() - timing.start;
+        scheduler_.EndFrame(timing, frameTime);
         
         UpdateMetrics(std::chrono::duration<float, std::milli>(frameTime).count());
         
         // Адаптация качества если включена
         if (config_.adaptiveRefreshRate) {
-            AdjustQuality();
-        }
-        
-        // Ожидание до следующего кадра
-        if (frameTime < targetFrameTime) {
-            std::this_thread::sleep_for(targetFrameTime - frameTime);
+            AdjustQuality(std::chrono::duration<float, std::milli>(frameTime).count());
         }
         
         if (OnPerformanceUpdate) {
             OnPerformanceUpdate(metrics_);
         }
     }
+    
+    if (window_) {
+        window_->SetRenderThreadInput(false);
+    }
+}
+
+void FrameHigh::SeedFrameScheduler() {
+    // Прогноз с первого кадра - по истории PerformanceMonitor, если окно уже рисовалось
+    if (!window_) {
+        return;
+    }
+    for (const rendering::FrameMetrics& frame : window_->GetPerformanceMonitor().GetFrameHistory()) {
+        scheduler_.SeedCost(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float, std::milli>(frame.frameTime)));
+    }
 }
 
 void FrameHigh::UpdateMetrics(float frameTime) {
     metrics_.frameTime = frameTime;
     metrics_.currentFPS = 1000.0f / frameTime;
+    frameTimeHistogram_.RecordMilliseconds(frameTime);
     
-    frameTimeHistory_.push_back(frameTime);
-    if (frameTimeHistory_.size() > 60) {
-        frameTimeHistory_.erase(frameTimeHistory_.begin());
-    }
+    frameTimeHistory_[frameTimeNext_] = frameTime;
+    frameTimeNext_ = (frameTimeNext_ + 1) % kFrameTimeWindow;
+    frameTimeCount_ = std::min(frameTimeCount_ + 1, kFrameTimeWindow);
     
     // Вычисление среднего FPS
-    if (!frameTimeHistory_.empty()) {
-        float avgFrameTime = std::accumulate(frameTimeHistory_.begin(), frameTimeHistory_.end(), 0.0f) / frameTimeHistory_.size();
-        metrics_.averageFPS = 1000.0f / avgFrameTime;
-    }
+    float mean = std::accumulate(frameTimeHistory_.begin(), frameTimeHistory_.begin() + frameTimeCount_, 0.0f) / frameTimeCount_;
+    metrics_.averageFPS = 1000.0f / mean;
     
     // Вычисление jitter
-    if (frameTimeHistory_.size() > 1) {
+    if (frameTimeCount_ > 1) {
         float variance = 0.0f;
-        float mean = std::accumulate(frameTimeHistory_.begin(), frameTimeHistory_.end(), 0.0f) / frameTimeHistory_.size();
-        
-        for (float time : frameTimeHistory_) {
-            variance += (time - mean) * (time - mean);
+        for (size_t i = 0; i < frameTimeCount_; ++i) {
+            variance += (frameTimeHistory_[i] - mean) * (frameTimeHistory_[i] - mean);
         }
-        variance /= frameTimeHistory_.size();
+        variance /= frameTimeCount_;
         metrics_.jitter = std::sqrt(variance);
     }
+    
+    // Перцентили - раз в окно: запрос проходит все корзины гистограммы
+    if (frameTimeNext_ == 0) {
+        metrics_.p50FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(50.0) / 1e6);
+        metrics_.p99FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(99.0) / 1e6);
+        
+        rendering::FrameScheduler::Stats scheduling = scheduler_.GetStats();
+        metrics_.droppedFrames = static_cast<int>(scheduling.droppedFrames);
+        metrics_.pacingErrorP50 = static_cast<float>(scheduling.wakeErrorP50Us);
+        metrics_.pacingErrorP99 = static_cast<float>(scheduling.wakeErrorP99Us);
+        metrics_.inputAgeP50 = static_cast<float>(scheduling.inputAgeP50Ms);
+        metrics_.inputAgeP99 = static_cast<float>(scheduling.inputAgeP99Ms);
+    }
 }
 
-void FrameHigh::AdjustQuality() {
-    static float lastQualityAdjustment = 0.0f;
+void FrameHigh::AdjustQuality(float frameTime) {
+    // Регулятор - у QualityManager окна: у каждого окна свое состояние,
+    // решения - по сглаженному p90, а не по мгновенному FPS
+    if (!window_) {
+        return;
+    }
     
-    if (metrics_.currentFPS < config_.targetFPS * 0.8f) {
-        // Снижение качества
-        float newQuality = std::max(0.1f, lastQualityAdjustment - 0.1f);
-        rendering::QualityManager::SetGlobalQualityLevel(newQuality);
-        lastQualityAdjustment = newQuality;
-        
-        if (OnQualityAdjustment) {
-            OnQualityAdjustment(newQuality);
-        }
-    } else if (metrics_.currentFPS > config_.targetFPS * 1.1f) {
-        // Повышение качества
-        float newQuality = std::min(1.0f, lastQualityAdjustment + 0.05f);
-        rendering::QualityManager::SetGlobalQualityLevel(newQuality);
-        lastQualityAdjustment = newQuality;
-        
-        if (OnQualityAdjustment) {
-            OnQualityAdjustment(newQuality);
-        }
+    rendering::QualityManager& qualityManager = window_->GetQualityManager();
+    if (qualityManager.AddFrameTime(frameTime) && OnQualityAdjustment) {
+        OnQualityAdjustment(qualityManager.GetQualityController().GetQuality());
     }
 }
 
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <windows.h>
+#include <array>
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <functional>
 #include "window_winapi.h"
+#include "profiling/latency_histogram.h"
+#include "rendering/frame_scheduler.h"
 
 namespace WxeUI {
 namespace features {
@@ -85,6 +88,7 @@ public:
         bool enableGSync = true;
         bool adaptiveRefreshRate = true;
         bool enableTearing = false;
+        bool justInTimeRendering = true;    // Старт кадра по прогнозу стоимости, а не сразу после предыдущего; без VSync
     };
     
     struct PerformanceMetrics {
@@ -93,8 +97,14 @@ public:
         float frameTime = 0.0f;
         float cpuTime = 0.0f;
         float gpuTime = 0.0f;
-        int droppedFrames = 0;
+        int droppedFrames = 0;          // Кадры, закончившиеся после своего срока
         float jitter = 0.0f;
+        float pacingErrorP50 = 0.0f;    // Опоздание начала кадра относительно плана, мкс
+        float pacingErrorP99 = 0.0f;
+        float inputAgeP50 = 0.0f;       // Возраст ввода к сроку показа, мс
+        float inputAgeP99 = 0.0f;
+        float p50FrameTime = 0.0f;      // С запуска рендеринга, обновляются раз в окно jitter
+        float p99FrameTime = 0.0f;
     };
     
     FrameHigh(Window* window);
@@ -115,6 +125,8 @@ public:
     
     // Получение метрик
     PerformanceMetrics GetPerformanceMetrics() const { return metrics_; }
+    const Profiling::LatencyHistogram& GetFrameTimeHistogram() const { return frameTimeHistogram_; }
+    rendering::FrameScheduler::Stats GetSchedulerStats() const { return scheduler_.GetStats(); }
     
     // События
     std::function<void(const PerformanceMetrics&)> OnPerformanceUpdate;
@@ -129,12 +141,19 @@ private:
     std::unique_ptr<std::thread> renderThread_;
     std::atomic<bool> shouldStop_{false};
     
-    std::vector<float> frameTimeHistory_;
-    std::chrono::steady_clock::time_point lastFrameTime_;
+    // Окно для среднего FPS и jitter - кольцо без сдвига элементов
+    static constexpr size_t kFrameTimeWindow = 60;
+    std::array<float, kFrameTimeWindow> frameTimeHistory_{};
+    size_t frameTimeCount_ = 0;
+    size_t frameTimeNext_ = 0;
+    Profiling::LatencyHistogram frameTimeHistogram_;
+    rendering::SystemSchedulerClock schedulerClock_;
+    rendering::FrameScheduler scheduler_{schedulerClock_};
     
     void RenderLoop();
+    void SeedFrameScheduler();
     void UpdateMetrics(float frameTime);
-    void AdjustQuality();
+    void AdjustQuality(float frameTime);
     void DetectDisplayCapabilities();
 };
 
@@ -0,0 +1,165 @@
+#include "memory/frame_arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace WxeUI {
+namespace Memory {
+
+// =============================================================================
+// FrameArena Implementation
+// =============================================================================
+
+FrameArena::FrameArena(const Config& config)
+    : config_(config), resource_(*this) {
+    config_.block_size = std::max<size_t>(config_.block_size, 4096);
+    buffers_.resize(std::clamp<size_t>(config_.buffer_count, 1, 3));
+
+    // Первый блок каждого буфера выделяется заранее, чтобы первый кадр не шел по медленному пути
+    for (auto& buffer : buffers_) {
+        buffer.blocks.push_back({static_cast<char*>(malloc(config_.block_size)), config_.block_size});
+        if (!buffer.blocks.back().memory) {
+            buffer.blocks.clear();
+        }
+    }
+}
+
+FrameArena::~FrameArena() {
+    for (auto& buffer : buffers_) {
+        ReleaseBlocks(buffer, 0);
+    }
+}
+
+void FrameArena::BeginFrame() {
+    // Итоги завершенного кадра
+    const FrameStats& finished = buffers_[current_buffer_].stats;
+    last_frame_ = finished;
+    peak_frame_bytes_ = std::max(peak_frame_bytes_, finished.high_water_bytes);
+
+    frame_index_++;
+    current_buffer_ = (current_buffer_ + 1) % buffers_.size();
+    ResetBuffer(buffers_[current_buffer_]);
+}
+
+void FrameArena::ResetBuffer(Buffer& buffer) {
+    if (buffer.trim) {
+        // Данные кадра буфера больше не живы - сжатие, отложенное Trim()
+        ReleaseBlocks(buffer, 0);
+        if (char* memory = static_cast<char*>(malloc(config_.block_size))) {
+            buffer.blocks.push_back({memory, config_.block_size});
+        }
+        buffer.trim = false;
+    } else if (buffer.blocks.size() > 1) {
+        // Буфер рос блоками - заменяем их одним блоком суммарного размера,
+        // чтобы в установившемся режиме кадр укладывался в один блок
+        size_t total = 0;
+        for (const auto& block : buffer.blocks) {
+            total += block.size;
+        }
+
+        ReleaseBlocks(buffer, 0);
+        if (char* memory = static_cast<char*>(malloc(total))) {
+            buffer.blocks.push_back({memory, total});
+        }
+    }
+
+    buffer.current_block = 0;
+    buffer.offset = 0;
+    buffer.stats = FrameStats{};
+    buffer.stats.frame_index = frame_index_;
+    buffer.stats.block_count = buffer.blocks.empty() ? 0 : 1;
+}
+
+void* FrameArena::AllocateSlow(size_t size, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return nullptr; // Поддерживаются только степени двойки
+    }
+
+    Buffer& buffer = buffers_[current_buffer_];
+    size_t required = size + alignment - 1;
+
+    // Следующий блок, оставшийся от прошлых кадров, если запрос в него помещается
+    size_t next = buffer.current_block + 1;
+    if (buffer.current_block >= buffer.blocks.size() || next >= buffer.blocks.size() ||
+        buffer.blocks[next].size < required) {
+        size_t block_size = std::max(config_.block_size, required);
+        char* memory = static_cast<char*>(malloc(block_size));
+        if (!memory) {
+            return nullptr;
+        }
+
+        if (required > config_.block_size) {
+            buffer.stats.oversized_allocations++;
+        }
+
+        next = std::min(next, buffer.blocks.size());
+        buffer.blocks.insert(buffer.blocks.begin() + next, {memory, block_size});
+    }
+
+    // Хвост предыдущего блока не используется - учитываем его как потерю кадра
+    if (buffer.current_block < buffer.blocks.size() && next != buffer.current_block) {
+        buffer.stats.high_water_bytes += buffer.blocks[buffer.current_block].size - buffer.offset;
+    }
+
+    buffer.current_block = next;
+    buffer.offset = 0;
+    buffer.stats.block_count++;
+
+    return Allocate(size, alignment);
+}
+
+size_t FrameArena::Trim() {
+    size_t released = 0;
+
+    // Кадр каждого буфера живет до его сброса (buffer_count кадров): блоки до
+    // current_block включительно могут быть заняты, следующие - нет
+    for (Buffer& buffer : buffers_) {
+        size_t keep = std::min(buffer.current_block + 1, buffer.blocks.size());
+        for (size_t i = keep; i < buffer.blocks.size(); ++i) {
+            released += buffer.blocks[i].size;
+        }
+        ReleaseBlocks(buffer, keep);
+
+        buffer.trim = buffer.blocks.size() > 1 ||
+                      (buffer.blocks.size() == 1 && buffer.blocks[0].size > config_.block_size);
+    }
+
+    return released;
+}
+
+void FrameArena::ReleaseBlocks(Buffer& buffer, size_t keep) {
+    while (buffer.blocks.size() > keep) {
+        free(buffer.blocks.back().memory);
+        buffer.blocks.pop_back();
+    }
+    buffer.current_block = std::min(buffer.current_block, buffer.blocks.size());
+}
+
+FrameArena::Stats FrameArena::GetStats() const {
+    Stats stats;
+    stats.last_frame = last_frame_;
+    stats.peak_frame_bytes = peak_frame_bytes_;
+    stats.frames = frame_index_;
+
+    for (const auto& buffer : buffers_) {
+        for (const auto& block : buffer.blocks) {
+            stats.reserved_bytes += block.size;
+        }
+    }
+
+    return stats;
+}
+
+// =============================================================================
+// FrameArena::Resource
+// =============================================================================
+
+void* FrameArena::Resource::do_allocate(size_t bytes, size_t alignment) {
+    void* ptr = arena_.Allocate(bytes, alignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace Memory
+} // namespace WxeUI
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace WxeUI {
+namespace Memory {
+
+// Линейная (bump) арена для временных данных кадра: раскладки текста, списки
+// команд, временные буферы SkiaCanvas. Освобождения по одному нет - буфер кадра
+// сбрасывается целиком в BeginFrame() за O(1).
+//
+// Буферов buffer_count (2 или 3): данные кадра N живут до BeginFrame() кадра
+// N + buffer_count, поэтому их можно передать следующему кадру (или GPU).
+// Арена не потокобезопасна - принадлежит потоку рендера окна.
+class FrameArena {
+public:
+    struct Config {
+        Config() {}
+
+        size_t block_size = 256 * 1024;   // Размер блока буфера; крупные запросы получают отдельный блок
+        size_t buffer_count = 2;          // 2 - двойная, 3 - тройная буферизация
+    };
+
+    struct FrameStats {
+        uint64_t frame_index = 0;
+        size_t high_water_bytes = 0;      // Байты кадра с учетом выравнивания
+        size_t allocation_count = 0;
+        size_t block_count = 0;           // Блоков задействовано за кадр
+        size_t oversized_allocations = 0; // Запросов больше block_size
+    };
+
+    struct Stats {
+        FrameStats last_frame;            // Последний завершенный кадр
+        size_t peak_frame_bytes = 0;      // Максимум high_water_bytes за все кадры
+        size_t reserved_bytes = 0;        // Память блоков всех буферов
+        uint64_t frames = 0;
+    };
+
+    // Адаптер для std::pmr контейнеров: deallocate ничего не делает,
+    // память возвращается при сбросе буфера
+    class Resource : public std::pmr::memory_resource {
+    public:
+        explicit Resource(FrameArena& arena) : arena_(arena) {}
+
+    private:
+        FrameArena& arena_;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+public:
+    explicit FrameArena(const Config& config = Config{});
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Переход к следующему буферу и его сброс
+    void BeginFrame();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Деструкторы не вызываются - только для тривиально разрушаемых типов
+    template<typename T, typename... Args>
+    T* New(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::pmr::memory_resource* GetResource() { return &resource_; }
+
+    // Данные всех буферов еще живы, поэтому сразу освобождаются только блоки,
+    // не задействованные их кадрами; сам буфер сжимается до одного блока
+    // block_size при своем сбросе в BeginFrame(). Вызывать из потока рендера;
+    // возвращает байты, освобожденные сразу
+    size_t Trim();
+
+    uint64_t GetFrameIndex() const { return frame_index_; }
+    size_t GetBufferCount() const { return buffers_.size(); }
+    const FrameStats& GetCurrentFrameStats() const { return buffers_[current_buffer_].stats; }
+    Stats GetStats() const;
+
+private:
+    struct Block {
+        char* memory;
+        size_t size;
+    };
+
+    struct Buffer {
+        std::vector<Block> blocks;
+        size_t current_block = 0;
+        size_t offset = 0;
+        FrameStats stats;
+        bool trim = false;                // Trim(): при сбросе - один блок block_size
+    };
+
+    Config config_;
+    std::vector<Buffer> buffers_;
+    size_t current_buffer_ = 0;
+    uint64_t frame_index_ = 0;
+
+    FrameStats last_frame_;
+    size_t peak_frame_bytes_ = 0;
+
+    Resource resource_;
+
+    void* AllocateSlow(size_t size, size_t alignment);
+    void ResetBuffer(Buffer& buffer);
+    static void ReleaseBlocks(Buffer& buffer, size_t keep);
+};
+
+// Быстрый путь: сдвиг указателя в текущем блоке
+inline void* FrameArena::Allocate(size_t size, size_t alignment) {
+    Buffer& buffer = buffers_[current_buffer_];
+
+    if (buffer.current_block < buffer.blocks.size()) {
+        const Block& block = buffer.blocks[buffer.current_block];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.memory);
+        size_t aligned_offset = ((base + buffer.offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+
+        if (aligned_offset <= block.size && size <= block.size - aligned_offset) {
+            buffer.stats.high_water_bytes += aligned_offset - buffer.offset + size;
+            buffer.stats.allocation_count++;
+            buffer.offset = aligned_offset + size;
+            return block.memory + aligned_offset;
+        }
+    }
+
+    return AllocateSlow(size, alignment);
+}
+
+} // namespace Memory
+} // namespace WxeUI
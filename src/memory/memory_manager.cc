@@ -1,13 +1,28 @@
 #include "memory/memory_manager.h"
+#include "memory/memory_tags.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <thread>
 #include <chrono>
 #include <cstring>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <psapi.h>
 #pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #endif
 
 namespace WxeUI {
@@ -17,53 +32,385 @@ namespace Memory {
 struct MemoryManager::Win32MemoryData {
     PROCESS_MEMORY_COUNTERS_EX process_memory = {};
     MEMORYSTATUSEX global_memory = {};
+    HANDLE stop_event = nullptr;    // Прерывает ожидание монитора при остановке
     
     Win32MemoryData() {
         global_memory.dwLength = sizeof(MEMORYSTATUSEX);
     }
 };
+#elif defined(__linux__)
+struct MemoryManager::LinuxMemoryData {
+    std::string cgroup_path;        // /sys/fs/cgroup/<группа процесса>; пусто без cgroup v2
+    std::string pressure_path;      // memory.pressure группы или /proc/pressure/memory
+    std::string vram_path;          // amdgpu: каталог устройства с mem_info_vram_*
+    int pressure_fd = -1;           // PSI trigger, POLLPRI при превышении порога
+    int wake_fd = -1;               // eventfd: пробуждение монитора при остановке
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    
+    ~LinuxMemoryData() {
+        if (pressure_fd >= 0) {
+            close(pressure_fd);
+        }
+        if (wake_fd >= 0) {
+            close(wake_fd);
+        }
+    }
+};
+
+namespace {
+
+bool ReadSmallFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+// Число из файла cgroup/sysfs; "max" (лимит cgroup не задан) считается отсутствием значения
+bool ReadNumericFile(const std::string& path, uint64_t& value) {
+    std::string contents;
+    if (!ReadSmallFile(path, contents) || contents.compare(0, 3, "max") == 0) {
+        return false;
+    }
+    
+    return std::sscanf(contents.c_str(), "%llu", reinterpret_cast<unsigned long long*>(&value)) == 1;
+}
+
+// Поле формата "key value" (memory.stat) или "Key: value kB" (/proc/meminfo)
+bool FindKeyedValue(const std::string& contents, const char* key, uint64_t& value) {
+    std::istringstream stream(contents);
+    std::string line;
+    size_t key_length = std::strlen(key);
+    
+    while (std::getline(stream, line)) {
+        if (line.compare(0, key_length, key) == 0) {
+            return std::sscanf(line.c_str() + key_length, "%llu", reinterpret_cast<unsigned long long*>(&value)) == 1;
+        }
+    }
+    
+    return false;
+}
+
+} // namespace
 #endif
 
+// =============================================================================
+// MemoryPool Thread Cache
+// =============================================================================
+
+namespace {
+
+// Живые пулы по id: поток при завершении возвращает блоки только в существующие пулы.
+// Деструктор пула снимается с регистрации под тем же мьютексом, поэтому
+// не может освободить арены, пока чужой поток сбрасывает в них магазин.
+std::mutex& PoolRegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<uint64_t, MemoryPool*>& PoolRegistry() {
+    static std::unordered_map<uint64_t, MemoryPool*> registry;
+    return registry;
+}
+
+std::atomic<uint64_t> g_next_pool_id{1};
+
+} // namespace
+
+struct MemoryPool::ThreadCacheEntry {
+    struct Magazine {
+        void* blocks[kMagazineCapacity];
+        size_t count = 0;
+    };
+    
+    uint64_t pool_id = 0;
+    uint64_t epoch = 0;
+    MemoryPool* pool = nullptr;
+    Magazine magazines[kThreadCacheClassCount];
+};
+
+struct MemoryPool::ThreadCache {
+    using Entry = ThreadCacheEntry;
+    
+    std::vector<std::unique_ptr<Entry>> entries;
+    Entry* last = nullptr;
+    
+    ~ThreadCache() {
+        std::lock_guard<std::mutex> lock(PoolRegistryMutex());
+        
+        for (auto& entry : entries) {
+            auto it = PoolRegistry().find(entry->pool_id);
+            if (it == PoolRegistry().end() || it->second != entry->pool) {
+                continue; // Пул уже уничтожен вместе с блоками
+            }
+            entry->pool->FlushEntry(*entry);
+        }
+    }
+    
+    // Записи живут до завершения потока; записи уничтоженных пулов не совпадут
+    // по id с новыми, даже если адрес пула переиспользован
+    static Entry& For(MemoryPool* pool) {
+        thread_local ThreadCache cache;
+        
+        if (cache.last && cache.last->pool_id == pool->pool_id_) {
+            return *cache.last;
+        }
+        
+        for (auto& entry : cache.entries) {
+            if (entry->pool_id == pool->pool_id_) {
+                cache.last = entry.get();
+                return *entry;
+            }
+        }
+        
+        auto entry = std::make_unique<Entry>();
+        entry->pool_id = pool->pool_id_;
+        entry->epoch = pool->cache_epoch_.load(std::memory_order_acquire);
+        entry->pool = pool;
+        cache.last = entry.get();
+        cache.entries.push_back(std::move(entry));
+        return *cache.last;
+    }
+};
+
+void* MemoryPool::AllocateCached(size_t size) {
+    if (!config_.enable_thread_cache || config_.alignment > kAlignSize || size > kThreadCacheMaxSize) {
+        return Allocate(size);
+    }
+    
+    // Класс - ближайшая степень двойки сверху, начиная с kAlignSize
+    size_t class_index = std::bit_width(std::max(size, kAlignSize) - 1) - std::bit_width(kAlignSize - 1);
+    
+    ThreadCacheEntry& entry = ThreadCache::For(this);
+    ValidateEntry(entry);
+    
+    ThreadCacheEntry::Magazine& magazine = entry.magazines[class_index];
+    if (magazine.count == 0) {
+        magazine.count = AllocateBatch(kAlignSize << class_index, magazine.blocks, kMagazineBatch);
+        if (magazine.count == 0) {
+            return nullptr;
+        }
+    }
+    
+    void* ptr = magazine.blocks[--magazine.count];
+    TagBlock(FromPayload(ptr));
+    return ptr;
+}
+
+bool MemoryPool::DeallocateCached(void* ptr) {
+    if (!ptr) {
+        return false;
+    }
+    
+    // Чужие указатели (в том числе между аренами) и блоки сверх списка арен -
+    // в Deallocate: там проверка принадлежности под блокировкой
+    if (!config_.enable_thread_cache || !InArenaRanges(reinterpret_cast<uintptr_t>(ptr))) {
+        return Deallocate(ptr);
+    }
+    
+    // Выданный блок помечен тегом в prev_phys_size следующего блока (TagBlock).
+    // Без тега блок уже лежит в магазине или свободен в пуле - повторное освобождение
+    BlockHeader* block = FromPayload(ptr);
+    size_t tag = std::atomic_ref<const size_t>(NextPhysical(block)->prev_phys_size).load(std::memory_order_relaxed);
+    if (block->IsFree() || (tag & kTagMarker) == 0) {
+        return false;
+    }
+    
+    // Размер занятого блока не меняется, пока блок не освобожден
+    size_t block_size = block->GetSize();
+    if (block_size >= 2 * kThreadCacheMaxSize) {
+        return Deallocate(ptr);
+    }
+    
+    // Класс - ближайшая степень двойки снизу: блок пригоден для любого запроса класса
+    size_t class_index = std::bit_width(block_size) - std::bit_width(kAlignSize);
+    
+    UntagBlock(block);
+    
+    ThreadCacheEntry& entry = ThreadCache::For(this);
+    ValidateEntry(entry);
+    
+    ThreadCacheEntry::Magazine& magazine = entry.magazines[class_index];
+    if (magazine.count == kMagazineCapacity) {
+        // Возвращаем в пул старшую половину одной блокировкой
+        magazine.count -= kMagazineBatch;
+        DeallocateBatch(magazine.blocks + magazine.count, kMagazineBatch);
+    }
+    
+    magazine.blocks[magazine.count++] = ptr;
+    return true;
+}
+
+void MemoryPool::FlushThreadCache() {
+    if (!config_.enable_thread_cache) {
+        return;
+    }
+    
+    ThreadCacheEntry& entry = ThreadCache::For(this);
+    ValidateEntry(entry);
+    FlushEntry(entry);
+}
+
+void MemoryPool::ValidateEntry(ThreadCacheEntry& entry) {
+    // После Clear() блоки в магазинах уже принадлежат свободным блокам пула
+    uint64_t epoch = cache_epoch_.load(std::memory_order_acquire);
+    if (entry.epoch != epoch) {
+        for (auto& magazine : entry.magazines) {
+            magazine.count = 0;
+        }
+        entry.epoch = epoch;
+    }
+}
+
+void MemoryPool::FlushEntry(ThreadCacheEntry& entry) {
+    if (entry.epoch != cache_epoch_.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    for (auto& magazine : entry.magazines) {
+        DeallocateBatch(magazine.blocks, magazine.count);
+        magazine.count = 0;
+    }
+}
+
+size_t MemoryPool::AllocateBatch(size_t size, void** blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    size_t allocated = 0;
+    for (; allocated < count; ++allocated) {
+        void* ptr = AllocateInternal(size, kAlignSize);
+        if (!ptr) {
+            break;
+        }
+        RecordAllocation(size, FromPayload(ptr)->GetSize());
+        // Магазин отдает блоки с конца: первый выданный блок должен лежать там
+        blocks[count - 1 - allocated] = ptr;
+    }
+    
+    if (allocated == 0) {
+        stats_.failed_allocations++;
+    } else if (allocated < count) {
+        std::move(blocks + count - allocated, blocks + count, blocks);
+    }
+    
+    return allocated;
+}
+
+void MemoryPool::DeallocateBatch(void* const* blocks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        DeallocateLocked(blocks[i]);
+    }
+}
+
+void MemoryPool::PublishArenaRanges() {
+    // Вызывается под mutex_: писатель один
+    uint32_t seq = arena_ranges_seq_.load(std::memory_order_relaxed);
+    arena_ranges_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    size_t count = arenas_.size();
+    if (count <= kMaxArenaRanges) {
+        std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+        ranges.reserve(count);
+        for (const auto& arena : arenas_) {
+            // Те же границы, что в OwnsPointer
+            auto base = reinterpret_cast<uintptr_t>(arena.memory);
+            ranges.emplace_back(base + kBlockOverhead, base + arena.size - kBlockOverhead);
+        }
+        std::sort(ranges.begin(), ranges.end());
+        for (size_t i = 0; i < count; ++i) {
+            arena_ranges_[i].begin.store(ranges[i].first, std::memory_order_relaxed);
+            arena_ranges_[i].end.store(ranges[i].second, std::memory_order_relaxed);
+        }
+    }
+    arena_range_count_.store(count, std::memory_order_relaxed);
+    
+    arena_ranges_seq_.store(seq + 2, std::memory_order_release);
+}
+
+bool MemoryPool::InArenaRanges(uintptr_t address) const {
+    if (address % kAlignSize != 0) {
+        return false;
+    }
+    
+    for (;;) {
+        uint32_t seq = arena_ranges_seq_.load(std::memory_order_acquire);
+        if (seq & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        
+        size_t count = arena_range_count_.load(std::memory_order_relaxed);
+        bool found = false;
+        if (count <= kMaxArenaRanges) {
+            // Последняя арена, начинающаяся не позже адреса
+            size_t low = 0;
+            size_t high = count;
+            while (low < high) {
+                size_t middle = (low + high) / 2;
+                if (arena_ranges_[middle].begin.load(std::memory_order_relaxed) <= address) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            found = low > 0 && address < arena_ranges_[low - 1].end.load(std::memory_order_relaxed);
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (arena_ranges_seq_.load(std::memory_order_relaxed) == seq) {
+            return found;
+        }
+    }
+}
+
 // =============================================================================
 // MemoryPool Implementation
 // =============================================================================
 
 MemoryPool::MemoryPool(MemoryType type, const Config& config) 
-    : type_(type), config_(config), pool_memory_(nullptr), pool_size_(0), used_size_(0) {
-    // Выделяем начальный пул памяти
-    pool_size_ = config_.initial_size;
-    
-#ifdef _WIN32
-    if (type == MemoryType::SYSTEM_RAM) {
-        pool_memory_ = VirtualAlloc(nullptr, pool_size_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-    } else {
-        pool_memory_ = malloc(pool_size_);
+    : type_(type), config_(config), pool_size_(0), used_size_(0), pool_id_(g_next_pool_id++) {
+    // Выделяем начальную арену
+    size_t initial_size = GetAlignedSize(std::max(config_.initial_size, 2 * kBlockOverhead + kMinBlockSize), kAlignSize);
+    
+    Arena arena;
+    if (AllocateRegion(initial_size, arena)) {
+        arenas_.push_back(arena);
+        pool_size_ = arena.size;
+        PublishArenaRanges();
+        
+        // Один большой свободный блок и замыкающий sentinel
+        InitializeRegion(arena.memory, arena.size);
     }
-#else
-    pool_memory_ = malloc(pool_size_);
-#endif
     
-    if (pool_memory_) {
-        // Добавляем один большой свободный блок
-        blocks_.emplace_back(pool_memory_, pool_size_);
+    if (config_.enable_thread_cache) {
+        std::lock_guard<std::mutex> lock(PoolRegistryMutex());
+        PoolRegistry()[pool_id_] = this;
     }
 }
 
 MemoryPool::~MemoryPool() {
+    if (config_.enable_thread_cache) {
+        std::lock_guard<std::mutex> lock(PoolRegistryMutex());
+        PoolRegistry().erase(pool_id_);
+    }
+    
     Clear();
     
-    if (pool_memory_) {
-#ifdef _WIN32
-        if (type_ == MemoryType::SYSTEM_RAM) {
-            VirtualFree(pool_memory_, 0, MEM_RELEASE);
-        } else {
-            free(pool_memory_);
-        }
-#else
-        free(pool_memory_);
-#endif
-        pool_memory_ = nullptr;
+    for (const auto& arena : arenas_) {
+        ReleaseRegion(arena.memory, arena.size);
     }
+    arenas_.clear();
 }
 
 void* MemoryPool::Allocate(size_t size) {
@@ -75,18 +422,8 @@ void* MemoryPool::AllocateAligned(size_t size, size_t alignment) {
     
     void* ptr = AllocateInternal(size, alignment);
     if (ptr) {
-        stats_.total_allocations++;
-        stats_.current_allocations++;
-        stats_.total_bytes_allocated += size;
-        stats_.current_bytes_allocated += size;
-        
-        // Обновляем пики
-        if (stats_.current_allocations > stats_.peak_allocations) {
-            stats_.peak_allocations = stats_.current_allocations.load();
-        }
-        if (stats_.current_bytes_allocated > stats_.peak_bytes_allocated) {
-            stats_.peak_bytes_allocated = stats_.current_bytes_allocated.load();
-        }
+        RecordAllocation(size, FromPayload(ptr)->GetSize());
+        TagBlock(FromPayload(ptr));
     } else {
         stats_.failed_allocations++;
     }
@@ -94,48 +431,94 @@ void* MemoryPool::AllocateAligned(size_t size, size_t alignment) {
     return ptr;
 }
 
+void MemoryPool::RecordAllocation(size_t requested_size, size_t block_size) {
+    stats_.total_allocations++;
+    stats_.current_allocations++;
+    stats_.total_bytes_allocated += requested_size;
+    stats_.current_bytes_allocated += block_size;
+    
+    // Обновляем пики
+    if (stats_.current_allocations > stats_.peak_allocations) {
+        stats_.peak_allocations = stats_.current_allocations.load();
+    }
+    if (stats_.current_bytes_allocated > stats_.peak_bytes_allocated) {
+        stats_.peak_bytes_allocated = stats_.current_bytes_allocated.load();
+    }
+}
+
+void MemoryPool::TagBlock(BlockHeader* block) {
+    MemoryTagId tag = MemoryTags::GetCurrent();
+    NextPhysical(block)->prev_phys_size = kTagMarker | tag;
+    MemoryTags::RecordAllocation(tag, block->GetSize(), MemoryTagDomain::POOL);
+}
+
+void MemoryPool::UntagBlock(BlockHeader* block) {
+    // Блоки магазинов и пакетов не помечены: они не выданы пользователю
+    BlockHeader* next = NextPhysical(block);
+    if (next->prev_phys_size & kTagMarker) {
+        MemoryTags::RecordDeallocation(static_cast<MemoryTagId>(next->prev_phys_size & ~kTagMarker),
+                                       block->GetSize(), MemoryTagDomain::POOL);
+    }
+    next->prev_phys_size = block->GetSize();
+}
+
 bool MemoryPool::Deallocate(void* ptr) {
     if (!ptr) {
         return false;
     }
     
     std::lock_guard<std::mutex> lock(mutex_);
+    return DeallocateLocked(ptr);
+}
+
+bool MemoryPool::DeallocateLocked(void* ptr) {
+    if (!OwnsPointer(ptr)) {
+        return false;
+    }
     
-    // Находим блок
-    for (auto& block : blocks_) {
-        if (block.ptr == ptr && block.in_use) {
-            block.in_use = false;
-            block.free_time = std::chrono::steady_clock::now();
-            
-            stats_.current_allocations--;
-            stats_.current_bytes_allocated -= block.size;
-            used_size_ -= block.size;
-            
-            // Объединяем соседние свободные блоки
-            MergeAdjacentBlocks();
-            
-            return true;
-        }
+    BlockHeader* block = FromPayload(ptr);
+    if (block->IsFree()) {
+        return false; // Повторное освобождение
     }
     
-    return false;
+    size_t block_size = block->GetSize();
+    stats_.current_allocations--;
+    stats_.current_bytes_allocated -= block_size;
+    used_size_ -= block_size;
+    
+    // Восстанавливаем boundary tag до слияния
+    UntagBlock(block);
+    
+    block->SetFree(true);
+    NextPhysical(block)->SetPrevFree(true);
+    
+    // Объединяем с соседними свободными блоками по boundary tags
+    InsertFreeBlock(MergeNeighbors(block));
+    
+    return true;
 }
 
 void MemoryPool::Clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    for (auto& block : blocks_) {
-        block.in_use = false;
-    }
+    // Магазины всех потоков сбрасываются при следующем обращении к пулу
+    cache_epoch_.fetch_add(1, std::memory_order_acq_rel);
     
     used_size_ = 0;
     stats_.current_allocations = 0;
     stats_.current_bytes_allocated = 0;
     
-    // Оставляем один большой свободный блок
-    blocks_.clear();
-    if (pool_memory_) {
-        blocks_.emplace_back(pool_memory_, pool_size_);
+    // Оставляем по одному большому свободному блоку в каждой арене;
+    // живые помеченные блоки снимаются с учета тегов
+    ResetFreeIndex();
+    for (const auto& arena : arenas_) {
+        auto* sentinel = reinterpret_cast<BlockHeader*>(static_cast<char*>(arena.memory) + arena.size - kBlockOverhead);
+        for (auto* block = static_cast<BlockHeader*>(arena.memory); block != sentinel; block = NextPhysical(block)) {
+            if (!block->IsFree()) {
+                UntagBlock(block);
+            }
+        }
+        InitializeRegion(arena.memory, arena.size);
     }
 }
 
@@ -157,27 +540,21 @@ size_t MemoryPool::GetFreeSize() const {
 size_t MemoryPool::GetFragmentation() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (pool_size_ == 0) {
+    if (free_block_count_ <= 1 || free_payload_bytes_ == 0) {
         return 0;
     }
     
-    size_t free_blocks = 0;
-    size_t largest_free = 0;
-    
-    for (const auto& block : blocks_) {
-        if (!block.in_use) {
-            free_blocks++;
-            largest_free = std::max(largest_free, block.size);
-        }
-    }
+    // Крупнейший свободный блок лежит в старшем непустом классе
+    size_t fl = std::bit_width(fl_bitmap_) - 1;
+    size_t sl = std::bit_width(sl_bitmap_[fl]) - 1;
     
-    size_t total_free = GetFreeSize();
-    if (total_free == 0) {
-        return 0;
+    size_t largest_free = 0;
+    for (const BlockHeader* block = free_lists_[fl][sl]; block; block = block->next_free) {
+        largest_free = std::max(largest_free, block->GetSize());
     }
     
-    // Простая метрика фрагментации: (количество_свободных_блоков - 1) / общая_свободная_память
-    return free_blocks > 1 ? ((free_blocks - 1) * 100) / total_free : 0;
+    // Доля свободной памяти, недоступной для одной крупной аллокации
+    return ((free_payload_bytes_ - largest_free) * 100) / free_payload_bytes_;
 }
 
 AllocationStats MemoryPool::GetStats() const {
@@ -191,130 +568,510 @@ void MemoryPool::ResetStats() {
 }
 
 void* MemoryPool::AllocateInternal(size_t size, size_t alignment) {
-    size_t aligned_size = GetAlignedSize(size, alignment);
-    
-    // Ищем подходящий свободный блок
-    for (auto& block : blocks_) {
-        if (!block.in_use && block.size >= aligned_size) {
-            // Проверяем выравнивание
-            uintptr_t addr = reinterpret_cast<uintptr_t>(block.ptr);
-            size_t padding = (alignment - (addr % alignment)) % alignment;
-            
-            if (block.size >= aligned_size + padding) {
-                // Разделяем блок если нужно
-                if (block.size > aligned_size + padding + sizeof(Block)) {
-                    size_t remaining_size = block.size - aligned_size - padding;
-                    void* remaining_ptr = static_cast<char*>(block.ptr) + aligned_size + padding;
-                    
-                    blocks_.emplace_back(remaining_ptr, remaining_size);
-                }
-                
-                block.size = aligned_size;
-                block.in_use = true;
-                block.alloc_time = std::chrono::steady_clock::now();
-                used_size_ += aligned_size;
-                
-                return static_cast<char*>(block.ptr) + padding;
-            }
+    alignment = std::max(alignment, kAlignSize);
+    if ((alignment & (alignment - 1)) != 0) {
+        return nullptr; // Поддерживаются только степени двойки
+    }
+    
+    size_t aligned_size = std::max(GetAlignedSize(size, kAlignSize), kMinBlockSize);
+    
+    // Для выравнивания сверх kAlignSize нужен запас под свободный блок перед нагрузкой
+    size_t search_size = aligned_size;
+    if (alignment > kAlignSize) {
+        search_size += alignment + kBlockOverhead + kMinBlockSize;
+    }
+    
+    if (search_size >= kMaxBlockSize / 2) {
+        return nullptr;
+    }
+    
+    size_t fl = 0, sl = 0;
+    MappingSearch(search_size, fl, sl);
+    BlockHeader* block = FindSuitableBlock(fl, sl);
+    
+    if (!block) {
+        // Не найден подходящий блок - пытаемся расширить пул.
+        // Запас на округление класса, чтобы новый блок гарантированно нашелся поиском
+        size_t grow_size = search_size + (search_size >> kSLIndexCountLog2) + 2 * kBlockOverhead;
+        if (GrowPool(grow_size)) {
+            return AllocateInternal(size, alignment);
         }
+        return nullptr;
     }
     
-    // Не найден подходящий блок - пытаемся расширить пул
-    if (GrowPool(aligned_size)) {
-        return AllocateInternal(size, alignment);
+    RemoveFreeBlock(block);
+    
+    if (alignment > kAlignSize) {
+        block = TrimFront(block, alignment);
     }
+    TrimBack(block, aligned_size);
     
-    return nullptr;
+    block->SetFree(false);
+    NextPhysical(block)->SetPrevFree(false);
+    used_size_ += block->GetSize();
+    
+    return Payload(block);
 }
 
 bool MemoryPool::GrowPool(size_t min_additional_size) {
-    size_t new_size = pool_size_;
+    if (pool_size_ >= config_.max_size) {
+        return false;
+    }
     
-    while (new_size - pool_size_ < min_additional_size) {
-        new_size *= config_.growth_factor;
-        
-        if (new_size > config_.max_size) {
-            new_size = config_.max_size;
-            break;
-        }
+    // Геометрический рост: новая арена равна приросту, который давал бы прежний
+    // realloc пула, но существующие блоки не копируются и не перемещаются
+    size_t growth_factor = std::max<size_t>(config_.growth_factor, 2);
+    size_t arena_size = std::max(pool_size_ * (growth_factor - 1), kSmallBlockSize);
+    arena_size = std::max(arena_size, min_additional_size);
+    arena_size = std::min(arena_size, config_.max_size - pool_size_);
+    arena_size &= ~(kAlignSize - 1);
+    
+    if (arena_size < min_additional_size || arena_size < 2 * kBlockOverhead + kMinBlockSize) {
+        return false;
     }
     
-    if (new_size <= pool_size_ || new_size > config_.max_size) {
+    Arena arena;
+    if (!AllocateRegion(arena_size, arena)) {
         return false;
     }
     
-    // Перевыделяем память
+    arenas_.push_back(arena);
+    pool_size_ += arena.size;
+    PublishArenaRanges();
+    InitializeRegion(arena.memory, arena.size);
+    
+    return true;
+}
+
+void MemoryPool::Shrink() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Первая арена остается всегда, остальные возвращаются системе, если полностью свободны
+    for (size_t i = arenas_.size(); i-- > 1; ) {
+        const Arena arena = arenas_[i];
+        if (!IsArenaFree(arena)) {
+            continue;
+        }
+        
+        // Арена уходит из списка DeallocateCached до возврата ее страниц ОС
+        RemoveFreeBlock(static_cast<BlockHeader*>(arena.memory));
+        arenas_.erase(arenas_.begin() + i);
+        PublishArenaRanges();
+        ReleaseRegion(arena.memory, arena.size);
+        pool_size_ -= arena.size;
+    }
+    
+    // Из оставшихся арен адресное пространство не освобождается, но физические
+    // страницы внутри свободных блоков возвращаются ОС
+    if (config_.decommit_free_pages) {
+        for (const auto& arena : arenas_) {
+            DecommitFreePages(arena);
+        }
+    }
+}
+
+size_t MemoryPool::GetAlignedSize(size_t size, size_t alignment) const {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
 #ifdef _WIN32
-    void* new_memory;
-    if (type_ == MemoryType::SYSTEM_RAM) {
-        new_memory = VirtualAlloc(nullptr, new_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-    } else {
-        new_memory = malloc(new_size);
+namespace {
+
+bool EnableLockMemoryPrivilege() {
+    HANDLE token = nullptr;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
     }
-#else
-    void* new_memory = malloc(new_size);
+    
+    TOKEN_PRIVILEGES privileges = {};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    
+    bool enabled = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+                   AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                   GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+    return enabled;
+}
+
+} // namespace
 #endif
+
+bool MemoryPool::AllocateRegion(size_t size, Arena& arena) {
+    arena = {nullptr, size, 4096};
     
-    if (!new_memory) {
-        return false;
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    arena.page_size = system_info.dwPageSize;
+    
+    DWORD numa_node = NUMA_NO_PREFERRED_NODE;
+    if (config_.numa_node >= 0) {
+        numa_node = static_cast<DWORD>(config_.numa_node);
+    } else if (config_.numa_node == kNumaOwnerThread) {
+        PROCESSOR_NUMBER processor;
+        GetCurrentProcessorNumberEx(&processor);
+        USHORT node = 0;
+        if (GetNumaProcessorNodeEx(&processor, &node)) {
+            numa_node = node;
+        }
     }
     
-    // Копируем существующие данные
-    if (pool_memory_) {
-        memcpy(new_memory, pool_memory_, pool_size_);
+    // Крупные страницы всегда закреплены в памяти; без привилегии - обычные
+    if (config_.huge_pages == HugePageMode::EXPLICIT && size >= kHugePageSize) {
+        static const bool privilege = EnableLockMemoryPrivilege();
+        size_t large_page = GetLargePageMinimum();
+        if (privilege && large_page != 0) {
+            size_t large_size = GetAlignedSize(size, large_page);
+            arena.memory = VirtualAllocExNuma(GetCurrentProcess(), nullptr, large_size,
+                                              MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, numa_node);
+            if (arena.memory) {
+                arena.size = large_size;
+                arena.page_size = large_page;
+                return true;
+            }
+        }
+    }
+    
+    arena.size = GetAlignedSize(size, arena.page_size);
+    arena.memory = VirtualAllocExNuma(GetCurrentProcess(), nullptr, arena.size,
+                                      MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, numa_node);
+    return arena.memory != nullptr;
+#elif defined(__linux__)
+    arena.page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    bool huge = config_.huge_pages != HugePageMode::NONE && size >= kHugePageSize;
+    
+    if (huge && config_.huge_pages == HugePageMode::EXPLICIT) {
+        size_t huge_size = GetAlignedSize(size, kHugePageSize);
+        void* memory = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            arena = {memory, huge_size, kHugePageSize};
+        }
+    }
+    
+    if (!arena.memory) {
+        // THP собирает только выровненные 2MB участки: берем запас и обрезаем края
+        arena.size = GetAlignedSize(size, huge ? kHugePageSize : arena.page_size);
+        size_t reserve = arena.size + (huge ? kHugePageSize : 0);
+        
+        void* memory = mmap(nullptr, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        
+        char* base = static_cast<char*>(memory);
+        char* aligned = base;
+        if (huge) {
+            aligned = reinterpret_cast<char*>(GetAlignedSize(reinterpret_cast<uintptr_t>(base), kHugePageSize));
+            if (aligned > base) {
+                munmap(base, aligned - base);
+            }
+            if (base + reserve > aligned + arena.size) {
+                munmap(aligned + arena.size, base + reserve - (aligned + arena.size));
+            }
+            madvise(aligned, arena.size, MADV_HUGEPAGE);
+        }
+        arena.memory = aligned;
+    }
+    
+    // Политика задается до первого касания: InitializeRegion пишет заголовки арены
+    if (config_.numa_node != kNumaFirstTouch) {
+        unsigned cpu = 0;
+        unsigned node = static_cast<unsigned>(std::max(config_.numa_node, 0));
+        if (config_.numa_node != kNumaOwnerThread || syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            constexpr int kMpolPreferred = 1;
+            unsigned long node_mask[16] = {};
+            if (node < sizeof(node_mask) * 8) {
+                node_mask[node / (sizeof(unsigned long) * 8)] = 1ul << (node % (sizeof(unsigned long) * 8));
+                syscall(SYS_mbind, arena.memory, arena.size, kMpolPreferred, node_mask, sizeof(node_mask) * 8, 0);
+            }
+        }
+    }
+    
+    return true;
+#else
+    arena.memory = malloc(size);
+    return arena.memory != nullptr;
+#endif
+}
+
+void MemoryPool::ReleaseRegion(void* memory, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    munmap(memory, size);
+#else
+    (void)size;
+    free(memory);
+#endif
+}
+
+size_t MemoryPool::DecommitFreePages(const Arena& arena) {
+    size_t decommitted = 0;
+    
+    auto* sentinel = reinterpret_cast<BlockHeader*>(static_cast<char*>(arena.memory) + arena.size - kBlockOverhead);
+    for (auto* block = static_cast<BlockHeader*>(arena.memory); block != sentinel; block = NextPhysical(block)) {
+        if (!block->IsFree() || block->GetSize() < kDecommitMinSize) {
+            continue;
+        }
+        
+        // Ссылки free-списка в начале нагрузки и заголовок следующего блока остаются на месте
+        uintptr_t begin = reinterpret_cast<uintptr_t>(Payload(block)) + kMinBlockSize;
+        uintptr_t end = reinterpret_cast<uintptr_t>(NextPhysical(block));
+        begin = (begin + arena.page_size - 1) & ~(uintptr_t(arena.page_size) - 1);
+        end &= ~(uintptr_t(arena.page_size) - 1);
+        if (end <= begin) {
+            continue;
+        }
         
 #ifdef _WIN32
-        if (type_ == MemoryType::SYSTEM_RAM) {
-            VirtualFree(pool_memory_, 0, MEM_RELEASE);
-        } else {
-            free(pool_memory_);
+        // Крупные страницы закреплены и не сбрасываются
+        if (arena.page_size >= kHugePageSize ||
+            !VirtualAlloc(reinterpret_cast<void*>(begin), end - begin, MEM_RESET, PAGE_READWRITE)) {
+            continue;
+        }
+#elif defined(__linux__)
+        // Анонимные страницы освобождаются сразу, при следующем касании приходят нулевыми
+        if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED) != 0) {
+            continue;
         }
 #else
-        free(pool_memory_);
+        continue;
 #endif
+        decommitted += end - begin;
     }
     
-    // Обновляем указатели в блоках
-    ptrdiff_t offset = static_cast<char*>(new_memory) - static_cast<char*>(pool_memory_);
-    for (auto& block : blocks_) {
-        block.ptr = static_cast<char*>(block.ptr) + offset;
+    return decommitted;
+}
+
+bool MemoryPool::IsArenaFree(const Arena& arena) const {
+    auto* block = static_cast<const BlockHeader*>(arena.memory);
+    auto* sentinel = reinterpret_cast<const BlockHeader*>(static_cast<const char*>(arena.memory) + arena.size - kBlockOverhead);
+    
+    return block->IsFree() && NextPhysical(block) == sentinel;
+}
+
+// -----------------------------------------------------------------------------
+// TLSF
+// -----------------------------------------------------------------------------
+
+void MemoryPool::ResetFreeIndex() {
+    fl_bitmap_ = 0;
+    std::fill(std::begin(sl_bitmap_), std::end(sl_bitmap_), 0u);
+    for (auto& lists : free_lists_) {
+        std::fill(std::begin(lists), std::end(lists), nullptr);
     }
+    free_block_count_ = 0;
+    free_payload_bytes_ = 0;
+}
+
+void MemoryPool::InitializeRegion(void* memory, size_t size) {
+    auto* block = static_cast<BlockHeader*>(memory);
+    block->prev_phys_size = 0;
+    block->size_and_flags = 0;
+    block->SetSize(size - 2 * kBlockOverhead);
+    block->SetFree(true);
     
-    // Добавляем новый свободный блок
-    void* new_block_ptr = static_cast<char*>(new_memory) + pool_size_;
-    size_t new_block_size = new_size - pool_size_;
-    blocks_.emplace_back(new_block_ptr, new_block_size);
+    // Sentinel нулевого размера: всегда занят, слияние через границу арены невозможно
+    BlockHeader* sentinel = NextPhysical(block);
+    sentinel->prev_phys_size = block->GetSize();
+    sentinel->size_and_flags = 0;
+    sentinel->SetPrevFree(true);
     
-    pool_memory_ = new_memory;
-    pool_size_ = new_size;
+    InsertFreeBlock(block);
+}
+
+void MemoryPool::MappingInsert(size_t size, size_t& fl, size_t& sl) {
+    if (size < kSmallBlockSize) {
+        // Мелкие блоки: линейные классы по kSmallBlockSize / kSLIndexCount байт
+        fl = 0;
+        sl = size / (kSmallBlockSize / kSLIndexCount);
+    } else {
+        size_t log2 = std::bit_width(size) - 1;
+        sl = (size >> (log2 - kSLIndexCountLog2)) ^ kSLIndexCount;
+        fl = log2 - (kFLIndexShift - 1);
+    }
+}
+
+void MemoryPool::MappingSearch(size_t size, size_t& fl, size_t& sl) {
+    // Округляем вверх до следующего подкласса: любой блок из найденного списка подойдет
+    if (size >= kSmallBlockSize) {
+        size += (size_t(1) << (std::bit_width(size) - 1 - kSLIndexCountLog2)) - 1;
+    }
+    MappingInsert(size, fl, sl);
+}
+
+MemoryPool::BlockHeader* MemoryPool::FindSuitableBlock(size_t& fl, size_t& sl) const {
+    if (fl >= kFLIndexCount) {
+        return nullptr;
+    }
     
-    return true;
+    uint32_t sl_map = sl_bitmap_[fl] & (~0u << sl);
+    if (!sl_map) {
+        // В текущем классе нет подходящих блоков - берем следующий непустой
+        uint64_t fl_map = fl + 1 < 64 ? fl_bitmap_ & (~uint64_t(0) << (fl + 1)) : 0;
+        if (!fl_map) {
+            return nullptr;
+        }
+        
+        fl = std::countr_zero(fl_map);
+        sl_map = sl_bitmap_[fl];
+    }
+    
+    sl = std::countr_zero(sl_map);
+    return free_lists_[fl][sl];
 }
 
-size_t MemoryPool::GetAlignedSize(size_t size, size_t alignment) const {
-    return (size + alignment - 1) & ~(alignment - 1);
+void MemoryPool::InsertFreeBlock(BlockHeader* block) {
+    size_t fl = 0, sl = 0;
+    MappingInsert(block->GetSize(), fl, sl);
+    
+    BlockHeader* head = free_lists_[fl][sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head) {
+        head->prev_free = block;
+    }
+    
+    free_lists_[fl][sl] = block;
+    fl_bitmap_ |= uint64_t(1) << fl;
+    sl_bitmap_[fl] |= 1u << sl;
+    
+    free_block_count_++;
+    free_payload_bytes_ += block->GetSize();
 }
 
-void MemoryPool::MergeAdjacentBlocks() {
-    // Сортируем блоки по адресу
-    std::sort(blocks_.begin(), blocks_.end(), [](const Block& a, const Block& b) {
-        return a.ptr < b.ptr;
-    });
-    
-    // Объединяем соседние свободные блоки
-    for (size_t i = 0; i < blocks_.size() - 1; ) {
-        if (!blocks_[i].in_use && !blocks_[i + 1].in_use) {
-            // Проверяем, что блоки соседние
-            char* end_of_first = static_cast<char*>(blocks_[i].ptr) + blocks_[i].size;
-            if (end_of_first == blocks_[i + 1].ptr) {
-                // Объединяем блоки
-                blocks_[i].size += blocks_[i + 1].size;
-                blocks_.erase(blocks_.begin() + i + 1);
-                continue;
+void MemoryPool::RemoveFreeBlock(BlockHeader* block) {
+    size_t fl = 0, sl = 0;
+    MappingInsert(block->GetSize(), fl, sl);
+    
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        free_lists_[fl][sl] = block->next_free;
+        
+        if (!free_lists_[fl][sl]) {
+            sl_bitmap_[fl] &= ~(1u << sl);
+            if (!sl_bitmap_[fl]) {
+                fl_bitmap_ &= ~(uint64_t(1) << fl);
             }
         }
-        ++i;
     }
+    
+    free_block_count_--;
+    free_payload_bytes_ -= block->GetSize();
+}
+
+MemoryPool::BlockHeader* MemoryPool::TrimFront(BlockHeader* block, size_t alignment) {
+    uintptr_t payload = reinterpret_cast<uintptr_t>(Payload(block));
+    uintptr_t aligned = (payload + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    size_t gap = aligned - payload;
+    
+    if (gap == 0) {
+        return block;
+    }
+    
+    // Отрезанная часть должна вместить собственный свободный блок
+    if (gap < kBlockOverhead + kMinBlockSize) {
+        aligned = (payload + kBlockOverhead + kMinBlockSize + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        gap = aligned - payload;
+    }
+    
+    size_t remaining_size = block->GetSize() - gap;
+    block->SetSize(gap - kBlockOverhead);
+    
+    BlockHeader* aligned_block = FromPayload(reinterpret_cast<void*>(aligned));
+    aligned_block->prev_phys_size = block->GetSize();
+    aligned_block->size_and_flags = 0;
+    aligned_block->SetSize(remaining_size);
+    aligned_block->SetPrevFree(true);
+    NextPhysical(aligned_block)->prev_phys_size = remaining_size;
+    
+    // Левый сосед block занят по инварианту TLSF, слияние не требуется
+    InsertFreeBlock(block);
+    
+    return aligned_block;
+}
+
+void MemoryPool::TrimBack(BlockHeader* block, size_t size) {
+    size_t block_size = block->GetSize();
+    if (block_size < size + kBlockOverhead + kMinBlockSize) {
+        return; // Остаток слишком мал для отдельного блока
+    }
+    
+    auto* remainder = reinterpret_cast<BlockHeader*>(Payload(block) + size);
+    size_t remainder_size = block_size - size - kBlockOverhead;
+    block->SetSize(size);
+    
+    remainder->prev_phys_size = size;
+    remainder->size_and_flags = 0;
+    remainder->SetSize(remainder_size);
+    remainder->SetFree(true);
+    
+    BlockHeader* next = NextPhysical(remainder);
+    next->prev_phys_size = remainder_size;
+    next->SetPrevFree(true);
+    
+    InsertFreeBlock(remainder);
+}
+
+MemoryPool::BlockHeader* MemoryPool::MergeNeighbors(BlockHeader* block) {
+    if (block->IsPrevFree()) {
+        BlockHeader* prev = PrevPhysical(block);
+        RemoveFreeBlock(prev);
+        prev->SetSize(prev->GetSize() + kBlockOverhead + block->GetSize());
+        block = prev;
+        NextPhysical(block)->prev_phys_size = block->GetSize();
+    }
+    
+    BlockHeader* next = NextPhysical(block);
+    if (next->IsFree()) {
+        RemoveFreeBlock(next);
+        block->SetSize(block->GetSize() + kBlockOverhead + next->GetSize());
+        NextPhysical(block)->prev_phys_size = block->GetSize();
+    }
+    
+    return block;
+}
+
+bool MemoryPool::OwnsPointer(const void* ptr) const {
+    uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    if (addr % kAlignSize != 0) {
+        return false;
+    }
+    
+    // Арен немного: рост геометрический, их число ~log(max_size / initial_size)
+    for (const auto& arena : arenas_) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(arena.memory);
+        if (addr >= base + kBlockOverhead && addr < base + arena.size - kBlockOverhead) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+MemoryPool::BlockHeader* MemoryPool::NextPhysical(const BlockHeader* block) {
+    return reinterpret_cast<BlockHeader*>(Payload(block) + block->GetSize());
+}
+
+MemoryPool::BlockHeader* MemoryPool::PrevPhysical(const BlockHeader* block) {
+    char* header = reinterpret_cast<char*>(const_cast<BlockHeader*>(block));
+    return reinterpret_cast<BlockHeader*>(header - kBlockOverhead - block->prev_phys_size);
+}
+
+MemoryPool::BlockHeader* MemoryPool::FromPayload(const void* ptr) {
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(const_cast<void*>(ptr)) - kBlockOverhead);
+}
+
+char* MemoryPool::Payload(const BlockHeader* block) {
+    return reinterpret_cast<char*>(const_cast<BlockHeader*>(block)) + kBlockOverhead;
 }
 
 // =============================================================================
@@ -324,6 +1081,8 @@ void MemoryPool::MergeAdjacentBlocks() {
 MemoryManager::MemoryManager(const Config& config) : config_(config) {
 #ifdef _WIN32
     win32_data_ = std::make_unique<Win32MemoryData>();
+#elif defined(__linux__)
+    linux_data_ = std::make_unique<LinuxMemoryData>();
 #endif
 }
 
@@ -342,7 +1101,10 @@ bool MemoryManager::Initialize() {
             MemoryType::SYSTEM_RAM, 
             MemoryPool::Config{
                 .initial_size = config_.small_pool_size,
-                .max_size = config_.large_pool_size
+                .max_size = config_.large_pool_size,
+                .enable_thread_cache = config_.enable_thread_caches,
+                .huge_pages = config_.pool_huge_pages,
+                .numa_node = config_.pool_numa_node
             }
         );
         
@@ -350,7 +1112,10 @@ bool MemoryManager::Initialize() {
             MemoryType::GPU_VRAM,
             MemoryPool::Config{
                 .initial_size = config_.medium_pool_size,
-                .max_size = config_.large_pool_size
+                .max_size = config_.large_pool_size,
+                .enable_thread_cache = config_.enable_thread_caches,
+                .huge_pages = config_.pool_huge_pages,
+                .numa_node = config_.pool_numa_node
             }
         );
     }
@@ -367,6 +1132,8 @@ void MemoryManager::Shutdown() {
     ShutdownPlatform();
     
     memory_pools_.clear();
+    
+    std::lock_guard<std::mutex> lock(cleanup_mutex_);
     cleanup_callbacks_.clear();
 }
 
@@ -390,10 +1157,41 @@ std::unordered_map<MemoryType, MemoryInfo> MemoryManager::GetAllMemoryInfo() con
     return info_map;
 }
 
+MemoryPressure MemoryManager::GetMemoryPressure() const {
+    MemoryPressure pressure;
+    
+#if defined(__linux__)
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    std::string contents;
+    if (linux_data_->pressure_path.empty() || !ReadSmallFile(linux_data_->pressure_path, contents)) {
+        return pressure;
+    }
+    
+    std::istringstream stream(contents);
+    std::string line;
+    while (std::getline(stream, line)) {
+        double avg10 = 0.0, avg60 = 0.0, avg300 = 0.0;
+        unsigned long long total = 0;
+        
+        if (std::sscanf(line.c_str(), "some avg10=%lf avg60=%lf avg300=%lf total=%llu", &avg10, &avg60, &avg300, &total) == 4) {
+            pressure.some_avg10 = avg10;
+            pressure.some_total_us = total;
+            pressure.available = true;
+        } else if (std::sscanf(line.c_str(), "full avg10=%lf avg60=%lf avg300=%lf total=%llu", &avg10, &avg60, &avg300, &total) == 4) {
+            pressure.full_avg10 = avg10;
+            pressure.full_total_us = total;
+        }
+    }
+#endif
+    
+    return pressure;
+}
+
 void* MemoryManager::AllocateFromPool(size_t size, MemoryType type) {
     auto it = memory_pools_.find(type);
     if (it != memory_pools_.end()) {
-        return it->second->Allocate(size);
+        return it->second->AllocateCached(size);
     }
     
     // Fallback на обычное выделение
@@ -403,7 +1201,7 @@ void* MemoryManager::AllocateFromPool(size_t size, MemoryType type) {
 bool MemoryManager::DeallocateFromPool(void* ptr, MemoryType type) {
     auto it = memory_pools_.find(type);
     if (it != memory_pools_.end()) {
-        return it->second->Deallocate(ptr);
+        return it->second->DeallocateCached(ptr);
     }
     
     // Fallback на обычное освобождение
@@ -412,20 +1210,13 @@ bool MemoryManager::DeallocateFromPool(void* ptr, MemoryType type) {
 }
 
 size_t MemoryManager::FreeUnusedMemory() {
-    size_t freed = 0;
-    
-    // Вызываем callbacks для освобождения памяти
-    for (const auto& pair : cleanup_callbacks_) {
-        try {
-            freed += pair.second();
-        } catch (...) {
-            // Игнорируем ошибки cleanup callbacks
-        }
-    }
+    // Все callbacks без ограничения цели
+    size_t freed = ExecuteCleanup(SIZE_MAX);
     
-    // Сжимаем пулы памяти
+    // Сжимаем пулы памяти; магазины других потоков сбрасываются при их завершении
     for (auto& pair : memory_pools_) {
         if (pair.second && config_.enable_memory_pools) {
+            pair.second->FlushThreadCache();
             pair.second->Shrink();
         }
     }
@@ -434,7 +1225,11 @@ size_t MemoryManager::FreeUnusedMemory() {
 }
 
 size_t MemoryManager::ForceCleanup() {
-    return ExecuteCleanup();
+    return ExecuteCleanup(SIZE_MAX);
+}
+
+size_t MemoryManager::ReclaimMemory(size_t bytes_requested) {
+    return ExecuteCleanup(bytes_requested);
 }
 
 bool MemoryManager::RequestMemory(size_t size, MemoryType type) {
@@ -444,8 +1239,8 @@ bool MemoryManager::RequestMemory(size_t size, MemoryType type) {
         return true;
     }
     
-    // Пытаемся освободить память
-    size_t freed = FreeUnusedMemory();
+    // Освобождаем недостающее, начиная с дешевых reclaimers
+    ExecuteCleanup(size - info.available_bytes);
     
     info = GetMemoryInfo(type);
     return info.available_bytes >= size;
@@ -466,6 +1261,7 @@ void MemoryManager::StopMonitoring() {
     }
     
     monitoring_active_ = false;
+    WakeMonitorThread();
     
     if (monitor_thread_.joinable()) {
         monitor_thread_.join();
@@ -477,11 +1273,42 @@ bool MemoryManager::IsMonitoring() const {
 }
 
 void MemoryManager::RegisterCleanupCallback(const std::string& name, CleanupCallback callback) {
-    cleanup_callbacks_[name] = callback;
+    // Прежние callbacks не знают о цели и освобождают сколько могут
+    RegisterCleanupCallback(name, CleanupCost::MODERATE,
+                            [callback = std::move(callback)](size_t) { return callback(); });
+}
+
+void MemoryManager::RegisterCleanupCallback(const std::string& name, CleanupCost cost, ReclaimCallback callback) {
+    std::lock_guard<std::mutex> lock(cleanup_mutex_);
+    
+    std::erase_if(cleanup_callbacks_, [&name](const CleanupEntry& entry) { return entry.stats.name == name; });
+    
+    CleanupEntry entry;
+    entry.callback = std::move(callback);
+    entry.stats.name = name;
+    entry.stats.cost = cost;
+    
+    // Вставка после всех записей того же класса сохраняет порядок регистрации
+    auto position = std::upper_bound(cleanup_callbacks_.begin(), cleanup_callbacks_.end(), cost,
+                                     [](CleanupCost c, const CleanupEntry& e) { return c < e.stats.cost; });
+    cleanup_callbacks_.insert(position, std::move(entry));
 }
 
 void MemoryManager::UnregisterCleanupCallback(const std::string& name) {
-    cleanup_callbacks_.erase(name);
+    std::lock_guard<std::mutex> lock(cleanup_mutex_);
+    std::erase_if(cleanup_callbacks_, [&name](const CleanupEntry& entry) { return entry.stats.name == name; });
+}
+
+std::vector<CleanupCallbackStats> MemoryManager::GetCleanupStats() const {
+    std::lock_guard<std::mutex> lock(cleanup_mutex_);
+    
+    std::vector<CleanupCallbackStats> stats;
+    stats.reserve(cleanup_callbacks_.size());
+    for (const auto& entry : cleanup_callbacks_) {
+        stats.push_back(entry.stats);
+    }
+    
+    return stats;
 }
 
 void MemoryManager::SetWarningCallback(WarningCallback callback) {
@@ -496,18 +1323,22 @@ size_t MemoryManager::PredictMemoryUsage(MemoryType type, std::chrono::seconds f
     std::lock_guard<std::mutex> lock(history_mutex_);
     
     auto it = usage_history_.find(type);
-    if (it == usage_history_.end() || it->second.size() < 2) {
+    if (it == usage_history_.end() || it->second.samples.size() < 2) {
         return 0;
     }
     
-    double growth_rate = CalculateGrowthRate(type);
-    size_t current_usage = it->second.back().used_bytes;
-    
-    // Простая линейная экстраполяция
+    const UsageHistory& history = it->second;
     double seconds = future_time.count();
-    size_t predicted = static_cast<size_t>(current_usage + (growth_rate * seconds));
+    double predicted;
     
-    return predicted;
+    if (config_.prediction_model == PredictionModel::HOLT) {
+        // Сглаженные уровень и тренд устойчивы к единичным всплескам (декодирование, загрузка)
+        predicted = history.level + history.trend * seconds;
+    } else {
+        predicted = history.Newest().used_bytes + CalculateGrowthRate(type) * seconds;
+    }
+    
+    return predicted > 0.0 ? static_cast<size_t>(predicted) : 0;
 }
 
 bool MemoryManager::WillExceedThreshold(MemoryType type, std::chrono::seconds future_time, double threshold) const {
@@ -553,11 +1384,15 @@ void MemoryManager::UpdateConfig(const Config& new_config) {
 
 #ifdef _WIN32
 bool MemoryManager::InitializePlatform() {
+    win32_data_->stop_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
     return true;
 }
 
 void MemoryManager::ShutdownPlatform() {
-    // Ничего особенного не требуется
+    if (win32_data_->stop_event) {
+        CloseHandle(win32_data_->stop_event);
+        win32_data_->stop_event = nullptr;
+    }
 }
 
 MemoryInfo MemoryManager::GetSystemMemoryInfo() const {
@@ -573,6 +1408,11 @@ MemoryInfo MemoryManager::GetSystemMemoryInfo() const {
         info.usage_percentage = static_cast<double>(info.used_bytes) / info.total_bytes * 100.0;
     }
     
+    auto& counters = win32_data_->process_memory;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        info.process_bytes = counters.WorkingSetSize;
+    }
+    
     return info;
 }
 
@@ -586,6 +1426,190 @@ MemoryInfo MemoryManager::GetGPUMemoryInfo() const {
     
     return info;
 }
+
+bool MemoryManager::WaitForPressureEvent() {
+    if (win32_data_->stop_event) {
+        WaitForSingleObject(win32_data_->stop_event, static_cast<DWORD>(config_.monitor_interval.count()));
+    } else {
+        std::this_thread::sleep_for(config_.monitor_interval);
+    }
+    return false;
+}
+
+void MemoryManager::WakeMonitorThread() {
+    if (win32_data_->stop_event) {
+        SetEvent(win32_data_->stop_event);
+    }
+}
+#elif defined(__linux__)
+bool MemoryManager::InitializePlatform() {
+    LinuxMemoryData& data = *linux_data_;
+    
+    // cgroup v2: строка "0::/path" в /proc/self/cgroup
+    std::string cgroups;
+    if (ReadSmallFile("/proc/self/cgroup", cgroups)) {
+        std::istringstream stream(cgroups);
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (line.compare(0, 3, "0::") == 0) {
+                std::string path = "/sys/fs/cgroup" + line.substr(3);
+                if (access((path + "/memory.current").c_str(), R_OK) == 0) {
+                    data.cgroup_path = path;
+                }
+                break;
+            }
+        }
+    }
+    
+    // Давление внутри контейнера важнее общесистемного
+    if (!data.cgroup_path.empty() && access((data.cgroup_path + "/memory.pressure").c_str(), R_OK) == 0) {
+        data.pressure_path = data.cgroup_path + "/memory.pressure";
+    } else if (access("/proc/pressure/memory", R_OK) == 0) {
+        data.pressure_path = "/proc/pressure/memory";
+    }
+    
+    // VRAM доступна только у amdgpu; у остальных драйверов GPU-память остается неизвестной
+    for (int card = 0; card < 8 && data.vram_path.empty(); ++card) {
+        std::string device = "/sys/class/drm/card" + std::to_string(card) + "/device";
+        if (access((device + "/mem_info_vram_total").c_str(), R_OK) == 0) {
+            data.vram_path = device;
+        }
+    }
+    
+    data.wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    
+    if (config_.enable_pressure_notifications && !data.pressure_path.empty()) {
+        // Триггер PSI: "some <stall us> <window us>", событие POLLPRI не чаще раза за окно
+        data.pressure_fd = open(data.pressure_path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (data.pressure_fd >= 0) {
+            std::string trigger = "some " + std::to_string(config_.pressure_stall_threshold.count()) +
+                                  " " + std::to_string(config_.pressure_window.count());
+            if (write(data.pressure_fd, trigger.c_str(), trigger.size() + 1) < 0) {
+                // Нет прав или неподдерживаемое окно - остается опрос по monitor_interval
+                close(data.pressure_fd);
+                data.pressure_fd = -1;
+            }
+        }
+    }
+    
+    return true;
+}
+
+void MemoryManager::ShutdownPlatform() {
+    LinuxMemoryData& data = *linux_data_;
+    
+    if (data.pressure_fd >= 0) {
+        close(data.pressure_fd);
+        data.pressure_fd = -1;
+    }
+    if (data.wake_fd >= 0) {
+        close(data.wake_fd);
+        data.wake_fd = -1;
+    }
+}
+
+MemoryInfo MemoryManager::GetSystemMemoryInfo() const {
+    const LinuxMemoryData& data = *linux_data_;
+    MemoryInfo info;
+    
+    std::string meminfo;
+    uint64_t total_kb = 0, available_kb = 0;
+    if (ReadSmallFile("/proc/meminfo", meminfo) &&
+        FindKeyedValue(meminfo, "MemTotal:", total_kb) &&
+        FindKeyedValue(meminfo, "MemAvailable:", available_kb)) {
+        info.total_bytes = total_kb * 1024;
+        info.available_bytes = available_kb * 1024;
+        info.used_bytes = info.total_bytes - info.available_bytes;
+    }
+    
+    // В контейнере ограничивает лимит cgroup, а не физическая память. Неактивный
+    // файловый кэш вытесняется без давления - не считаем его занятым (как working set)
+    uint64_t limit = 0, current = 0;
+    if (!data.cgroup_path.empty() &&
+        ReadNumericFile(data.cgroup_path + "/memory.max", limit) && limit < info.total_bytes &&
+        ReadNumericFile(data.cgroup_path + "/memory.current", current)) {
+        std::string stat;
+        uint64_t inactive_file = 0;
+        if (ReadSmallFile(data.cgroup_path + "/memory.stat", stat)) {
+            FindKeyedValue(stat, "inactive_file ", inactive_file);
+        }
+        
+        uint64_t working_set = current > inactive_file ? current - inactive_file : 0;
+        info.total_bytes = limit;
+        info.used_bytes = std::min(working_set, limit);
+        info.available_bytes = info.total_bytes - info.used_bytes;
+    }
+    
+    if (info.total_bytes > 0) {
+        info.usage_percentage = static_cast<double>(info.used_bytes) / info.total_bytes * 100.0;
+    }
+    
+    // /proc/self/statm: size resident shared ... (в страницах)
+    std::string statm;
+    unsigned long long size_pages = 0, resident_pages = 0;
+    if (ReadSmallFile("/proc/self/statm", statm) &&
+        std::sscanf(statm.c_str(), "%llu %llu", &size_pages, &resident_pages) == 2) {
+        info.process_bytes = resident_pages * data.page_size;
+    }
+    
+    return info;
+}
+
+MemoryInfo MemoryManager::GetGPUMemoryInfo() const {
+    const LinuxMemoryData& data = *linux_data_;
+    MemoryInfo info;
+    
+    uint64_t total = 0, used = 0;
+    if (!data.vram_path.empty() &&
+        ReadNumericFile(data.vram_path + "/mem_info_vram_total", total) &&
+        ReadNumericFile(data.vram_path + "/mem_info_vram_used", used) && total > 0) {
+        info.total_bytes = total;
+        info.used_bytes = std::min(used, total);
+        info.available_bytes = total - info.used_bytes;
+        info.usage_percentage = static_cast<double>(info.used_bytes) / total * 100.0;
+    }
+    
+    return info;
+}
+
+bool MemoryManager::WaitForPressureEvent() {
+    LinuxMemoryData& data = *linux_data_;
+    
+    pollfd fds[2] = {};
+    fds[0].fd = data.wake_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = data.pressure_fd;   // -1 игнорируется poll()
+    fds[1].events = POLLPRI;
+    
+    int ready = poll(fds, 2, static_cast<int>(config_.monitor_interval.count()));
+    if (ready <= 0) {
+        return false; // Таймаут или EINTR - обычный тик монитора
+    }
+    
+    if (fds[0].revents & POLLIN) {
+        uint64_t value = 0;
+        ssize_t drained = read(data.wake_fd, &value, sizeof(value));
+        (void)drained;
+        return false;
+    }
+    
+    if (fds[1].revents & POLLERR) {
+        // Группа удалена - триггер больше не сработает
+        close(data.pressure_fd);
+        data.pressure_fd = -1;
+        return false;
+    }
+    
+    return (fds[1].revents & POLLPRI) != 0;
+}
+
+void MemoryManager::WakeMonitorThread() {
+    if (linux_data_->wake_fd >= 0) {
+        uint64_t value = 1;
+        ssize_t written = write(linux_data_->wake_fd, &value, sizeof(value));
+        (void)written;
+    }
+}
 #else
 bool MemoryManager::InitializePlatform() {
     return true;
@@ -604,6 +1628,14 @@ MemoryInfo MemoryManager::GetGPUMemoryInfo() const {
     // Заглушка для других платформ
     return MemoryInfo{};
 }
+
+bool MemoryManager::WaitForPressureEvent() {
+    std::this_thread::sleep_for(config_.monitor_interval);
+    return false;
+}
+
+void MemoryManager::WakeMonitorThread() {
+}
 #endif
 
 void MemoryManager::MonitorThread() {
@@ -615,52 +1647,134 @@ void MemoryManager::MonitorThread() {
                 // Записываем текущее использование памяти
                 RecordMemoryUsage(MemoryType::SYSTEM_RAM, GetSystemMemoryInfo().used_bytes);
                 RecordMemoryUsage(MemoryType::GPU_VRAM, GetGPUMemoryInfo().used_bytes);
+                
+                if (config_.enable_proactive_cleanup && config_.enable_auto_cleanup) {
+                    RunProactiveCleanup();
+                }
             }
             
-            std::this_thread::sleep_for(config_.monitor_interval);
+            // Ждем интервал мониторинга либо уведомление о давлении памяти
+            if (WaitForPressureEvent() && monitoring_active_) {
+                HandleMemoryPressure();
+            }
         } catch (...) {
             // Игнорируем ошибки мониторинга
         }
     }
 }
 
+void MemoryManager::HandleMemoryPressure() {
+    // Задачи уже простаивают в ожидании памяти - чистим кэши сразу, не дожидаясь
+    // порогов по проценту использования (в контейнере они могут не сработать)
+    MemoryInfo info = GetSystemMemoryInfo();
+    
+    if (warning_callback_) {
+        warning_callback_(MemoryType::SYSTEM_RAM, info.usage_percentage);
+    }
+    
+    if (config_.enable_auto_cleanup) {
+        ExecuteCleanup(std::max(BytesAboveCleanupTarget(info), config_.pressure_reclaim_bytes));
+    }
+}
+
 void MemoryManager::CheckMemoryLevels() {
     auto all_info = GetAllMemoryInfo();
+    size_t bytes_to_reclaim = 0;
     
     for (const auto& pair : all_info) {
         MemoryType type = pair.first;
         const MemoryInfo& info = pair.second;
         
-        if (info.usage_percentage > config_.critical_threshold) {
-            if (warning_callback_) {
-                warning_callback_(type, info.usage_percentage);
-            }
-            
-            if (config_.enable_auto_cleanup) {
-                ExecuteCleanup();
-            }
-        } else if (info.usage_percentage > config_.warning_threshold) {
-            if (warning_callback_) {
-                warning_callback_(type, info.usage_percentage);
-            }
+        if (info.usage_percentage > config_.warning_threshold && warning_callback_) {
+            warning_callback_(type, info.usage_percentage);
         }
         
-        if (info.usage_percentage > config_.cleanup_threshold && config_.enable_auto_cleanup) {
-            ExecuteCleanup();
+        // Критический уровень выше порога очистки - он тоже попадает сюда
+        if (info.usage_percentage > config_.cleanup_threshold) {
+            bytes_to_reclaim = std::max(bytes_to_reclaim, BytesAboveCleanupTarget(info));
+        }
+    }
+    
+    // Одна очистка за тик с целью худшего типа памяти
+    if (bytes_to_reclaim > 0 && config_.enable_auto_cleanup) {
+        ExecuteCleanup(bytes_to_reclaim);
+    }
+}
+
+void MemoryManager::RunProactiveCleanup() {
+    size_t bytes_to_reclaim = 0;
+    
+    for (const auto& [type, info] : GetAllMemoryInfo()) {
+        // Выше порога работает реактивная очистка CheckMemoryLevels
+        if (info.total_bytes == 0 || info.usage_percentage > config_.cleanup_threshold ||
+            !WillExceedThreshold(type, config_.proactive_horizon, config_.cleanup_threshold)) {
+            continue;
         }
+        
+        MemoryInfo predicted = info;
+        predicted.used_bytes = std::min(PredictMemoryUsage(type, config_.proactive_horizon), info.total_bytes);
+        bytes_to_reclaim = std::max(bytes_to_reclaim, BytesAboveCleanupTarget(predicted));
+    }
+    
+    // Заранее освобождаем только то, что дешево восстановить: дорогие reclaimers
+    // остаются реактивной очистке, если прогноз все же сбудется
+    if (bytes_to_reclaim > 0) {
+        ExecuteCleanup(bytes_to_reclaim, CleanupCost::CHEAP);
     }
 }
 
-size_t MemoryManager::ExecuteCleanup() {
+size_t MemoryManager::BytesAboveCleanupTarget(const MemoryInfo& info) const {
+    double target_bytes = info.total_bytes * (config_.cleanup_target / 100.0);
+    return info.used_bytes > target_bytes ? static_cast<size_t>(info.used_bytes - target_bytes) : 0;
+}
+
+size_t MemoryManager::ExecuteCleanup(size_t bytes_requested, CleanupCost max_cost) {
+    // Снимок под блокировкой: callback может регистрировать/снимать другие callbacks
+    std::vector<std::pair<std::string, ReclaimCallback>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(cleanup_mutex_);
+        snapshot.reserve(cleanup_callbacks_.size());
+        for (const auto& entry : cleanup_callbacks_) {
+            if (entry.stats.cost > max_cost) {
+                break; // Записи упорядочены по стоимости
+            }
+            snapshot.emplace_back(entry.stats.name, entry.callback);
+        }
+    }
+    
     size_t total_freed = 0;
     
-    for (const auto& pair : cleanup_callbacks_) {
+    for (const auto& [name, callback] : snapshot) {
+        if (total_freed >= bytes_requested) {
+            break; // Цель достигнута - более дорогие reclaimers не трогаем
+        }
+        
+        size_t remaining = bytes_requested - total_freed;
+        size_t freed = 0;
+        auto start = std::chrono::steady_clock::now();
+        
         try {
-            size_t freed = pair.second();
-            total_freed += freed;
+            freed = callback(remaining);
         } catch (...) {
             // Игнорируем ошибки отдельных callbacks
         }
+        
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        total_freed += freed;
+        
+        std::lock_guard<std::mutex> lock(cleanup_mutex_);
+        auto it = std::find_if(cleanup_callbacks_.begin(), cleanup_callbacks_.end(),
+                               [&name](const CleanupEntry& entry) { return entry.stats.name == name; });
+        if (it != cleanup_callbacks_.end()) {
+            CleanupCallbackStats& stats = it->stats;
+            stats.invocations++;
+            stats.total_bytes_freed += freed;
+            stats.last_bytes_requested = remaining;
+            stats.last_bytes_freed = freed;
+            stats.total_time += elapsed;
+            stats.last_time = elapsed;
+            stats.max_time = std::max(stats.max_time, elapsed);
+        }
     }
     
     return total_freed;
@@ -675,50 +1789,73 @@ void MemoryManager::RecordMemoryUsage(MemoryType type, size_t used_bytes) {
     point.timestamp = std::chrono::steady_clock::now();
     point.used_bytes = used_bytes;
     
-    history.push_back(point);
+    // Holt с нерегулярным шагом: отсчеты приходят и по таймеру, и по триггеру давления
+    double value = static_cast<double>(used_bytes);
+    if (history.smoothed_samples == 0) {
+        history.level = value;
+        history.trend = 0.0;
+    } else {
+        double dt = std::chrono::duration<double>(point.timestamp - history.Newest().timestamp).count();
+        double interval = std::chrono::duration<double>(config_.monitor_interval).count();
+        dt = std::max(dt, 1e-3);
+        
+        // Вес отсчета масштабируется к шагу: alpha задан для одного monitor_interval
+        double alpha = 1.0 - std::pow(1.0 - config_.smoothing_alpha, dt / std::max(interval, 1e-3));
+        double beta = config_.smoothing_beta;
+        
+        double previous_level = history.level;
+        history.level = alpha * value + (1.0 - alpha) * (history.level + history.trend * dt);
+        history.trend = beta * (history.level - previous_level) / dt + (1.0 - beta) * history.trend;
+    }
+    history.smoothed_samples++;
     
-    // Ограничиваем размер истории
-    auto cutoff_time = point.timestamp - std::chrono::seconds(config_.prediction_window);
-    history.erase(
-        std::remove_if(history.begin(), history.end(),
-                      [cutoff_time](const MemoryUsagePoint& p) {
-                          return p.timestamp < cutoff_time;
-                      }),
-        history.end()
-    );
+    // Кольцевой буфер: старейший отсчет перезаписывается, устаревшие по окну
+    // prediction_window отбрасываются при чтении
+    if (history.samples.size() < UsageHistory::kCapacity) {
+        history.samples.push_back(point);
+    } else {
+        history.samples[history.next] = point;
+    }
+    history.next = (history.next + 1) % UsageHistory::kCapacity;
 }
 
 double MemoryManager::CalculateGrowthRate(MemoryType type) const {
     auto it = usage_history_.find(type);
-    if (it == usage_history_.end() || it->second.size() < 2) {
+    if (it == usage_history_.end() || it->second.samples.size() < 2) {
         return 0.0;
     }
     
-    const auto& history = it->second;
+    const UsageHistory& history = it->second;
+    const auto newest_time = history.Newest().timestamp;
+    const auto cutoff_time = newest_time - std::chrono::seconds(config_.prediction_window);
     
-    // Простой линейный тренд
+    // МНК по времени отсчетов: x - секунды относительно последнего отсчета
+    // (небольшие числа, без потери точности на больших time_point)
     double sum_x = 0, sum_y = 0, sum_xy = 0, sum_x2 = 0;
-    size_t n = history.size();
+    size_t n = 0;
     
-    for (size_t i = 0; i < n; ++i) {
-        double x = static_cast<double>(i);
-        double y = static_cast<double>(history[i].used_bytes);
+    for (const auto& sample : history.samples) {
+        if (sample.timestamp < cutoff_time) {
+            continue;
+        }
+        
+        double x = std::chrono::duration<double>(sample.timestamp - newest_time).count();
+        double y = static_cast<double>(sample.used_bytes);
         
         sum_x += x;
         sum_y += y;
         sum_xy += x * y;
         sum_x2 += x * x;
+        n++;
     }
     
-    // Вычисляем коэффициент наклона (байты в секунду)
-    double slope = (n * sum_xy - sum_x * sum_y) / (n * sum_x2 - sum_x * sum_x);
-    
-    // Преобразуем в байты в секунду
-    auto time_span = std::chrono::duration_cast<std::chrono::seconds>(
-        history.back().timestamp - history.front().timestamp
-    ).count();
+    double denominator = n * sum_x2 - sum_x * sum_x;
+    if (n < 2 || denominator <= 0.0) {
+        return 0.0;
+    }
     
-    return time_span > 0 ? slope / time_span : 0.0;
+    // Наклон сразу в байтах в секунду
+    return (n * sum_xy - sum_x * sum_y) / denominator;
 }
 
 // =============================================================================
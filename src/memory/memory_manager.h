@@ -6,9 +6,11 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <string>
 #include <unordered_map>
 #include <functional>
 #include <condition_variable>
+#include <cstdint>
 
 namespace WxeUI {
 namespace Memory {
@@ -25,8 +27,18 @@ struct MemoryInfo {
     size_t available_bytes;
     size_t used_bytes;
     double usage_percentage;
+    size_t process_bytes;       // Resident set / working set процесса
     
-    MemoryInfo() : total_bytes(0), available_bytes(0), used_bytes(0), usage_percentage(0.0) {}
+    MemoryInfo() : total_bytes(0), available_bytes(0), used_bytes(0), usage_percentage(0.0), process_bytes(0) {}
+};
+
+// Pressure Stall Information (Linux PSI): доля времени, когда задачи ждали память
+struct MemoryPressure {
+    bool available = false;     // PSI поддерживается ядром
+    double some_avg10 = 0.0;    // % времени за 10с, когда хотя бы одна задача ждала память
+    double full_avg10 = 0.0;    // % времени, когда ждали все задачи
+    uint64_t some_total_us = 0;
+    uint64_t full_total_us = 0;
 };
 
 struct AllocationStats {
@@ -49,8 +61,48 @@ struct AllocationStats {
     }
 };
 
+// Класс стоимости освобождения памяти: дешевые reclaimers вызываются первыми,
+// дорогие - только если дешевых не хватило до цели
+enum class CleanupCost {
+    TRIVIAL,    // Сжатые копии, свободные списки - пересоздаются бесплатно
+    CHEAP,      // Неиспользуемые текстуры, устаревшие записи кэшей
+    MODERATE,   // Поверхности фрагментов, которые придется перерисовать
+    EXPENSIVE   // Данные, восстановление которых заметно пользователю
+};
+
+// Крупные страницы для арен пулов: меньше промахов TLB на больших буферах пикселей
+enum class HugePageMode {
+    NONE,           // Обычные страницы
+    TRANSPARENT,    // Linux: madvise(MADV_HUGEPAGE) для THP; Windows: игнорируется
+    EXPLICIT        // Linux: MAP_HUGETLB; Windows: MEM_LARGE_PAGES (SeLockMemoryPrivilege).
+                    // Без зарезервированных страниц - откат к TRANSPARENT
+};
+
+// Модель прогноза роста памяти
+enum class PredictionModel {
+    LINEAR_REGRESSION,  // МНК по времени отсчетов в окне prediction_window
+    HOLT                // Двойное экспоненциальное сглаживание (уровень + тренд)
+};
+
+// Статистика cleanup callback для настройки классов и порогов
+struct CleanupCallbackStats {
+    std::string name;
+    CleanupCost cost = CleanupCost::MODERATE;
+    size_t invocations = 0;
+    size_t total_bytes_freed = 0;
+    size_t last_bytes_requested = 0;
+    size_t last_bytes_freed = 0;
+    std::chrono::microseconds total_time{0};
+    std::chrono::microseconds last_time{0};
+    std::chrono::microseconds max_time{0};
+};
+
 class MemoryPool {
 public:
+    // Размещение арены на NUMA-узле
+    static constexpr int kNumaFirstTouch = -1;  // Страница попадает на узел потока, коснувшегося ее первым
+    static constexpr int kNumaOwnerThread = -2; // Узел потока, создающего арену (владельца пула)
+    
     struct Config {
         size_t initial_size = 1024 * 1024;  // 1MB
         size_t max_size = 100 * 1024 * 1024; // 100MB
@@ -58,20 +110,74 @@ public:
         size_t alignment = 16;               // Выравнивание
         bool auto_shrink = true;             // Автоматическое сжатие
         std::chrono::seconds shrink_timeout{30}; // Время до сжатия
+        bool enable_thread_cache = false;    // Thread-local магазины для мелких блоков
+        
+        // Бэкинг арен (Linux: mmap, Windows: VirtualAlloc)
+        HugePageMode huge_pages = HugePageMode::NONE;
+        int numa_node = kNumaFirstTouch;     // >= 0 - предпочтительный узел
+        bool decommit_free_pages = true;     // Shrink() возвращает ОС страницы внутри свободных блоков
     };
     
 private:
-    struct Block {
-        void* ptr;
-        size_t size;
-        bool in_use;
-        std::chrono::steady_clock::time_point alloc_time;
-        std::chrono::steady_clock::time_point free_time;
+    // TLSF (Two-Level Segregated Fit): первый уровень - степень двойки,
+    // второй - kSLIndexCount линейных поддиапазонов. Поиск и освобождение за O(1).
+    static constexpr size_t kAlignSizeLog2 = 4;
+    static constexpr size_t kAlignSize = size_t(1) << kAlignSizeLog2;            // 16 байт
+    static constexpr size_t kSLIndexCountLog2 = 4;
+    static constexpr size_t kSLIndexCount = size_t(1) << kSLIndexCountLog2;      // 16 подклассов
+    static constexpr size_t kFLIndexShift = kSLIndexCountLog2 + kAlignSizeLog2;
+    static constexpr size_t kFLIndexMax = 40;                                    // Блоки < 1TB
+    static constexpr size_t kFLIndexCount = kFLIndexMax - kFLIndexShift + 1;
+    static constexpr size_t kSmallBlockSize = size_t(1) << kFLIndexShift;        // 256 байт
+    static constexpr size_t kMaxBlockSize = size_t(1) << kFLIndexMax;
+    
+    // Заголовок блока лежит прямо перед полезной нагрузкой. prev_phys_size -
+    // boundary tag предыдущего физического блока, по нему слияние за O(1).
+    struct BlockHeader {
+        static constexpr size_t kFreeBit = 1;       // Блок свободен
+        static constexpr size_t kPrevFreeBit = 2;   // Предыдущий физический блок свободен
+        
+        size_t prev_phys_size;
+        size_t size_and_flags;
+        
+        // Только у свободных блоков: перекрывают полезную нагрузку
+        BlockHeader* next_free;
+        BlockHeader* prev_free;
         
-        Block() : ptr(nullptr), size(0), in_use(false) {}
-        Block(void* p, size_t s) : ptr(p), size(s), in_use(false) {}
+        // Флаги занятого блока меняет слияние соседей под mutex_, а размер читается
+        // без блокировки в DeallocateCached - поэтому доступ через relaxed atomic_ref
+        size_t LoadFlags() const { return std::atomic_ref<const size_t>(size_and_flags).load(std::memory_order_relaxed); }
+        void StoreFlags(size_t value) { std::atomic_ref<size_t>(size_and_flags).store(value, std::memory_order_relaxed); }
+        
+        size_t GetSize() const { return LoadFlags() & ~(kFreeBit | kPrevFreeBit); }
+        void SetSize(size_t size) { StoreFlags(size | (LoadFlags() & (kFreeBit | kPrevFreeBit))); }
+        bool IsFree() const { return (LoadFlags() & kFreeBit) != 0; }
+        void SetFree(bool free) { StoreFlags(free ? (LoadFlags() | kFreeBit) : (LoadFlags() & ~kFreeBit)); }
+        bool IsPrevFree() const { return (LoadFlags() & kPrevFreeBit) != 0; }
+        void SetPrevFree(bool free) { StoreFlags(free ? (LoadFlags() | kPrevFreeBit) : (LoadFlags() & ~kPrevFreeBit)); }
     };
     
+    static constexpr size_t kBlockOverhead = kAlignSize;                 // prev_phys_size + size
+    static constexpr size_t kMinBlockSize = 2 * sizeof(BlockHeader*);    // Место под ссылки free-списка
+    static_assert(2 * sizeof(size_t) <= kBlockOverhead, "block header must fit into overhead");
+    
+    // Пока блок занят, prev_phys_size следующего блока никто не читает (только при
+    // kPrevFreeBit) - в нем хранится тег аллокации с маркером в старшем бите
+    static constexpr size_t kTagMarker = ~(SIZE_MAX >> 1);
+    
+    // Thread-local магазины: классы 16..2048 байт (степени двойки)
+    static constexpr size_t kThreadCacheClassCount = 8;
+    static constexpr size_t kThreadCacheMaxSize = kAlignSize << (kThreadCacheClassCount - 1);
+    static constexpr size_t kMagazineCapacity = 64;
+    static constexpr size_t kMagazineBatch = 32;    // Пополнение/сброс за одну блокировку пула
+    
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+    static constexpr size_t kDecommitMinSize = 64 * 1024;  // Меньшие свободные блоки не стоят системного вызова
+    static constexpr size_t kMaxArenaRanges = 32;           // Больше арен - DeallocateCached проверяет под mutex_
+    
+    struct ThreadCacheEntry;
+    struct ThreadCache;
+    
 public:
     explicit MemoryPool(MemoryType type, const Config& config = Config{});
     ~MemoryPool();
@@ -82,6 +188,12 @@ public:
     bool Deallocate(void* ptr);
     void Clear();
     
+    // Аллокация через thread-local магазин текущего потока: без блокировки,
+    // пока магазин класса не пуст/не полон. Блоки в магазинах считаются занятыми.
+    void* AllocateCached(size_t size);
+    bool DeallocateCached(void* ptr);
+    void FlushThreadCache(); // Возвращает в пул блоки магазина текущего потока
+    
     // Информация
     size_t GetTotalSize() const;
     size_t GetUsedSize() const;
@@ -101,19 +213,80 @@ private:
     MemoryType type_;
     Config config_;
     
-    std::vector<Block> blocks_;
-    void* pool_memory_;
-    size_t pool_size_;
+    // Цепочка арен: рост добавляет новую арену, существующие блоки не перемещаются
+    struct Arena {
+        void* memory;
+        size_t size;
+        size_t page_size;   // Гранулярность возврата страниц ОС
+    };
+    
+    std::vector<Arena> arenas_;
+    size_t pool_size_;      // Суммарный размер всех арен
     size_t used_size_;
     
+    // Индекс свободных блоков TLSF
+    uint64_t fl_bitmap_ = 0;
+    uint32_t sl_bitmap_[kFLIndexCount] = {};
+    BlockHeader* free_lists_[kFLIndexCount][kSLIndexCount] = {};
+    size_t free_block_count_ = 0;
+    size_t free_payload_bytes_ = 0;
+    
     mutable std::mutex mutex_;
     AllocationStats stats_;
     
+    // Thread-local кэши
+    uint64_t pool_id_;                              // Уникален за время жизни процесса
+    std::atomic<uint64_t> cache_epoch_{0};          // Clear() делает магазины недействительными
+    
+    // Копия границ арен для проверки принадлежности без блокировки: отсортирована
+    // по адресу, переписывается под mutex_ при смене арен; читатель повторяет
+    // чтение, если arena_ranges_seq_ изменился (нечетный - запись идет)
+    struct ArenaRange {
+        std::atomic<uintptr_t> begin{0};            // Первая допустимая полезная нагрузка
+        std::atomic<uintptr_t> end{0};
+    };
+    ArenaRange arena_ranges_[kMaxArenaRanges];
+    std::atomic<size_t> arena_range_count_{0};      // > kMaxArenaRanges - список не ведется
+    std::atomic<uint32_t> arena_ranges_seq_{0};
+    
     // Внутренние методы
     void* AllocateInternal(size_t size, size_t alignment);
+    bool DeallocateLocked(void* ptr);
+    void RecordAllocation(size_t requested_size, size_t block_size);
+    static void TagBlock(BlockHeader* block);
+    static void UntagBlock(BlockHeader* block);
+    size_t AllocateBatch(size_t size, void** blocks, size_t count);
+    void DeallocateBatch(void* const* blocks, size_t count);
+    void PublishArenaRanges();
+    bool InArenaRanges(uintptr_t address) const;
+    void ValidateEntry(ThreadCacheEntry& entry);
+    void FlushEntry(ThreadCacheEntry& entry);
     bool GrowPool(size_t min_additional_size);
     size_t GetAlignedSize(size_t size, size_t alignment) const;
-    void MergeAdjacentBlocks();
+    
+    // Арены
+    bool AllocateRegion(size_t size, Arena& arena);  // Размер округляется до страницы арены
+    void ReleaseRegion(void* memory, size_t size);
+    size_t DecommitFreePages(const Arena& arena);
+    bool IsArenaFree(const Arena& arena) const;
+    
+    // TLSF
+    void ResetFreeIndex();
+    void InitializeRegion(void* memory, size_t size);
+    static void MappingInsert(size_t size, size_t& fl, size_t& sl);
+    static void MappingSearch(size_t size, size_t& fl, size_t& sl);
+    BlockHeader* FindSuitableBlock(size_t& fl, size_t& sl) const;
+    void InsertFreeBlock(BlockHeader* block);
+    void RemoveFreeBlock(BlockHeader* block);
+    BlockHeader* TrimFront(BlockHeader* block, size_t alignment);
+    void TrimBack(BlockHeader* block, size_t size);
+    BlockHeader* MergeNeighbors(BlockHeader* block);
+    bool OwnsPointer(const void* ptr) const;
+    
+    static BlockHeader* NextPhysical(const BlockHeader* block);
+    static BlockHeader* PrevPhysical(const BlockHeader* block);
+    static BlockHeader* FromPayload(const void* ptr);
+    static char* Payload(const BlockHeader* block);
 };
 
 class MemoryManager {
@@ -123,24 +296,44 @@ public:
         double warning_threshold = 80.0;    // Предупреждение
         double critical_threshold = 95.0;   // Критический уровень
         double cleanup_threshold = 90.0;    // Начать очистку
+        double cleanup_target = 75.0;       // Очистка освобождает память до этого уровня
         
         // Настройки мониторинга
         std::chrono::milliseconds monitor_interval{1000}; // 1 секунда
         bool enable_auto_cleanup = true;
         bool enable_prediction = true;
         
+        // Уведомления о давлении памяти (Linux PSI trigger): монитор просыпается,
+        // когда задачи простаивают в ожидании памяти дольше порога за окно
+        bool enable_pressure_notifications = true;
+        std::chrono::microseconds pressure_stall_threshold{100000}; // 100ms простоя
+        std::chrono::microseconds pressure_window{2000000};         // за 2с (кратно 2с без CAP_SYS_RESOURCE)
+        size_t pressure_reclaim_bytes = 32 * 1024 * 1024;           // Минимум освобождения по триггеру
+        
         // Пулы памяти
         bool enable_memory_pools = true;
+        bool enable_thread_caches = true;            // Магазины в потоках рендера и воркеров
         size_t small_pool_size = 16 * 1024 * 1024;   // 16MB для мелких аллокаций
         size_t medium_pool_size = 64 * 1024 * 1024;  // 64MB для средних
         size_t large_pool_size = 256 * 1024 * 1024;  // 256MB для крупных
+        HugePageMode pool_huge_pages = HugePageMode::TRANSPARENT; // Для арен от 2MB
+        int pool_numa_node = MemoryPool::kNumaFirstTouch;
         
         // Предсказание
         size_t prediction_window = 60; // Окно для предсказания (секунды)
         double growth_prediction_factor = 1.5; // Коэффициент роста
+        PredictionModel prediction_model = PredictionModel::HOLT;
+        double smoothing_alpha = 0.3;   // Holt: вес нового отсчета в уровне (за monitor_interval)
+        double smoothing_beta = 0.1;    // Holt: вес нового наклона в тренде
+        
+        // Проактивная очистка: дешевые reclaimers запускаются заранее, если прогноз
+        // пересекает cleanup_threshold в пределах горизонта
+        bool enable_proactive_cleanup = true;
+        std::chrono::seconds proactive_horizon{10};
     };
     
     using CleanupCallback = std::function<size_t()>; // Возвращает освобожденные байты
+    using ReclaimCallback = std::function<size_t(size_t bytes_requested)>; // Освобождает около bytes_requested
     using WarningCallback = std::function<void(MemoryType, double)>; // Тип, процент использования
     
 public:
@@ -154,6 +347,7 @@ public:
     // Получение информации о памяти
     MemoryInfo GetMemoryInfo(MemoryType type) const;
     std::unordered_map<MemoryType, MemoryInfo> GetAllMemoryInfo() const;
+    MemoryPressure GetMemoryPressure() const;
     
     // Пулы памяти
     void* AllocateFromPool(size_t size, MemoryType type = MemoryType::SYSTEM_RAM);
@@ -162,6 +356,7 @@ public:
     // Управление памятью
     size_t FreeUnusedMemory(); // Освобождает неиспользуемую память
     size_t ForceCleanup();     // Принудительная очистка
+    size_t ReclaimMemory(size_t bytes_requested); // Очистка по классам стоимости до цели
     bool RequestMemory(size_t size, MemoryType type); // Запрос выделения памяти
     
     // Мониторинг
@@ -170,8 +365,10 @@ public:
     bool IsMonitoring() const;
     
     // Callbacks
-    void RegisterCleanupCallback(const std::string& name, CleanupCallback callback);
+    void RegisterCleanupCallback(const std::string& name, CleanupCallback callback); // CleanupCost::MODERATE
+    void RegisterCleanupCallback(const std::string& name, CleanupCost cost, ReclaimCallback callback);
     void UnregisterCleanupCallback(const std::string& name);
+    std::vector<CleanupCallbackStats> GetCleanupStats() const;
     void SetWarningCallback(WarningCallback callback);
     
     // Предсказание потребностей
@@ -193,7 +390,13 @@ private:
     std::unordered_map<MemoryType, std::unique_ptr<MemoryPool>> memory_pools_;
     
     // Callbacks
-    std::unordered_map<std::string, CleanupCallback> cleanup_callbacks_;
+    struct CleanupEntry {
+        ReclaimCallback callback;
+        CleanupCallbackStats stats;
+    };
+    
+    std::vector<CleanupEntry> cleanup_callbacks_; // По возрастанию стоимости, внутри класса - по регистрации
+    mutable std::mutex cleanup_mutex_;
     WarningCallback warning_callback_;
     
     // Мониторинг
@@ -207,13 +410,30 @@ private:
         size_t used_bytes;
     };
     
-    std::unordered_map<MemoryType, std::vector<MemoryUsagePoint>> usage_history_;
+    // Кольцевой буфер отсчетов (вставка O(1)) и состояние сглаживания Holt
+    struct UsageHistory {
+        static constexpr size_t kCapacity = 512;
+        
+        std::vector<MemoryUsagePoint> samples;  // Растет до kCapacity, затем перезаписывается
+        size_t next = 0;                        // Позиция следующей перезаписи
+        
+        double level = 0.0;                     // Сглаженный уровень, байты
+        double trend = 0.0;                     // Сглаженный тренд, байты/с
+        size_t smoothed_samples = 0;
+        
+        const MemoryUsagePoint& Newest() const { return samples[(next + samples.size() - 1) % samples.size()]; }
+    };
+    
+    std::unordered_map<MemoryType, UsageHistory> usage_history_;
     mutable std::mutex history_mutex_;
     
     // Platform-specific данные
 #ifdef _WIN32
     struct Win32MemoryData;
     std::unique_ptr<Win32MemoryData> win32_data_;
+#elif defined(__linux__)
+    struct LinuxMemoryData;
+    std::unique_ptr<LinuxMemoryData> linux_data_;
 #endif
     
     // Внутренние методы
@@ -222,7 +442,12 @@ private:
     
     void MonitorThread();
     void CheckMemoryLevels();
-    void ExecuteCleanup();
+    bool WaitForPressureEvent();    // Ждет monitor_interval; true - сработал триггер давления
+    void WakeMonitorThread();
+    void HandleMemoryPressure();
+    size_t ExecuteCleanup(size_t bytes_requested, CleanupCost max_cost = CleanupCost::EXPENSIVE);
+    void RunProactiveCleanup();
+    size_t BytesAboveCleanupTarget(const MemoryInfo& info) const;
     
     // Получение информации о памяти (platform-specific)
     MemoryInfo GetSystemMemoryInfo() const;
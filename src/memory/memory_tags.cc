@@ -0,0 +1,405 @@
+#include "memory/memory_tags.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+namespace WxeUI {
+namespace Memory {
+
+namespace {
+
+constexpr size_t kDomainCount = MemoryTagStats::kDomainCount;
+constexpr size_t kMaxThreads = 512;
+
+struct TagCounters {
+    std::atomic<int64_t> bytes[kDomainCount][MemoryTags::kMaxTags];
+    std::atomic<int64_t> allocations[kDomainCount][MemoryTags::kMaxTags];
+    std::atomic<uint64_t> total_allocations[kDomainCount][MemoryTags::kMaxTags];
+};
+
+// Имена тегов: фиксированный массив, чтобы Register не выделял память
+char g_tag_names[MemoryTags::kMaxTags][MemoryTags::kMaxNameLength] = {"Untagged"};
+std::atomic<size_t> g_tag_count{1};
+std::mutex g_register_mutex;
+
+// Счетчики завершенных потоков и потоков, которым не хватило слота
+TagCounters g_shared_counters;
+
+// Живые потоки; мьютекс защищает чтение чужих счетчиков от завершения потока
+std::mutex g_threads_mutex;
+TagCounters* g_thread_slots[kMaxThreads] = {};
+
+thread_local MemoryTagId t_current_tag = MemoryTags::kUntagged;
+thread_local TagCounters* t_counters = nullptr;
+thread_local bool t_counters_retired = false;
+
+// Счетчики потока. Конструктор не выделяет память - безопасен при первом
+// вызове из operator new
+struct ThreadTagCounters : TagCounters {
+    size_t slot = kMaxThreads;
+
+    ThreadTagCounters() {
+        std::lock_guard<std::mutex> lock(g_threads_mutex);
+        for (size_t i = 0; i < kMaxThreads; ++i) {
+            if (!g_thread_slots[i]) {
+                g_thread_slots[i] = this;
+                slot = i;
+                break;
+            }
+        }
+        t_counters = slot < kMaxThreads ? this : &g_shared_counters;
+    }
+
+    ~ThreadTagCounters() {
+        std::lock_guard<std::mutex> lock(g_threads_mutex);
+
+        if (slot < kMaxThreads) {
+            for (size_t d = 0; d < kDomainCount; ++d) {
+                for (size_t t = 0; t < MemoryTags::kMaxTags; ++t) {
+                    g_shared_counters.bytes[d][t].fetch_add(bytes[d][t].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    g_shared_counters.allocations[d][t].fetch_add(allocations[d][t].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    g_shared_counters.total_allocations[d][t].fetch_add(total_allocations[d][t].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+            }
+            g_thread_slots[slot] = nullptr;
+        }
+
+        t_counters = nullptr;
+        t_counters_retired = true;
+    }
+};
+
+TagCounters* CurrentCounters() {
+    if (t_counters) {
+        return t_counters;
+    }
+    if (t_counters_retired) {
+        return &g_shared_counters; // Аллокации из деструкторов thread_local после нашего
+    }
+
+    static thread_local ThreadTagCounters counters;
+    return t_counters;
+}
+
+void AddCounter(std::atomic<int64_t>& counter, int64_t delta, bool shared) {
+    if (shared) {
+        counter.fetch_add(delta, std::memory_order_relaxed);
+    } else {
+        // Единственный писатель - поток-владелец: load/store без lock-префикса
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+// Знак счетчика передается отдельно: освобождение пустого буфера (0 байт) не должно считаться аллокацией
+void Record(MemoryTagId id, int64_t bytes, int64_t allocations, MemoryTagDomain domain) {
+    if (id >= MemoryTags::kMaxTags) {
+        id = MemoryTags::kUntagged;
+    }
+
+    TagCounters* counters = CurrentCounters();
+    bool shared = counters == &g_shared_counters;
+    size_t d = static_cast<size_t>(domain);
+
+    AddCounter(counters->bytes[d][id], bytes, shared);
+    AddCounter(counters->allocations[d][id], allocations, shared);
+
+    if (allocations > 0) {
+        auto& total = counters->total_allocations[d][id];
+        if (shared) {
+            total.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Accumulate(const TagCounters& counters, std::vector<MemoryTagStats>& stats) {
+    for (size_t d = 0; d < kDomainCount; ++d) {
+        for (size_t t = 0; t < stats.size(); ++t) {
+            stats[t].bytes[d] += counters.bytes[d][t].load(std::memory_order_relaxed);
+            stats[t].allocations[d] += counters.allocations[d][t].load(std::memory_order_relaxed);
+            stats[t].total_allocations[d] += counters.total_allocations[d][t].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+const char* GetDomainName(size_t domain) {
+    switch (static_cast<MemoryTagDomain>(domain)) {
+        case MemoryTagDomain::HEAP: return "heap";
+        case MemoryTagDomain::POOL: return "pool";
+        case MemoryTagDomain::RESOURCE: return "resource";
+        default: return "unknown";
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// MemoryTags Implementation
+// =============================================================================
+
+MemoryTagId MemoryTags::Register(const char* name) {
+    if (!name || !*name) {
+        return kUntagged;
+    }
+
+    // Быстрый путь без блокировки: имена дописываются до публикации счетчика
+    size_t count = g_tag_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (std::strncmp(g_tag_names[i], name, kMaxNameLength - 1) == 0) {
+            return static_cast<MemoryTagId>(i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_register_mutex);
+
+    count = g_tag_count.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (std::strncmp(g_tag_names[i], name, kMaxNameLength - 1) == 0) {
+            return static_cast<MemoryTagId>(i);
+        }
+    }
+
+    if (count >= kMaxTags) {
+        return kUntagged;
+    }
+
+    std::strncpy(g_tag_names[count], name, kMaxNameLength - 1);
+    g_tag_names[count][kMaxNameLength - 1] = '\0';
+    g_tag_count.store(count + 1, std::memory_order_release);
+
+    return static_cast<MemoryTagId>(count);
+}
+
+const char* MemoryTags::GetName(MemoryTagId id) {
+    return id < g_tag_count.load(std::memory_order_acquire) ? g_tag_names[id] : g_tag_names[kUntagged];
+}
+
+MemoryTagId MemoryTags::GetCurrent() {
+    return t_current_tag;
+}
+
+void MemoryTags::SetCurrent(MemoryTagId id) {
+    t_current_tag = id;
+}
+
+void MemoryTags::RecordAllocation(MemoryTagId id, size_t bytes, MemoryTagDomain domain) {
+    Record(id, static_cast<int64_t>(bytes), 1, domain);
+}
+
+void MemoryTags::RecordDeallocation(MemoryTagId id, size_t bytes, MemoryTagDomain domain) {
+    Record(id, -static_cast<int64_t>(bytes), -1, domain);
+}
+
+std::vector<MemoryTagStats> MemoryTags::Collect() {
+    size_t count = g_tag_count.load(std::memory_order_acquire);
+
+    std::vector<MemoryTagStats> stats(count);
+    for (size_t i = 0; i < count; ++i) {
+        stats[i].id = static_cast<MemoryTagId>(i);
+        stats[i].name = g_tag_names[i];
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_threads_mutex);
+
+        Accumulate(g_shared_counters, stats);
+        for (const TagCounters* counters : g_thread_slots) {
+            if (counters) {
+                Accumulate(*counters, stats);
+            }
+        }
+    }
+
+    stats.erase(std::remove_if(stats.begin(), stats.end(), [](const MemoryTagStats& s) {
+        for (size_t d = 0; d < kDomainCount; ++d) {
+            if (s.bytes[d] != 0 || s.total_allocations[d] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }), stats.end());
+
+    // Крупнейшие потребители первыми
+    std::sort(stats.begin(), stats.end(), [](const MemoryTagStats& a, const MemoryTagStats& b) {
+        return a.GetTotalBytes() > b.GetTotalBytes();
+    });
+
+    return stats;
+}
+
+std::string MemoryTags::FormatReport() {
+    auto stats = Collect();
+
+    std::ostringstream report;
+    report << "=== Memory Tags ===\n";
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %12s %12s %12s %12s %10s\n",
+                  "tag", "heap KB", "pool KB", "resource KB", "total KB", "live");
+    report << line;
+
+    for (const auto& s : stats) {
+        int64_t live = 0;
+        for (int64_t value : s.allocations) {
+            live += value;
+        }
+
+        std::snprintf(line, sizeof(line), "%-24s %12lld %12lld %12lld %12lld %10lld\n",
+                      s.name.c_str(),
+                      static_cast<long long>(s.bytes[static_cast<size_t>(MemoryTagDomain::HEAP)] / 1024),
+                      static_cast<long long>(s.bytes[static_cast<size_t>(MemoryTagDomain::POOL)] / 1024),
+                      static_cast<long long>(s.bytes[static_cast<size_t>(MemoryTagDomain::RESOURCE)] / 1024),
+                      static_cast<long long>(s.GetTotalBytes() / 1024),
+                      static_cast<long long>(live));
+        report << line;
+    }
+
+    return report.str();
+}
+
+bool MemoryTags::ExportReport(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "tag,domain,bytes,allocations,total_allocations\n";
+    for (const auto& s : Collect()) {
+        for (size_t d = 0; d < kDomainCount; ++d) {
+            if (s.bytes[d] == 0 && s.total_allocations[d] == 0) {
+                continue;
+            }
+            file << s.name << "," << GetDomainName(d) << "," << s.bytes[d] << ","
+                 << s.allocations[d] << "," << s.total_allocations[d] << "\n";
+        }
+    }
+
+    return file.good();
+}
+
+} // namespace Memory
+} // namespace WxeUI
+
+// =============================================================================
+// Global operator new/delete hook
+// =============================================================================
+
+#ifdef WXE_MEMORY_TAG_NEW_HOOK
+
+namespace {
+
+using WxeUI::Memory::MemoryTagDomain;
+using WxeUI::Memory::MemoryTags;
+
+// Заголовок перед каждым блоком: размер и тег для учета при освобождении
+struct HeapHeader {
+    size_t size;
+    size_t tag;
+};
+
+constexpr size_t kHeapHeaderSize = 16;
+static_assert(sizeof(HeapHeader) <= kHeapHeaderSize, "heap header must fit into 16 bytes");
+
+size_t HeaderOffset(size_t alignment) {
+    return std::max(alignment, kHeapHeaderSize);
+}
+
+void* TaggedAllocate(size_t size, size_t alignment) noexcept {
+    size_t offset = HeaderOffset(alignment);
+    void* base = nullptr;
+
+#ifdef _WIN32
+    base = _aligned_malloc(size + offset, std::max(alignment, kHeapHeaderSize));
+#else
+    if (alignment <= alignof(std::max_align_t)) {
+        base = std::malloc(size + offset);
+    } else if (posix_memalign(&base, alignment, size + offset) != 0) {
+        base = nullptr;
+    }
+#endif
+
+    if (!base) {
+        return nullptr;
+    }
+
+    char* user = static_cast<char*>(base) + offset;
+    auto* header = reinterpret_cast<HeapHeader*>(user - kHeapHeaderSize);
+    header->size = size;
+    header->tag = MemoryTags::GetCurrent();
+
+    MemoryTags::RecordAllocation(static_cast<WxeUI::Memory::MemoryTagId>(header->tag), size, MemoryTagDomain::HEAP);
+    return user;
+}
+
+void TaggedFree(void* ptr, size_t alignment) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    char* user = static_cast<char*>(ptr);
+    auto* header = reinterpret_cast<HeapHeader*>(user - kHeapHeaderSize);
+    MemoryTags::RecordDeallocation(static_cast<WxeUI::Memory::MemoryTagId>(header->tag), header->size, MemoryTagDomain::HEAP);
+
+    void* base = user - HeaderOffset(alignment);
+#ifdef _WIN32
+    _aligned_free(base);
+#else
+    std::free(base);
+#endif
+}
+
+void* TaggedNew(size_t size, size_t alignment) {
+    for (;;) {
+        if (void* ptr = TaggedAllocate(size, alignment)) {
+            return ptr;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* TaggedNewNothrow(size_t size, size_t alignment) noexcept {
+    try {
+        return TaggedNew(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+} // namespace
+
+void* operator new(size_t size) { return TaggedNew(size, kDefaultAlignment); }
+void* operator new[](size_t size) { return TaggedNew(size, kDefaultAlignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TaggedNewNothrow(size, kDefaultAlignment); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TaggedNewNothrow(size, kDefaultAlignment); }
+void* operator new(size_t size, std::align_val_t al) { return TaggedNew(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return TaggedNew(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return TaggedNewNothrow(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return TaggedNewNothrow(size, static_cast<size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, size_t) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr, size_t) noexcept { TaggedFree(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, std::align_val_t al) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, size_t, std::align_val_t al) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, size_t, std::align_val_t al) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { TaggedFree(ptr, static_cast<size_t>(al)); }
+
+#endif // WXE_MEMORY_TAG_NEW_HOOK
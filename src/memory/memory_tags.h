@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace WxeUI {
+namespace Memory {
+
+using MemoryTagId = uint16_t;
+
+// Источник учтенной памяти
+enum class MemoryTagDomain {
+    HEAP,       // operator new/delete (сборка с WXE_MEMORY_TAG_NEW_HOOK)
+    POOL,       // Блоки MemoryPool, выданные пользователю
+    RESOURCE,   // Явный учет: GPU-текстуры, буферы захвата, данные кэшей
+    COUNT
+};
+
+struct MemoryTagStats {
+    static constexpr size_t kDomainCount = static_cast<size_t>(MemoryTagDomain::COUNT);
+
+    MemoryTagId id = 0;
+    std::string name;
+    int64_t bytes[kDomainCount] = {};               // Текущий объем
+    int64_t allocations[kDomainCount] = {};         // Живые аллокации
+    uint64_t total_allocations[kDomainCount] = {};  // Всего аллокаций (churn)
+
+    int64_t GetTotalBytes() const {
+        int64_t total = 0;
+        for (int64_t value : bytes) {
+            total += value;
+        }
+        return total;
+    }
+};
+
+// Реестр тегов и счетчики. Счетчики пишутся только своим потоком (без RMW
+// и без общей кэш-линии), агрегация по всем потокам - по запросу в Collect().
+// Освобождение в другом потоке уменьшает счетчик освобождающего потока:
+// значения одного потока могут быть отрицательными, сумма - точная.
+class MemoryTags {
+public:
+    static constexpr MemoryTagId kUntagged = 0;
+    static constexpr size_t kMaxTags = 64;
+    static constexpr size_t kMaxNameLength = 32;
+
+    // Регистрация без выделения памяти - допустима из operator new.
+    // Повторная регистрация имени возвращает тот же id; при переполнении - kUntagged
+    static MemoryTagId Register(const char* name);
+    static const char* GetName(MemoryTagId id);
+
+    // Тег текущего потока
+    static MemoryTagId GetCurrent();
+    static void SetCurrent(MemoryTagId id);
+
+    static void RecordAllocation(MemoryTagId id, size_t bytes, MemoryTagDomain domain = MemoryTagDomain::RESOURCE);
+    static void RecordDeallocation(MemoryTagId id, size_t bytes, MemoryTagDomain domain = MemoryTagDomain::RESOURCE);
+
+    // Сумма по живым и завершенным потокам; только теги с ненулевой статистикой
+    static std::vector<MemoryTagStats> Collect();
+
+    // Отчеты
+    static std::string FormatReport();
+    static bool ExportReport(const std::string& filename);   // CSV: tag,domain,bytes,allocations,total_allocations
+};
+
+// Тег на время области видимости: аллокации потока (operator new, MemoryPool)
+// учитываются на нем. Вложенные области восстанавливают предыдущий тег.
+class ScopedMemoryTag {
+public:
+    explicit ScopedMemoryTag(const char* name) : ScopedMemoryTag(MemoryTags::Register(name)) {}
+    explicit ScopedMemoryTag(MemoryTagId id) : previous_(MemoryTags::GetCurrent()) { MemoryTags::SetCurrent(id); }
+    ~ScopedMemoryTag() { MemoryTags::SetCurrent(previous_); }
+
+    ScopedMemoryTag(const ScopedMemoryTag&) = delete;
+    ScopedMemoryTag& operator=(const ScopedMemoryTag&) = delete;
+
+private:
+    MemoryTagId previous_;
+};
+
+} // namespace Memory
+} // namespace WxeUI
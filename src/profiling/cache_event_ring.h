@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace WxeUI {
+namespace Profiling {
+
+using CacheNameId = uint16_t;
+
+// Счетчик тактов для отметок времени событий: TSC на x86, виртуальный таймер
+// на ARM64, иначе steady_clock в наносекундах. Перевод в время - калибровкой
+// по steady_clock в потоке сбора (CacheProfiler::DrainEvents)
+inline uint64_t ReadCycleCounter() {
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Двоичная запись события кэша: фиксированный размер, без строк
+struct CacheEventRecord {
+    uint64_t timestamp;     // ReadCycleCounter()
+    uint64_t key_hash;      // CacheProfiler::HashKey
+    uint64_t data_size;
+    uint32_t duration_ns;   // С насыщением (~4.3 с)
+    CacheNameId cache;      // CacheProfiler::InternCacheName
+    uint8_t type;           // CacheEventType
+    uint8_t reserved;
+};
+
+static_assert(sizeof(CacheEventRecord) == 32, "CacheEventRecord must stay two records per cache line");
+
+// Кольцо SPSC одного потока: пишет только поток-владелец, читает только поток
+// сбора. Запись - копирование 32 байт и release-store позиции; при заполнении
+// событие теряется и учитывается в GetDropped()
+class CacheEventRing {
+public:
+    explicit CacheEventRing(size_t capacity) {
+        size_t size = 64;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        mask_ = size - 1;
+        records_ = std::make_unique<CacheEventRecord[]>(size);
+    }
+
+    CacheEventRing(const CacheEventRing&) = delete;
+    CacheEventRing& operator=(const CacheEventRing&) = delete;
+
+    bool TryPush(const CacheEventRecord& record) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ > mask_) {
+            // Позиция потребителя перечитывается, только когда кольцо кажется полным
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ > mask_) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        records_[head & mask_] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток сбора
+    template<typename Consumer>
+    size_t Drain(Consumer&& consumer) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+
+        for (uint64_t position = tail; position != head; ++position) {
+            consumer(records_[position & mask_]);
+        }
+
+        tail_.store(head, std::memory_order_release);
+        return static_cast<size_t>(head - tail);
+    }
+
+    bool IsEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed); }
+    uint64_t GetRecorded() const { return head_.load(std::memory_order_relaxed); }
+    uint64_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Поток-владелец завершился: кольцо удаляется после последнего сбора
+    void Retire() { retired_.store(true, std::memory_order_release); }
+    bool IsRetired() const { return retired_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    std::unique_ptr<CacheEventRecord[]> records_;
+    uint64_t mask_ = 0;
+    std::atomic<bool> retired_{false};
+
+    // Позиции производителя и потребителя на разных кэш-линиях
+    char padding0_[kCacheLineSize];
+    std::atomic<uint64_t> head_{0};
+    uint64_t cachedTail_ = 0;                   // Только производитель
+    std::atomic<uint64_t> dropped_{0};          // Пишет только производитель
+    char padding1_[kCacheLineSize - 2 * sizeof(uint64_t) - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> tail_{0};
+    char padding2_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+};
+
+} // namespace Profiling
+} // namespace WxeUI
@@ -0,0 +1,568 @@
+#include "profiling/cache_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace WxeUI {
+namespace Profiling {
+
+namespace {
+
+constexpr size_t kMaxAccessTimes = 64;     // Окно времен обращений в AccessPattern
+
+std::atomic<uint64_t> g_next_profiler_id{1};
+
+// Кольцо потока для последнего профайлера, в который он писал. Поток, пишущий
+// попеременно в несколько профайлеров, получает новое кольцо при каждой смене
+struct ThreadRingBinding {
+    uint64_t owner = 0;
+    std::shared_ptr<CacheEventRing> ring;
+
+    ~ThreadRingBinding() {
+        if (ring) {
+            ring->Retire();
+        }
+    }
+};
+
+thread_local ThreadRingBinding t_ring_binding;
+
+std::string FormatKeyHash(uint64_t hash) {
+    char buffer[19];
+    std::snprintf(buffer, sizeof(buffer), "0x%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+const char* GetEventTypeLabel(CacheEventType type) {
+    switch (type) {
+        case CacheEventType::HIT: return "HIT";
+        case CacheEventType::MISS: return "MISS";
+        case CacheEventType::EVICTION: return "EVICTION";
+        case CacheEventType::INSERTION: return "INSERTION";
+        case CacheEventType::UPDATE: return "UPDATE";
+        case CacheEventType::COMPRESSION: return "COMPRESSION";
+        case CacheEventType::DECOMPRESSION: return "DECOMPRESSION";
+        case CacheEventType::GPU_UPLOAD: return "GPU_UPLOAD";
+        case CacheEventType::GPU_EVICTION: return "GPU_EVICTION";
+        case CacheEventType::CLEANUP: return "CLEANUP";
+    }
+    return "UNKNOWN";
+}
+
+void UpdateAverage(std::atomic<double>& average, uint64_t count, double value) {
+    // Единственный писатель - поток сбора
+    double current = average.load(std::memory_order_relaxed);
+    average.store(current + (value - current) / static_cast<double>(count), std::memory_order_relaxed);
+}
+
+} // namespace
+
+// CacheProfiler Implementation
+CacheProfiler::CacheProfiler(const Config& config)
+    : config_(config), instance_id_(g_next_profiler_id.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+CacheProfiler::~CacheProfiler() {
+    Shutdown();
+}
+
+bool CacheProfiler::Initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    cycle_origin_ = ReadCycleCounter();
+    clock_origin_ = std::chrono::steady_clock::now();
+
+    if (config_.stream_trace) {
+        CacheTraceWriter::Config trace_config;
+        trace_config.directory = config_.log_directory;
+        trace_config.chunk_records = config_.trace_chunk_records;
+        trace_config.max_file_bytes = config_.trace_max_file_bytes;
+        trace_config.max_files = config_.trace_max_files;
+        trace_config.compress = config_.compress_logs;
+        trace_config.compression_level = config_.trace_compression_level;
+
+        trace_writer_ = std::make_unique<CacheTraceWriter>(trace_config);
+        if (!trace_writer_->Open()) {
+            std::cerr << "CacheProfiler: trace streaming disabled" << std::endl;
+            trace_writer_.reset();
+        }
+        trace_names_written_ = 1;
+        trace_last_flush_ = clock_origin_;
+    }
+
+    threads_running_ = true;
+    drain_thread_ = std::thread(&CacheProfiler::DrainWorker, this);
+    initialized_ = true;
+
+    if (config_.enable_profiling) {
+        StartProfiling();
+    }
+    return true;
+}
+
+void CacheProfiler::Shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    StopProfiling();
+    threads_running_ = false;
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+
+    // Последние записи колец
+    DrainEvents();
+    if (trace_writer_) {
+        trace_writer_->Close();
+        trace_writer_.reset();
+    }
+    initialized_ = false;
+}
+
+void CacheProfiler::StartProfiling() {
+    profiling_active_.store(true, std::memory_order_relaxed);
+}
+
+void CacheProfiler::StopProfiling() {
+    profiling_active_.store(false, std::memory_order_relaxed);
+}
+
+bool CacheProfiler::IsProfiling() const {
+    return profiling_active_.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Регистрация событий
+// ============================================================================
+
+void CacheProfiler::RecordEvent(CacheEventType type, const std::string& cache_name,
+                                const std::string& key, size_t data_size,
+                                double duration_ms, const std::string& info) {
+    (void)info;
+    if (!profiling_active_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    uint64_t duration_ns = duration_ms > 0.0 ? static_cast<uint64_t>(duration_ms * 1e6) : 0;
+    RecordEvent(type, InternCacheName(cache_name), HashKey(key), data_size, duration_ns);
+}
+
+void CacheProfiler::RecordEvent(CacheEventType type, CacheNameId cache, uint64_t key_hash,
+                                size_t data_size, uint64_t duration_ns) {
+    if (!profiling_active_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    CacheEventRecord record;
+    record.timestamp = ReadCycleCounter();
+    record.key_hash = key_hash;
+    record.data_size = data_size;
+    record.duration_ns = static_cast<uint32_t>(std::min<uint64_t>(duration_ns, std::numeric_limits<uint32_t>::max()));
+    record.cache = cache;
+    record.type = static_cast<uint8_t>(type);
+    record.reserved = 0;
+
+    GetThreadRing()->TryPush(record);
+}
+
+void CacheProfiler::RecordHit(const std::string& cache_name, const std::string& key,
+                              size_t data_size, double duration_ms) {
+    RecordEvent(CacheEventType::HIT, cache_name, key, data_size, duration_ms);
+}
+
+void CacheProfiler::RecordMiss(const std::string& cache_name, const std::string& key,
+                               double duration_ms) {
+    RecordEvent(CacheEventType::MISS, cache_name, key, 0, duration_ms);
+}
+
+void CacheProfiler::RecordEviction(const std::string& cache_name, const std::string& key,
+                                   size_t data_size, double duration_ms) {
+    RecordEvent(CacheEventType::EVICTION, cache_name, key, data_size, duration_ms);
+}
+
+CacheNameId CacheProfiler::InternCacheName(const std::string& cache_name) {
+    // Имена усекаются до kMaxCacheNameLength - 1 символов
+    size_t count = cache_name_count_.load(std::memory_order_acquire);
+    for (size_t i = 1; i < count; ++i) {
+        if (std::strncmp(cache_names_[i], cache_name.c_str(), kMaxCacheNameLength - 1) == 0) {
+            return static_cast<CacheNameId>(i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cache_names_mutex_);
+    count = cache_name_count_.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < count; ++i) {
+        if (std::strncmp(cache_names_[i], cache_name.c_str(), kMaxCacheNameLength - 1) == 0) {
+            return static_cast<CacheNameId>(i);
+        }
+    }
+
+    if (count == kMaxCacheNames) {
+        return kUnknownCache;
+    }
+
+    std::strncpy(cache_names_[count], cache_name.c_str(), kMaxCacheNameLength - 1);
+    cache_names_[count][kMaxCacheNameLength - 1] = '\0';
+    cache_name_count_.store(count + 1, std::memory_order_release);
+    return static_cast<CacheNameId>(count);
+}
+
+uint64_t CacheProfiler::HashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+CacheEventRing* CacheProfiler::GetThreadRing() {
+    ThreadRingBinding& binding = t_ring_binding;
+    if (binding.owner == instance_id_) {
+        return binding.ring.get();
+    }
+
+    auto ring = std::make_shared<CacheEventRing>(config_.event_ring_capacity);
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(ring);
+    }
+
+    if (binding.ring) {
+        binding.ring->Retire();
+    }
+    binding.owner = instance_id_;
+    binding.ring = std::move(ring);
+    return binding.ring.get();
+}
+
+// ============================================================================
+// Сбор колец
+// ============================================================================
+
+void CacheProfiler::DrainWorker() {
+    while (threads_running_) {
+        std::this_thread::sleep_for(config_.event_drain_interval);
+        DrainEvents();
+    }
+}
+
+void CacheProfiler::DrainEvents() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+
+    // Калибровка тактов по steady_clock: чем дольше работа, тем точнее масштаб
+    uint64_t cycles = ReadCycleCounter();
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - clock_origin_).count();
+    if (cycles > cycle_origin_ && elapsed_ns > 1e6) {
+        ns_per_cycle_ = elapsed_ns / static_cast<double>(cycles - cycle_origin_);
+    }
+
+    std::vector<std::shared_ptr<CacheEventRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    drain_buffer_.clear();
+    for (const auto& ring : rings) {
+        ring->Drain([this](const CacheEventRecord& record) { drain_buffer_.push_back(record); });
+    }
+
+    // Кольца завершившихся потоков удаляются, когда в них ничего не осталось
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [this](const std::shared_ptr<CacheEventRing>& ring) {
+            if (!ring->IsRetired() || !ring->IsEmpty()) {
+                return false;
+            }
+            retired_recorded_.fetch_add(ring->GetRecorded(), std::memory_order_relaxed);
+            retired_dropped_.fetch_add(ring->GetDropped(), std::memory_order_relaxed);
+            return true;
+        }), rings_.end());
+    }
+
+    if (!drain_buffer_.empty()) {
+        ProcessRecords(drain_buffer_);
+        drained_events_.fetch_add(drain_buffer_.size(), std::memory_order_relaxed);
+    }
+
+    if (trace_writer_) {
+        WriteTrace(drain_buffer_);
+    }
+
+    if (ZoneProfiler::Get().IsCapturing()) {
+        RecordZoneEvents(drain_buffer_);
+    }
+}
+
+void CacheProfiler::RecordZoneEvents(const std::vector<CacheEventRecord>& records) {
+    ZoneProfiler& zones = ZoneProfiler::Get();
+    size_t name_count = cache_name_count_.load(std::memory_order_acquire);
+    while (zone_tracks_.size() < name_count) {
+        zone_tracks_.push_back(zones.RegisterTrack(std::string("Cache: ") + cache_names_[zone_tracks_.size()]));
+    }
+
+    // Мгновенные события на дорожке кэша в момент записи; аргумент - хэш ключа
+    for (const CacheEventRecord& record : records) {
+        CacheNameId cache = record.cache < name_count ? record.cache : kUnknownCache;
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            CyclesToTimePoint(record.timestamp).time_since_epoch()).count();
+        zones.RecordInstant(zone_tracks_[cache], GetEventTypeLabel(static_cast<CacheEventType>(record.type)),
+                            timestamp, record.key_hash);
+    }
+}
+
+void CacheProfiler::WriteTrace(const std::vector<CacheEventRecord>& records) {
+    // Новые имена - до записей, которые на них ссылаются
+    size_t name_count = cache_name_count_.load(std::memory_order_acquire);
+    for (; trace_names_written_ < name_count; ++trace_names_written_) {
+        trace_writer_->SetCacheName(static_cast<CacheNameId>(trace_names_written_), cache_names_[trace_names_written_]);
+    }
+
+    // В трассе - наносекунды steady_clock: файл читается без калибровки тактов
+    trace_buffer_.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        trace_buffer_[i] = records[i];
+        trace_buffer_[i].timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            CyclesToTimePoint(records[i].timestamp).time_since_epoch()).count());
+    }
+    trace_writer_->Append(trace_buffer_.data(), trace_buffer_.size());
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - trace_last_flush_ >= config_.trace_flush_interval) {
+        trace_writer_->Flush();
+        trace_last_flush_ = now;
+    }
+}
+
+std::chrono::steady_clock::time_point CacheProfiler::CyclesToTimePoint(uint64_t cycles) const {
+    double offset_ns = (static_cast<double>(cycles) - static_cast<double>(cycle_origin_)) * ns_per_cycle_;
+    return clock_origin_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::nano>(offset_ns));
+}
+
+void CacheProfiler::ProcessRecords(const std::vector<CacheEventRecord>& records) {
+    // id из быстрого RecordEvent не проверяется при записи - только здесь
+    size_t name_count = cache_name_count_.load(std::memory_order_acquire);
+    auto cache_id = [name_count](const CacheEventRecord& record) {
+        return record.cache < name_count ? record.cache : kUnknownCache;
+    };
+
+    // Метрики: поиск по имени один раз на кэш за сбор
+    {
+        std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
+        CacheMetrics* metrics_by_id[kMaxCacheNames] = {};
+
+        for (const CacheEventRecord& record : records) {
+            CacheNameId id = cache_id(record);
+            CacheMetrics*& metrics = metrics_by_id[id];
+            if (!metrics) {
+                metrics = &cache_metrics_[cache_names_[id]];
+            }
+
+            double duration_ms = record.duration_ns / 1e6;
+            switch (static_cast<CacheEventType>(record.type)) {
+                case CacheEventType::HIT:
+                    UpdateAverage(metrics->avg_hit_time_ms, metrics->total_hits.fetch_add(1) + 1, duration_ms);
+                    break;
+                case CacheEventType::MISS:
+                    UpdateAverage(metrics->avg_miss_time_ms, metrics->total_misses.fetch_add(1) + 1, duration_ms);
+                    break;
+                case CacheEventType::EVICTION:
+                    UpdateAverage(metrics->avg_eviction_time_ms, metrics->total_evictions.fetch_add(1) + 1, duration_ms);
+                    metrics->current_memory_usage -= std::min<size_t>(metrics->current_memory_usage, record.data_size);
+                    break;
+                case CacheEventType::INSERTION:
+                    UpdateAverage(metrics->avg_insertion_time_ms, metrics->total_insertions.fetch_add(1) + 1, duration_ms);
+                    metrics->current_memory_usage += record.data_size;
+                    if (metrics->current_memory_usage > metrics->peak_memory_usage) {
+                        metrics->peak_memory_usage = metrics->current_memory_usage.load();
+                    }
+                    break;
+                default:
+                    break;
+            }
+            metrics->total_bytes_processed += record.data_size;
+        }
+    }
+
+    // Паттерны доступа
+    if (config_.enable_pattern_analysis) {
+        std::lock_guard<std::mutex> lock(patterns_mutex_);
+        for (const CacheEventRecord& record : records) {
+            auto type = static_cast<CacheEventType>(record.type);
+            if (type == CacheEventType::HIT || type == CacheEventType::MISS) {
+                UpdateAccessPattern(FormatKeyHash(record.key_hash), CyclesToTimePoint(record.timestamp));
+            }
+        }
+    }
+
+    // Журнал событий и callback: строки CacheEvent строятся только здесь
+    EventCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        callback = event_callback_;
+    }
+
+    if (!config_.enable_event_logging && !callback) {
+        return;
+    }
+
+    std::vector<CacheEvent> events;
+    events.reserve(records.size());
+    for (const CacheEventRecord& record : records) {
+        CacheEvent event;
+        event.type = static_cast<CacheEventType>(record.type);
+        event.cache_name = cache_names_[cache_id(record)];
+        event.key = FormatKeyHash(record.key_hash);
+        event.data_size = static_cast<size_t>(record.data_size);
+        event.timestamp = CyclesToTimePoint(record.timestamp);
+        event.duration_ms = record.duration_ns / 1e6;
+        events.push_back(std::move(event));
+    }
+
+    if (callback) {
+        for (const CacheEvent& event : events) {
+            callback(event);
+        }
+    }
+
+    if (config_.enable_event_logging) {
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        events_.insert(events_.end(), std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+        if (events_.size() > config_.max_events) {
+            events_.erase(events_.begin(), events_.end() - static_cast<std::ptrdiff_t>(config_.max_events));
+        }
+    }
+}
+
+void CacheProfiler::UpdateAccessPattern(const std::string& key, std::chrono::steady_clock::time_point timestamp) {
+    // Вызывается под patterns_mutex_
+    auto it = access_patterns_.find(key);
+    if (it == access_patterns_.end()) {
+        if (access_patterns_.size() >= config_.max_patterns) {
+            return;
+        }
+        it = access_patterns_.emplace(key, AccessPattern{}).first;
+        it->second.key = key;
+    }
+
+    AccessPattern& pattern = it->second;
+    pattern.total_accesses++;
+    pattern.access_times.push_back(timestamp);
+    if (pattern.access_times.size() > kMaxAccessTimes) {
+        pattern.access_times.erase(pattern.access_times.begin());
+    }
+
+    if (pattern.access_times.size() > 1) {
+        pattern.avg_interval_ms = std::chrono::duration<double, std::milli>(
+            pattern.access_times.back() - pattern.access_times.front()).count() /
+            static_cast<double>(pattern.access_times.size() - 1);
+    }
+    pattern.is_hot = pattern.total_accesses >= config_.hot_access_threshold;
+}
+
+CacheProfiler::EventRingStats CacheProfiler::GetEventRingStats() const {
+    EventRingStats stats;
+    stats.recorded = retired_recorded_.load(std::memory_order_relaxed);
+    stats.dropped = retired_dropped_.load(std::memory_order_relaxed);
+    stats.drained = drained_events_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        stats.recorded += ring->GetRecorded();
+        stats.dropped += ring->GetDropped();
+        if (!ring->IsRetired()) {
+            stats.rings++;
+        }
+    }
+    return stats;
+}
+
+// ============================================================================
+// Callbacks и утилиты
+// ============================================================================
+
+void CacheProfiler::SetEventCallback(EventCallback callback) {
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    event_callback_ = std::move(callback);
+}
+
+void CacheProfiler::SetPatternCallback(PatternCallback callback) {
+    std::lock_guard<std::mutex> lock(patterns_mutex_);
+    pattern_callback_ = std::move(callback);
+}
+
+std::string CacheProfiler::GetEventTypeName(CacheEventType type) {
+    return GetEventTypeLabel(type);
+}
+
+// ============================================================================
+// GlobalCacheProfiler
+// ============================================================================
+
+std::unique_ptr<CacheProfiler> GlobalCacheProfiler::instance_;
+std::atomic<CacheProfiler*> GlobalCacheProfiler::active_{nullptr};
+std::vector<std::unique_ptr<CacheProfiler>> GlobalCacheProfiler::retired_;
+std::mutex GlobalCacheProfiler::instance_mutex_;
+
+CacheProfiler& GlobalCacheProfiler::Instance() {
+    if (CacheProfiler* profiler = active_.load(std::memory_order_acquire)) {
+        return *profiler;
+    }
+
+    std::lock_guard<std::mutex> lock(instance_mutex_);
+    if (!instance_) {
+        instance_ = std::make_unique<CacheProfiler>();
+        instance_->Initialize();
+        active_.store(instance_.get(), std::memory_order_release);
+    }
+    return *instance_;
+}
+
+void GlobalCacheProfiler::Initialize(const CacheProfiler::Config& config) {
+    std::lock_guard<std::mutex> lock(instance_mutex_);
+    RetireInstance();
+
+    instance_ = std::make_unique<CacheProfiler>(config);
+    instance_->Initialize();
+    active_.store(instance_.get(), std::memory_order_release);
+}
+
+void GlobalCacheProfiler::Shutdown() {
+    std::lock_guard<std::mutex> lock(instance_mutex_);
+    RetireInstance();
+}
+
+void GlobalCacheProfiler::RetireInstance() {
+    // Вызывается под instance_mutex_. Запись через ранее полученную ссылку
+    // может еще идти: экземпляр останавливается, но не удаляется
+    active_.store(nullptr, std::memory_order_release);
+    if (instance_) {
+        instance_->Shutdown();
+        retired_.push_back(std::move(instance_));
+    }
+}
+
+void GlobalCacheProfiler::RecordHit(const std::string& cache_name, const std::string& key,
+                                    size_t data_size, double duration_ms) {
+    Instance().RecordHit(cache_name, key, data_size, duration_ms);
+}
+
+void GlobalCacheProfiler::RecordMiss(const std::string& cache_name, const std::string& key,
+                                     double duration_ms) {
+    Instance().RecordMiss(cache_name, key, duration_ms);
+}
+
+void GlobalCacheProfiler::RecordEviction(const std::string& cache_name, const std::string& key,
+                                         size_t data_size, double duration_ms) {
+    Instance().RecordEviction(cache_name, key, data_size, duration_ms);
+}
+
+} // namespace Profiling
+} // namespace WxeUI
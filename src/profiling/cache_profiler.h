@@ -12,6 +12,10 @@
 #include <fstream>
 #include <shared_mutex>
 
+#include "profiling/cache_event_ring.h"
+#include "profiling/cache_trace.h"
+#include "profiling/zone_profiler.h"
+
 namespace WxeUI {
 namespace Profiling {
 
@@ -120,6 +124,8 @@ public:
         
         // Сбор данных
         size_t max_events = 100000;                     // Максимум событий в памяти
+        size_t event_ring_capacity = 8192;              // Записей в кольце потока; сверх - потеря
+        std::chrono::milliseconds event_drain_interval{10}; // Период сбора колец
         size_t max_patterns = 10000;                    // Максимум паттернов
         std::chrono::seconds snapshot_interval{10};     // Интервал снимков
         std::chrono::seconds pattern_update_interval{30}; // Обновление паттернов
@@ -134,6 +140,15 @@ public:
         std::string log_directory = "cache_logs";
         bool compress_logs = true;
         
+        // Потоковая трасса событий (profiling/cache_trace.h) в log_directory:
+        // память постоянна, диск ограничен trace_max_files * trace_max_file_bytes
+        bool stream_trace = false;
+        size_t trace_chunk_records = 16384;
+        size_t trace_max_file_bytes = 64 * 1024 * 1024;
+        size_t trace_max_files = 16;
+        int trace_compression_level = 3;                // zstd, при compress_logs
+        std::chrono::seconds trace_flush_interval{1};   // Сброс неполного чанка
+        
         // Визуализация
         bool generate_reports = true;
         bool generate_charts = false;                   // Требует дополнительных библиотек
@@ -151,11 +166,33 @@ public:
     bool Initialize();
     void Shutdown();
     
-    // Регистрация событий
+    // Регистрация событий. Запись - двоичная (имя кэша -> id, ключ -> хэш) в
+    // кольцо своего потока, без блокировок и выделения памяти; строки CacheEvent,
+    // метрики и паттерны строятся в фоновом потоке сбора. info в кольцо не пишется
     void RecordEvent(CacheEventType type, const std::string& cache_name, 
                     const std::string& key, size_t data_size = 0, 
                     double duration_ms = 0.0, const std::string& info = "");
     
+    // Самый быстрый путь: имя кэша интернировано заранее, ключ уже хэширован
+    void RecordEvent(CacheEventType type, CacheNameId cache, uint64_t key_hash,
+                    size_t data_size = 0, uint64_t duration_ns = 0);
+    
+    // Интернирование без выделения памяти, поиск без блокировок; повторное имя -
+    // тот же id, при переполнении - kUnknownCache
+    CacheNameId InternCacheName(const std::string& cache_name);
+    static uint64_t HashKey(const std::string& key);    // FNV-1a
+    
+    // Немедленный сбор колец (обычно - фоновым потоком раз в event_drain_interval)
+    void DrainEvents();
+    
+    struct EventRingStats {
+        uint64_t recorded = 0;      // Записано в кольца
+        uint64_t dropped = 0;       // Потеряно при заполнении кольца
+        uint64_t drained = 0;       // Обработано потоком сбора
+        size_t rings = 0;           // Живые кольца потоков
+    };
+    EventRingStats GetEventRingStats() const;
+    
     void RecordHit(const std::string& cache_name, const std::string& key, 
                 size_t data_size = 0, double duration_ms = 0.0);
     
@@ -217,6 +254,10 @@ public:
     void UpdateConfig(const Config& new_config);
     const Config& GetConfig() const { return config_; }
     
+    static constexpr CacheNameId kUnknownCache = 0;
+    static constexpr size_t kMaxCacheNames = 64;
+    static constexpr size_t kMaxCacheNameLength = 32;
+    
     // Утилиты
     static std::string GetEventTypeName(CacheEventType type);
     static std::string FormatDuration(double duration_ms);
@@ -233,6 +274,38 @@ private:
     std::vector<CacheEvent> events_;
     mutable std::mutex events_mutex_;
     
+    // Кольца потоков: поток находит свое через thread_local, список нужен
+    // только потоку сбора и при регистрации нового потока
+    const uint64_t instance_id_;
+    std::vector<std::shared_ptr<CacheEventRing>> rings_;
+    mutable std::mutex rings_mutex_;
+    std::vector<CacheEventRecord> drain_buffer_;        // Только поток сбора (под drain_mutex_)
+    std::mutex drain_mutex_;
+    std::atomic<uint64_t> drained_events_{0};
+    std::atomic<uint64_t> retired_recorded_{0};         // Счетчики удаленных колец
+    std::atomic<uint64_t> retired_dropped_{0};
+    std::thread drain_thread_;
+    
+    // Перевод тактов ReadCycleCounter() во время: опорная точка и масштаб,
+    // уточняемый при каждом сборе
+    uint64_t cycle_origin_ = 0;
+    std::chrono::steady_clock::time_point clock_origin_;
+    double ns_per_cycle_ = 1.0;
+    
+    // Интернированные имена: фиксированный массив, записи не меняются после публикации
+    char cache_names_[kMaxCacheNames][kMaxCacheNameLength] = {"unknown"};
+    std::atomic<size_t> cache_name_count_{1};
+    std::mutex cache_names_mutex_;
+    
+    // Потоковая трасса: только поток сбора (под drain_mutex_)
+    std::unique_ptr<CacheTraceWriter> trace_writer_;
+    size_t trace_names_written_ = 1;                    // kUnknownCache читатель знает сам
+    std::chrono::steady_clock::time_point trace_last_flush_;
+    std::vector<CacheEventRecord> trace_buffer_;
+    
+    // Дорожки кэшей в захвате ZoneProfiler (индекс - CacheNameId), только поток сбора
+    std::vector<ZoneTrackId> zone_tracks_;
+    
     // Метрики
     std::unordered_map<std::string, CacheMetrics> cache_metrics_;
     mutable std::shared_mutex metrics_mutex_;
@@ -260,12 +333,18 @@ private:
     mutable std::mutex log_mutex_;
     
     // Внутренние методы
+    CacheEventRing* GetThreadRing();
+    void DrainWorker();
+    void ProcessRecords(const std::vector<CacheEventRecord>& records);
+    std::chrono::steady_clock::time_point CyclesToTimePoint(uint64_t cycles) const;
+    void WriteTrace(const std::vector<CacheEventRecord>& records);
+    void RecordZoneEvents(const std::vector<CacheEventRecord>& records);
     void SnapshotWorker();
     void PatternAnalysisWorker();
     void ReportWorker();
     
     // Анализ
-    void UpdateAccessPattern(const std::string& key);
+    void UpdateAccessPattern(const std::string& key, std::chrono::steady_clock::time_point timestamp);
     void AnalyzePattern(AccessPattern& pattern);
     bool IsSequentialAccess(const std::vector<std::string>& keys) const;
     double CalculateAccessInterval(const AccessPattern& pattern) const;
@@ -297,7 +376,9 @@ private:
     void CompressFile(const std::string& filename);
 };
 
-// Глобальный профайлер кэша
+// Глобальный профайлер кэша. Initialize/Shutdown останавливают прежний
+// экземпляр, но не удаляют его: ссылка из Instance(), полученная до них,
+// остается действительной, запись в остановленный профайлер отбрасывается
 class GlobalCacheProfiler {
 public:
     static CacheProfiler& Instance();
@@ -314,7 +395,11 @@ public:
     
 private:
     static std::unique_ptr<CacheProfiler> instance_;
+    static std::atomic<CacheProfiler*> active_;     // Доступ из Record* без мьютекса
+    static std::vector<std::unique_ptr<CacheProfiler>> retired_;  // Остановленные, живут до выхода
     static std::mutex instance_mutex_;
+
+    static void RetireInstance();
 };
 
 } // namespace Profiling
@@ -0,0 +1,526 @@
+#include "profiling/cache_trace.h"
+#include "profiling/cache_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <zstd.h>
+
+namespace WxeUI {
+namespace Profiling {
+
+namespace {
+
+int64_t NowNanoseconds(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+int64_t NowNanoseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// <prefix>_NNNNNN.wxt -> NNNNNN; false - чужой файл
+bool ParseSequence(const std::string& filename, const std::string& prefix, uint64_t& sequence) {
+    const std::string extension = ".wxt";
+    if (filename.size() <= prefix.size() + 1 + extension.size() ||
+        filename.compare(0, prefix.size(), prefix) != 0 || filename[prefix.size()] != '_' ||
+        filename.compare(filename.size() - extension.size(), extension.size(), extension) != 0) {
+        return false;
+    }
+
+    std::string digits = filename.substr(prefix.size() + 1, filename.size() - prefix.size() - 1 - extension.size());
+    if (digits.empty() || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+
+    sequence = std::stoull(digits);
+    return true;
+}
+
+std::vector<uint64_t> ListSequences(const std::string& directory, const std::string& prefix) {
+    std::vector<uint64_t> sequences;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        uint64_t sequence = 0;
+        if (entry.is_regular_file(error) && ParseSequence(entry.path().filename().string(), prefix, sequence)) {
+            sequences.push_back(sequence);
+        }
+    }
+    std::sort(sequences.begin(), sequences.end());
+    return sequences;
+}
+
+std::string GetBasePath(const std::string& directory, const std::string& prefix, uint64_t sequence) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "_%06llu", static_cast<unsigned long long>(sequence));
+    return (std::filesystem::path(directory) / (prefix + name)).string();
+}
+
+// <prefix>_<время UTC>[-N]: имя прогона сортируется по времени открытия
+std::string MakeRunPrefix(const std::string& directory, const std::string& prefix) {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc = {};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &utc);
+
+    std::string run = prefix + "_" + stamp;
+    for (int attempt = 1; !ListSequences(directory, run).empty(); ++attempt) {
+        run = prefix + "_" + stamp + "-" + std::to_string(attempt);
+    }
+    return run;
+}
+
+} // namespace
+
+// ============================================================================
+// CacheTraceWriter
+// ============================================================================
+
+CacheTraceWriter::CacheTraceWriter(const Config& config) : config_(config) {
+    config_.chunk_records = std::max<size_t>(config_.chunk_records, 1);
+    config_.max_files = std::max<size_t>(config_.max_files, 1);
+}
+
+CacheTraceWriter::~CacheTraceWriter() {
+    Close();
+}
+
+bool CacheTraceWriter::Open() {
+    if (IsOpen()) {
+        return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(config_.directory, error);
+
+    // Прежние прогоны - в голове кольца: предел диска общий для каталога
+    files_.clear();
+    for (const std::string& run : CacheTraceReader::ListRuns(config_.directory, config_.prefix)) {
+        for (uint64_t sequence : ListSequences(config_.directory, run)) {
+            files_.push_back(GetBasePath(config_.directory, run, sequence));
+        }
+    }
+    run_prefix_ = MakeRunPrefix(config_.directory, config_.prefix);
+    file_sequence_ = 0;
+
+    chunk_.reserve(config_.chunk_records);
+    if (config_.compress && !compression_context_) {
+        compressed_.resize(ZSTD_compressBound(config_.chunk_records * sizeof(CacheEventRecord)));
+        compression_context_ = ZSTD_createCCtx();
+    }
+
+    if (!OpenNextFile()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void CacheTraceWriter::Close() {
+    if (IsOpen()) {
+        Flush();
+        file_.close();
+        index_.close();
+    }
+
+    // Контекст сжатия создается в Open() до первого файла - освобождается и без него
+    if (compression_context_) {
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(compression_context_));
+        compression_context_ = nullptr;
+    }
+}
+
+void CacheTraceWriter::SetCacheName(CacheNameId id, const char* name) {
+    if (names_.size() <= id) {
+        names_.resize(id + 1);
+    }
+    names_[id] = name;
+    names_dirty_ = true;
+}
+
+void CacheTraceWriter::Append(const CacheEventRecord* records, size_t count) {
+    if (!IsOpen()) {
+        return;
+    }
+
+    while (count > 0) {
+        size_t batch = std::min(count, config_.chunk_records - chunk_.size());
+        chunk_.insert(chunk_.end(), records, records + batch);
+        records += batch;
+        count -= batch;
+
+        if (chunk_.size() == config_.chunk_records) {
+            WriteChunk();
+        }
+    }
+}
+
+void CacheTraceWriter::Flush() {
+    if (IsOpen() && !chunk_.empty()) {
+        WriteChunk();
+    }
+}
+
+bool CacheTraceWriter::OpenNextFile() {
+    file_.close();
+    index_.close();
+
+    uint64_t sequence = file_sequence_++;
+    file_.open(GetFilePath(sequence, ".wxt"), std::ios::binary | std::ios::trunc);
+    index_.open(GetFilePath(sequence, ".wxi"), std::ios::binary | std::ios::trunc);
+    if (!file_ || !index_) {
+        std::cerr << "Failed to open cache trace file " << GetFilePath(sequence, ".wxt") << std::endl;
+        file_.close();
+        index_.close();
+        return false;
+    }
+
+    TraceFileHeader header = {};
+    header.magic = TraceFileHeader::kMagic;
+    header.version = TraceFileHeader::kVersion;
+    header.steady_origin_ns = NowNanoseconds(std::chrono::steady_clock::now());
+    header.system_origin_ns = NowNanoseconds(std::chrono::system_clock::now());
+    header.record_size = sizeof(CacheEventRecord);
+
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_offset_ = sizeof(header);
+    bytes_written_ += sizeof(header);
+
+    // Каждый файл самодостаточен: таблица имен - в первом же чанке
+    names_dirty_ = !names_.empty();
+
+    files_.push_back(GetBasePath(config_.directory, run_prefix_, sequence));
+    RemoveOldFiles();
+    return true;
+}
+
+void CacheTraceWriter::WriteChunk() {
+    TraceChunkHeader header = {};
+    header.magic = TraceChunkHeader::kMagic;
+    header.record_count = static_cast<uint32_t>(chunk_.size());
+    header.first_ns = std::numeric_limits<int64_t>::max();
+    header.last_ns = std::numeric_limits<int64_t>::min();
+    for (const CacheEventRecord& record : chunk_) {
+        header.first_ns = std::min(header.first_ns, static_cast<int64_t>(record.timestamp));
+        header.last_ns = std::max(header.last_ns, static_cast<int64_t>(record.timestamp));
+    }
+
+    std::string names;
+    if (names_dirty_) {
+        header.flags |= kChunkHasNames;
+        for (size_t id = 0; id < names_.size(); ++id) {
+            if (names_[id].empty()) {
+                continue;
+            }
+            uint16_t name_id = static_cast<uint16_t>(id);
+            uint8_t length = static_cast<uint8_t>(std::min<size_t>(names_[id].size(), 255));
+            names.append(reinterpret_cast<const char*>(&name_id), sizeof(name_id));
+            names.push_back(static_cast<char>(length));
+            names.append(names_[id], 0, length);
+        }
+        header.name_bytes = static_cast<uint32_t>(names.size());
+        names_dirty_ = false;
+    }
+
+    const char* payload = reinterpret_cast<const char*>(chunk_.data());
+    size_t payload_size = chunk_.size() * sizeof(CacheEventRecord);
+    if (compression_context_) {
+        size_t compressed_size = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(compression_context_),
+                                                   compressed_.data(), compressed_.size(),
+                                                   payload, payload_size, config_.compression_level);
+        if (!ZSTD_isError(compressed_size)) {
+            header.flags |= kChunkCompressed;
+            payload = compressed_.data();
+            payload_size = compressed_size;
+        }
+    }
+    header.payload_bytes = static_cast<uint32_t>(payload_size);
+
+    TraceIndexEntry entry = {};
+    entry.offset = file_offset_;
+    entry.first_ns = header.first_ns;
+    entry.last_ns = header.last_ns;
+    entry.record_count = header.record_count;
+    entry.flags = header.flags;
+
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.write(names.data(), names.size());
+    file_.write(payload, payload_size);
+    file_.flush();
+
+    // Индекс - после данных: запись индекса всегда указывает на полный чанк
+    index_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    index_.flush();
+
+    size_t chunk_bytes = sizeof(header) + names.size() + payload_size;
+    file_offset_ += chunk_bytes;
+    bytes_written_ += chunk_bytes;
+    records_written_ += chunk_.size();
+    chunk_.clear();
+
+    if (file_offset_ >= config_.max_file_bytes) {
+        OpenNextFile();
+    }
+}
+
+void CacheTraceWriter::RemoveOldFiles() {
+    while (files_.size() > config_.max_files) {
+        std::error_code error;
+        std::filesystem::remove(files_.front() + ".wxt", error);
+        std::filesystem::remove(files_.front() + ".wxi", error);
+        files_.erase(files_.begin());
+    }
+}
+
+std::string CacheTraceWriter::GetFilePath(uint64_t sequence, const char* extension) const {
+    return GetBasePath(config_.directory, run_prefix_, sequence) + extension;
+}
+
+// ============================================================================
+// CacheTraceReader
+// ============================================================================
+
+bool CacheTraceReader::Open(const std::string& directory, const std::string& prefix) {
+    files_.clear();
+    first_ns_ = std::numeric_limits<int64_t>::max();
+    last_ns_ = std::numeric_limits<int64_t>::min();
+
+    std::string run = prefix;
+    std::vector<uint64_t> sequences = ListSequences(directory, run);
+    if (sequences.empty()) {
+        std::vector<std::string> runs = ListRuns(directory, prefix);
+        if (!runs.empty()) {
+            run = runs.back();
+            sequences = ListSequences(directory, run);
+        }
+    }
+
+    for (uint64_t sequence : sequences) {
+        std::string base = GetBasePath(directory, run, sequence);
+
+        TraceFile trace;
+        trace.path = base + ".wxt";
+
+        std::ifstream file(trace.path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(&trace.header), sizeof(trace.header)) ||
+            trace.header.magic != TraceFileHeader::kMagic || trace.header.version != TraceFileHeader::kVersion ||
+            trace.header.record_size != sizeof(CacheEventRecord)) {
+            continue;
+        }
+
+        // Индекс может отстать от данных или отсутствовать - тогда просмотр чанков
+        if (!LoadIndex(base + ".wxi", trace.chunks) || trace.chunks.empty()) {
+            trace.chunks.clear();
+            ScanChunks(file, trace.chunks);
+        }
+
+        for (auto it = trace.chunks.rbegin(); it != trace.chunks.rend(); ++it) {
+            if (it->flags & kChunkHasNames) {
+                ReadNames(file, *it, trace.names);
+                break;
+            }
+        }
+
+        for (const TraceIndexEntry& chunk : trace.chunks) {
+            first_ns_ = std::min(first_ns_, chunk.first_ns);
+            last_ns_ = std::max(last_ns_, chunk.last_ns);
+        }
+        files_.push_back(std::move(trace));
+    }
+
+    if (GetChunkCount() == 0) {
+        first_ns_ = last_ns_ = 0;
+    }
+    return !files_.empty();
+}
+
+std::vector<std::string> CacheTraceReader::ListRuns(const std::string& directory, const std::string& prefix) {
+    // <prefix>_<run>_NNNNNN.wxt, run - только цифры и '-' (MakeRunPrefix):
+    // файлы без прогона и файлы префиксов вида <prefix>_other не подходят
+    std::vector<std::string> runs;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string filename = entry.path().filename().string();
+        size_t separator = filename.rfind('_');
+        uint64_t sequence = 0;
+        if (!entry.is_regular_file(error) || separator == std::string::npos || separator <= prefix.size() + 1 ||
+            filename.compare(0, prefix.size() + 1, prefix + "_") != 0) {
+            continue;
+        }
+
+        std::string run = filename.substr(0, separator);
+        std::string stamp = run.substr(prefix.size() + 1);
+        if (ParseSequence(filename, run, sequence) && stamp.find('-') != std::string::npos &&
+            std::all_of(stamp.begin(), stamp.end(), [](char c) { return (c >= '0' && c <= '9') || c == '-'; })) {
+            runs.push_back(std::move(run));
+        }
+    }
+
+    std::sort(runs.begin(), runs.end());
+    runs.erase(std::unique(runs.begin(), runs.end()), runs.end());
+    return runs;
+}
+
+size_t CacheTraceReader::GetChunkCount() const {
+    size_t count = 0;
+    for (const TraceFile& file : files_) {
+        count += file.chunks.size();
+    }
+    return count;
+}
+
+size_t CacheTraceReader::ForEach(int64_t start_ns, int64_t end_ns, const EventCallback& callback) const {
+    size_t delivered = 0;
+    std::vector<CacheEventRecord> records;
+    std::vector<char> payload;
+    static const std::string kUnknownName = "unknown";
+
+    for (const TraceFile& trace : files_) {
+        std::ifstream file(trace.path, std::ios::binary);
+        if (!file) {
+            continue;
+        }
+
+        for (const TraceIndexEntry& chunk : trace.chunks) {
+            if (chunk.last_ns < start_ns || chunk.first_ns > end_ns) {
+                continue;
+            }
+
+            TraceChunkHeader header;
+            file.seekg(static_cast<std::streamoff>(chunk.offset));
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TraceChunkHeader::kMagic) {
+                break;
+            }
+
+            file.seekg(header.name_bytes, std::ios::cur);
+            payload.resize(header.payload_bytes);
+            if (!file.read(payload.data(), payload.size())) {
+                break;
+            }
+
+            records.resize(header.record_count);
+            size_t expected = records.size() * sizeof(CacheEventRecord);
+            if (header.flags & kChunkCompressed) {
+                size_t size = ZSTD_decompress(records.data(), expected, payload.data(), payload.size());
+                if (ZSTD_isError(size) || size != expected) {
+                    continue;
+                }
+            } else if (payload.size() == expected) {
+                std::memcpy(records.data(), payload.data(), expected);
+            } else {
+                continue;
+            }
+
+            for (const CacheEventRecord& record : records) {
+                int64_t timestamp = static_cast<int64_t>(record.timestamp);
+                if (timestamp < start_ns || timestamp > end_ns) {
+                    continue;
+                }
+
+                CacheTraceEvent event;
+                event.timestamp_ns = timestamp;
+                event.system_time_ns = trace.header.system_origin_ns + (timestamp - trace.header.steady_origin_ns);
+                event.key_hash = record.key_hash;
+                event.data_size = record.data_size;
+                event.duration_ns = record.duration_ns;
+                event.type = static_cast<CacheEventType>(record.type);
+                event.cache_name = record.cache < trace.names.size() && !trace.names[record.cache].empty()
+                    ? std::string_view(trace.names[record.cache]) : std::string_view(kUnknownName);
+
+                callback(event);
+                ++delivered;
+            }
+        }
+    }
+    return delivered;
+}
+
+bool CacheTraceReader::LoadIndex(const std::string& index_path, std::vector<TraceIndexEntry>& chunks) {
+    std::ifstream index(index_path, std::ios::binary);
+    if (!index) {
+        return false;
+    }
+
+    TraceIndexEntry entry;
+    while (index.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+        chunks.push_back(entry);
+    }
+    return true;
+}
+
+bool CacheTraceReader::ScanChunks(std::ifstream& file, std::vector<TraceIndexEntry>& chunks) {
+    file.clear();
+    file.seekg(sizeof(TraceFileHeader));
+
+    for (;;) {
+        uint64_t offset = static_cast<uint64_t>(file.tellg());
+        TraceChunkHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TraceChunkHeader::kMagic) {
+            break;
+        }
+
+        // Оборванный последний чанк (процесс завершился во время записи) отбрасывается
+        file.seekg(static_cast<std::streamoff>(header.name_bytes) + header.payload_bytes, std::ios::cur);
+        if (!file || file.peek() == std::char_traits<char>::eof()) {
+            file.clear();
+            file.seekg(0, std::ios::end);
+            if (static_cast<uint64_t>(file.tellg()) < offset + sizeof(header) + header.name_bytes + header.payload_bytes) {
+                break;
+            }
+        }
+
+        TraceIndexEntry entry = {};
+        entry.offset = offset;
+        entry.first_ns = header.first_ns;
+        entry.last_ns = header.last_ns;
+        entry.record_count = header.record_count;
+        entry.flags = header.flags;
+        chunks.push_back(entry);
+
+        file.seekg(static_cast<std::streamoff>(offset + sizeof(header) + header.name_bytes + header.payload_bytes));
+    }
+
+    file.clear();
+    return !chunks.empty();
+}
+
+bool CacheTraceReader::ReadNames(std::ifstream& file, const TraceIndexEntry& chunk, std::vector<std::string>& names) {
+    TraceChunkHeader header;
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(chunk.offset));
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TraceChunkHeader::kMagic) {
+        return false;
+    }
+
+    std::string table(header.name_bytes, '\0');
+    if (!file.read(table.data(), table.size())) {
+        return false;
+    }
+
+    for (size_t position = 0; position + 3 <= table.size(); ) {
+        uint16_t id;
+        std::memcpy(&id, table.data() + position, sizeof(id));
+        size_t length = static_cast<uint8_t>(table[position + 2]);
+        position += 3;
+        if (position + length > table.size()) {
+            break;
+        }
+
+        if (names.size() <= id) {
+            names.resize(id + 1);
+        }
+        names[id] = table.substr(position, length);
+        position += length;
+    }
+    return true;
+}
+
+} // namespace Profiling
+} // namespace WxeUI
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "profiling/cache_event_ring.h"
+
+namespace WxeUI {
+namespace Profiling {
+
+enum class CacheEventType;
+
+// ============================================================================
+// Формат трассы
+// ============================================================================
+//
+// Каждый CacheTraceWriter::Open() начинает прогон <prefix>_<run>, run - время
+// открытия UTC (YYYYMMDD-HHMMSS): отметки steady_clock разных процессов несравнимы,
+// поэтому прогоны не смешиваются. Прогон - файлы <prefix>_<run>_NNNNNN.wxt;
+// старейший файл каталога (сначала - прежних прогонов) удаляется, когда их
+// больше max_files. Файл: TraceFileHeader, затем чанки: TraceChunkHeader,
+// таблица имен кэшей (если kChunkHasNames), блок записей CacheEventRecord
+// (zstd-кадр при kChunkCompressed). В записях трассы timestamp - наносекунды
+// steady_clock. Рядом - индекс <prefix>_<run>_NNNNNN.wxi из TraceIndexEntry на чанк:
+// дописывается после чанка, при отсутствии читатель восстанавливает его
+// просмотром заголовков чанков
+
+struct TraceFileHeader {
+    static constexpr uint32_t kMagic = 0x54435857;     // "WXCT"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    int64_t steady_origin_ns;   // steady_clock и system_clock в момент открытия -
+    int64_t system_origin_ns;   // для перевода отметок в календарное время
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+struct TraceChunkHeader {
+    static constexpr uint32_t kMagic = 0x4B4E4843;     // "CHNK"
+
+    uint32_t magic;
+    uint32_t flags;
+    uint32_t record_count;
+    uint32_t name_bytes;        // Таблица имен: [id u16][длина u8][символы]...
+    uint32_t payload_bytes;     // Блок записей (сжатый или нет)
+    uint32_t reserved;
+    int64_t first_ns;           // Минимальная и максимальная отметки чанка: записи
+    int64_t last_ns;            // потоков внутри чанка не упорядочены по времени
+};
+
+struct TraceIndexEntry {
+    uint64_t offset;            // Смещение TraceChunkHeader в файле
+    int64_t first_ns;
+    int64_t last_ns;
+    uint32_t record_count;
+    uint32_t flags;
+};
+
+constexpr uint32_t kChunkCompressed = 1;
+constexpr uint32_t kChunkHasNames = 2;
+
+static_assert(sizeof(TraceFileHeader) == 32, "trace file header layout");
+static_assert(sizeof(TraceChunkHeader) == 40, "trace chunk header layout");
+static_assert(sizeof(TraceIndexEntry) == 32, "trace index entry layout");
+
+// ============================================================================
+// Запись
+// ============================================================================
+
+// Потоковая запись трассы с постоянной памятью: один буфер чанка и один буфер
+// сжатия. Не потокобезопасен - пишет поток сбора CacheProfiler
+class CacheTraceWriter {
+public:
+    struct Config {
+        Config() {}
+
+        std::string directory = "cache_logs";
+        std::string prefix = "cache_trace";
+        size_t chunk_records = 16384;                   // 512 КБ несжатых записей
+        size_t max_file_bytes = 64 * 1024 * 1024;       // Ротация файла
+        size_t max_files = 16;                          // Предел диска: max_files * max_file_bytes
+        bool compress = true;
+        int compression_level = 3;
+    };
+
+    explicit CacheTraceWriter(const Config& config = Config{});
+    ~CacheTraceWriter();
+
+    CacheTraceWriter(const CacheTraceWriter&) = delete;
+    CacheTraceWriter& operator=(const CacheTraceWriter&) = delete;
+
+    // Новый прогон; файлы прежних прогонов входят в кольцо и удаляются первыми
+    bool Open();
+    void Close();
+    bool IsOpen() const { return file_.is_open(); }
+
+    // <prefix>_<run> текущего прогона - для CacheTraceReader::Open
+    const std::string& GetRunPrefix() const { return run_prefix_; }
+
+    // Имя попадает в следующий чанк и в первый чанк каждого нового файла
+    void SetCacheName(CacheNameId id, const char* name);
+
+    // timestamp записей - наносекунды steady_clock
+    void Append(const CacheEventRecord* records, size_t count);
+
+    // Неполный чанк - на диск (периодически, чтобы трасса не отставала)
+    void Flush();
+
+    uint64_t GetBytesWritten() const { return bytes_written_; }
+    uint64_t GetRecordsWritten() const { return records_written_; }
+
+private:
+    Config config_;
+    std::ofstream file_;
+    std::ofstream index_;
+    std::string run_prefix_;
+    uint64_t file_sequence_ = 0;
+    uint64_t file_offset_ = 0;
+    std::vector<std::string> files_;                // Файлы кольца без расширения, старые первыми
+
+    std::vector<CacheEventRecord> chunk_;
+    std::vector<char> compressed_;
+    void* compression_context_ = nullptr;
+
+    std::vector<std::string> names_;                // Индекс - CacheNameId
+    bool names_dirty_ = false;
+
+    uint64_t bytes_written_ = 0;
+    uint64_t records_written_ = 0;
+
+    bool OpenNextFile();
+    void WriteChunk();
+    void RemoveOldFiles();
+    std::string GetFilePath(uint64_t sequence, const char* extension) const;
+};
+
+// ============================================================================
+// Чтение
+// ============================================================================
+
+struct CacheTraceEvent {
+    int64_t timestamp_ns;           // steady_clock записавшего процесса
+    int64_t system_time_ns;         // system_clock (по опорной точке файла)
+    uint64_t key_hash;
+    uint64_t data_size;
+    uint32_t duration_ns;
+    CacheEventType type;
+    std::string_view cache_name;    // Действительна на время callback
+};
+
+// Офлайн-анализ трассы: поиск по времени через индексы - чанки вне диапазона
+// не читаются и не распаковываются
+class CacheTraceReader {
+public:
+    using EventCallback = std::function<void(const CacheTraceEvent&)>;
+
+    // prefix - прогон (<prefix>_<run>); базовый префикс без своих файлов - его последний прогон
+    bool Open(const std::string& directory, const std::string& prefix = "cache_trace");
+
+    // Прогоны каталога (<prefix>_<run>), старые первыми
+    static std::vector<std::string> ListRuns(const std::string& directory, const std::string& prefix = "cache_trace");
+
+    // Диапазон отметок всей трассы (steady_clock, нс)
+    int64_t GetFirstTimestamp() const { return first_ns_; }
+    int64_t GetLastTimestamp() const { return last_ns_; }
+    size_t GetFileCount() const { return files_.size(); }
+    size_t GetChunkCount() const;
+
+    // События с отметкой в [start_ns, end_ns]; возвращает их число
+    size_t ForEach(int64_t start_ns, int64_t end_ns, const EventCallback& callback) const;
+    size_t ForEach(const EventCallback& callback) const {
+        return ForEach(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), callback);
+    }
+
+private:
+    struct TraceFile {
+        std::string path;
+        TraceFileHeader header;
+        std::vector<TraceIndexEntry> chunks;
+        std::vector<std::string> names;     // Из последнего чанка с таблицей имен - надмножество
+    };
+
+    std::vector<TraceFile> files_;
+    int64_t first_ns_ = 0;
+    int64_t last_ns_ = 0;
+
+    static bool LoadIndex(const std::string& index_path, std::vector<TraceIndexEntry>& chunks);
+    static bool ScanChunks(std::ifstream& file, std::vector<TraceIndexEntry>& chunks);
+    static bool ReadNames(std::ifstream& file, const TraceIndexEntry& chunk, std::vector<std::string>& names);
+};
+
+} // namespace Profiling
+} // namespace WxeUI
@@ -0,0 +1,339 @@
+#include "profiling/hardware_counters.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace WxeUI {
+namespace Profiling {
+
+namespace {
+
+struct ThreadCounters {
+    std::unique_ptr<HardwareCounterGroup> group;
+    uint64_t generation = 0;
+};
+
+thread_local ThreadCounters t_counters;
+
+#if defined(__linux__)
+struct CounterEvent {
+    uint32_t type;
+    uint64_t config;
+};
+
+// В порядке HardwareCounter. Программный счетчик последним: если PMU нет,
+// он становится лидером группы один
+constexpr CounterEvent kCounterEvents[kHardwareCounterCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int OpenCounter(const CounterEvent& event, bool include_kernel, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = group_fd == -1;     // Группа включается целиком после открытия
+    attr.exclude_kernel = !include_kernel;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // pid 0, cpu -1: вызывающий поток на любом ядре
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+} // namespace
+
+const char* GetHardwareCounterName(HardwareCounter counter) {
+    switch (counter) {
+        case HardwareCounter::CYCLES: return "cycles";
+        case HardwareCounter::INSTRUCTIONS: return "instructions";
+        case HardwareCounter::CACHE_REFERENCES: return "cache-references";
+        case HardwareCounter::CACHE_MISSES: return "cache-misses";
+        case HardwareCounter::BRANCH_MISSES: return "branch-misses";
+        case HardwareCounter::PAGE_FAULTS: return "page-faults";
+        default: return "unknown";
+    }
+}
+
+// ============================================================================
+// HardwareCounterValues
+// ============================================================================
+
+HardwareCounterValues HardwareCounterValues::operator-(const HardwareCounterValues& begin) const {
+    HardwareCounterValues delta;
+    delta.valid_mask = valid_mask & begin.valid_mask;
+    for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+        delta.values[i] = values[i] > begin.values[i] ? values[i] - begin.values[i] : 0;
+    }
+    return delta;
+}
+
+HardwareCounterValues& HardwareCounterValues::operator+=(const HardwareCounterValues& other) {
+    // Первое накопление задает набор счетчиков
+    valid_mask = valid_mask ? (valid_mask & other.valid_mask) : other.valid_mask;
+    for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+double HardwareCounterValues::GetIPC() const {
+    uint64_t cycles = Get(HardwareCounter::CYCLES);
+    if (!Has(HardwareCounter::CYCLES) || !Has(HardwareCounter::INSTRUCTIONS) || cycles == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(Get(HardwareCounter::INSTRUCTIONS)) / static_cast<double>(cycles);
+}
+
+double HardwareCounterValues::GetLLCMissRate() const {
+    uint64_t references = Get(HardwareCounter::CACHE_REFERENCES);
+    if (!Has(HardwareCounter::CACHE_REFERENCES) || !Has(HardwareCounter::CACHE_MISSES) || references == 0) {
+        return 0.0;
+    }
+    return std::min(1.0, static_cast<double>(Get(HardwareCounter::CACHE_MISSES)) / static_cast<double>(references));
+}
+
+double HardwareCounterValues::GetMissesPerKiloInstruction(HardwareCounter counter) const {
+    uint64_t instructions = Get(HardwareCounter::INSTRUCTIONS);
+    if (!Has(counter) || !Has(HardwareCounter::INSTRUCTIONS) || instructions == 0) {
+        return 0.0;
+    }
+    return 1000.0 * static_cast<double>(Get(counter)) / static_cast<double>(instructions);
+}
+
+// ============================================================================
+// HardwareCounterGroup
+// ============================================================================
+
+bool HardwareCounterGroup::IsSupported() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HardwareCounterGroup::Open(const Config& config) {
+    Close();
+
+#if defined(__linux__)
+    int leader = -1;
+    for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+        int fd = OpenCounter(kCounterEvents[i], config.include_kernel, leader);
+        if (fd < 0) {
+            continue;
+        }
+        if (leader == -1) {
+            leader = fd;
+        }
+        fds_[i] = fd;
+        order_[count_++] = static_cast<HardwareCounter>(i);
+        available_mask_ |= 1u << i;
+    }
+
+    if (leader == -1) {
+        return false;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+void HardwareCounterGroup::Close() {
+#if defined(__linux__)
+    // Члены группы - до лидера
+    for (size_t i = kHardwareCounterCount; i-- > 0; ) {
+        if (fds_[i] >= 0) {
+            close(fds_[i]);
+        }
+    }
+#endif
+    std::fill(std::begin(fds_), std::end(fds_), -1);
+    count_ = 0;
+    available_mask_ = 0;
+}
+
+bool HardwareCounterGroup::Read(HardwareCounterValues& values) const {
+    values = HardwareCounterValues();
+    if (count_ == 0) {
+        return false;
+    }
+
+#if defined(__linux__)
+    // nr, time_enabled, time_running, значения в порядке открытия
+    uint64_t buffer[3 + kHardwareCounterCount];
+    int leader = fds_[static_cast<size_t>(order_[0])];
+    ssize_t bytes = read(leader, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != count_) {
+        return false;
+    }
+
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    if (running == 0) {
+        return false;                   // Группа еще не получала PMU
+    }
+
+    // Счетчиков больше, чем регистров PMU: ядро мультиплексирует группы,
+    // значения экстраполируются на все время включения
+    double scale = running < enabled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+    for (size_t i = 0; i < count_; ++i) {
+        size_t index = static_cast<size_t>(order_[i]);
+        values.values[index] = scale == 1.0 ? buffer[3 + i]
+                                            : static_cast<uint64_t>(static_cast<double>(buffer[3 + i]) * scale);
+    }
+    values.valid_mask = available_mask_;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// HardwareCounterProfiler
+// ============================================================================
+
+HardwareCounterProfiler& HardwareCounterProfiler::Get() {
+    static HardwareCounterProfiler instance;
+    return instance;
+}
+
+void HardwareCounterProfiler::Enable(const HardwareCounterGroup::Config& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+    }
+    generation_.fetch_add(1, std::memory_order_release);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void HardwareCounterProfiler::Disable() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+bool HardwareCounterProfiler::Sample(HardwareCounterValues& values) {
+    if (!enabled_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Группа потока открывается при первом замере и после каждого Enable;
+    // неудачная попытка не повторяется до следующего Enable
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (t_counters.generation != generation) {
+        t_counters.generation = generation;
+        if (!t_counters.group) {
+            t_counters.group = std::make_unique<HardwareCounterGroup>();
+        }
+
+        HardwareCounterGroup::Config config;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            config = config_;
+        }
+        t_counters.group->Open(config);
+    }
+
+    return t_counters.group && t_counters.group->Read(values);
+}
+
+void HardwareCounterProfiler::Accumulate(const std::string& subsystem, const HardwareCounterValues& delta) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SubsystemCounters& entry = subsystems_[subsystem];
+    if (entry.name.empty()) {
+        entry.name = subsystem;
+    }
+    entry.samples++;
+    entry.totals += delta;
+}
+
+std::vector<SubsystemCounters> HardwareCounterProfiler::GetReport() const {
+    std::vector<SubsystemCounters> report;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report.reserve(subsystems_.size());
+        for (const auto& [name, entry] : subsystems_) {
+            report.push_back(entry);
+        }
+    }
+
+    std::sort(report.begin(), report.end(), [](const SubsystemCounters& a, const SubsystemCounters& b) {
+        uint64_t cycles_a = a.totals.Get(HardwareCounter::CYCLES);
+        uint64_t cycles_b = b.totals.Get(HardwareCounter::CYCLES);
+        return cycles_a != cycles_b ? cycles_a > cycles_b : a.name < b.name;
+    });
+    return report;
+}
+
+std::string HardwareCounterProfiler::FormatReport() const {
+    std::vector<SubsystemCounters> report = GetReport();
+
+    std::string result;
+    char line[512];
+    std::snprintf(line, sizeof(line), "%-28s %10s %14s %14s %7s %10s %10s %8s %8s %10s\n",
+                  "subsystem", "samples", "cycles", "instructions", "IPC", "LLC refs", "LLC miss", "miss %",
+                  "br MPKI", "faults");
+    result += line;
+
+    // Недоступные счетчики - прочерк, а не 0
+    char columns[kHardwareCounterCount + 3][32];
+    for (const auto& entry : report) {
+        const HardwareCounterValues& totals = entry.totals;
+        for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+            HardwareCounter counter = static_cast<HardwareCounter>(i);
+            if (totals.Has(counter)) {
+                std::snprintf(columns[i], sizeof(columns[i]), "%llu",
+                              static_cast<unsigned long long>(totals.Get(counter)));
+            } else {
+                std::snprintf(columns[i], sizeof(columns[i]), "-");
+            }
+        }
+
+        bool has_ipc = totals.Has(HardwareCounter::CYCLES) && totals.Has(HardwareCounter::INSTRUCTIONS);
+        bool has_llc = totals.Has(HardwareCounter::CACHE_REFERENCES) && totals.Has(HardwareCounter::CACHE_MISSES);
+        bool has_branch = totals.Has(HardwareCounter::BRANCH_MISSES) && totals.Has(HardwareCounter::INSTRUCTIONS);
+        char* ipc = columns[kHardwareCounterCount];
+        char* miss_rate = columns[kHardwareCounterCount + 1];
+        char* branch_mpki = columns[kHardwareCounterCount + 2];
+        std::snprintf(ipc, 32, has_ipc ? "%.2f" : "-", totals.GetIPC());
+        std::snprintf(miss_rate, 32, has_llc ? "%.2f%%" : "-", totals.GetLLCMissRate() * 100.0);
+        std::snprintf(branch_mpki, 32, has_branch ? "%.2f" : "-",
+                      totals.GetMissesPerKiloInstruction(HardwareCounter::BRANCH_MISSES));
+
+        std::snprintf(line, sizeof(line), "%-28s %10llu %14s %14s %7s %10s %10s %8s %8s %10s\n",
+                      entry.name.c_str(), static_cast<unsigned long long>(entry.samples),
+                      columns[static_cast<size_t>(HardwareCounter::CYCLES)],
+                      columns[static_cast<size_t>(HardwareCounter::INSTRUCTIONS)], ipc,
+                      columns[static_cast<size_t>(HardwareCounter::CACHE_REFERENCES)],
+                      columns[static_cast<size_t>(HardwareCounter::CACHE_MISSES)], miss_rate, branch_mpki,
+                      columns[static_cast<size_t>(HardwareCounter::PAGE_FAULTS)]);
+        result += line;
+    }
+    return result;
+}
+
+void HardwareCounterProfiler::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subsystems_.clear();
+}
+
+} // namespace Profiling
+} // namespace WxeUI
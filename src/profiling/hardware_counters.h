@@ -0,0 +1,163 @@
+#pragma once
+
+#include "profiling/zone_profiler.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WxeUI {
+namespace Profiling {
+
+// ============================================================================
+// Аппаратные счетчики производительности
+// ============================================================================
+//
+// Linux: perf_event_open, группа счетчиков потока читается одним read().
+// Прочие платформы и ядра без доступа к PMU (виртуальные машины,
+// perf_event_paranoid > 2) - счетчики недоступны, замеры пустые.
+// Счетчики считают только пользовательский режим, если не задано иное
+
+enum class HardwareCounter : uint8_t {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_REFERENCES,   // Обращения к последнему уровню кэша (LLC)
+    CACHE_MISSES,       // Промахи LLC
+    BRANCH_MISSES,
+    PAGE_FAULTS,        // Программный счетчик ядра
+    COUNT
+};
+
+constexpr size_t kHardwareCounterCount = static_cast<size_t>(HardwareCounter::COUNT);
+
+const char* GetHardwareCounterName(HardwareCounter counter);
+
+struct HardwareCounterValues {
+    uint64_t values[kHardwareCounterCount] = {};
+    uint32_t valid_mask = 0;        // Бит на открытый счетчик
+
+    uint64_t Get(HardwareCounter counter) const { return values[static_cast<size_t>(counter)]; }
+    bool Has(HardwareCounter counter) const { return (valid_mask >> static_cast<unsigned>(counter)) & 1u; }
+
+    // Разность замеров (счетчики монотонны; после масштабирования возможен
+    // небольшой откат - тогда 0)
+    HardwareCounterValues operator-(const HardwareCounterValues& begin) const;
+    HardwareCounterValues& operator+=(const HardwareCounterValues& other);
+
+    // 0, если нужных счетчиков нет
+    double GetIPC() const;
+    double GetLLCMissRate() const;              // Промахи / обращения к LLC, 0..1
+    double GetMissesPerKiloInstruction(HardwareCounter counter) const;
+};
+
+// Счетчики вызывающего потока. Открываются и читаются в одном потоке
+class HardwareCounterGroup {
+public:
+    struct Config {
+        Config() {}
+
+        bool include_kernel = false;    // При perf_event_paranoid >= 2 открытие не удастся
+    };
+
+    HardwareCounterGroup() = default;
+    ~HardwareCounterGroup() { Close(); }
+
+    HardwareCounterGroup(const HardwareCounterGroup&) = delete;
+    HardwareCounterGroup& operator=(const HardwareCounterGroup&) = delete;
+
+    // true, если открыт хотя бы один счетчик; недоступные пропускаются
+    bool Open(const Config& config = Config{});
+    void Close();
+    bool IsOpen() const { return count_ > 0; }
+    uint32_t GetAvailableMask() const { return available_mask_; }
+
+    // Текущие значения с начала Open, с поправкой на мультиплексирование PMU
+    bool Read(HardwareCounterValues& values) const;
+
+    static bool IsSupported();
+
+private:
+    int fds_[kHardwareCounterCount] = {-1, -1, -1, -1, -1, -1};
+    HardwareCounter order_[kHardwareCounterCount] = {};     // Порядок значений в чтении группы
+    size_t count_ = 0;
+    uint32_t available_mask_ = 0;
+};
+
+// ============================================================================
+// Сводка по подсистемам
+// ============================================================================
+
+struct SubsystemCounters {
+    std::string name;
+    uint64_t samples = 0;
+    HardwareCounterValues totals;
+};
+
+// Замеры накапливаются по имени подсистемы (зоны WXE_COUNTED_ZONE, участки
+// и кадры PerformanceMonitor). Группы счетчиков открываются лениво в каждом
+// потоке, который делает замер. Вложенные замеры включают дочерние
+class HardwareCounterProfiler {
+public:
+    static HardwareCounterProfiler& Get();
+
+    void Enable(const HardwareCounterGroup::Config& config = HardwareCounterGroup::Config{});
+    void Disable();
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Замер счетчиков потока; false - выключено или недоступно
+    bool Sample(HardwareCounterValues& values);
+
+    void Accumulate(const std::string& subsystem, const HardwareCounterValues& delta);
+
+    std::vector<SubsystemCounters> GetReport() const;  // По убыванию циклов
+    std::string FormatReport() const;
+    void Reset();
+
+private:
+    HardwareCounterProfiler() = default;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> generation_{0};   // Поток переоткрывает группу при смене конфигурации
+    HardwareCounterGroup::Config config_;
+
+    std::unordered_map<std::string, SubsystemCounters> subsystems_;
+    mutable std::mutex mutex_;
+};
+
+// Зона профилирования со счетчиками: в трассе - как WXE_ZONE, разность
+// счетчиков добавляется к подсистеме с именем зоны. Замер - системный вызов
+// на каждом конце, поэтому для крупных участков (проход кэша, ядро пикселей),
+// а не для каждой мелкой функции
+class ScopedCounterZone {
+public:
+    explicit ScopedCounterZone(const char* name) : zone_(name), name_(name) {
+        sampled_ = HardwareCounterProfiler::Get().Sample(begin_);
+    }
+
+    ~ScopedCounterZone() {
+        HardwareCounterValues end;
+        if (sampled_ && HardwareCounterProfiler::Get().Sample(end)) {
+            HardwareCounterProfiler::Get().Accumulate(name_, end - begin_);
+        }
+    }
+
+    ScopedCounterZone(const ScopedCounterZone&) = delete;
+    ScopedCounterZone& operator=(const ScopedCounterZone&) = delete;
+
+private:
+    ScopedZone zone_;
+    const char* name_;
+    HardwareCounterValues begin_;
+    bool sampled_ = false;
+};
+
+} // namespace Profiling
+} // namespace WxeUI
+
+#ifndef WXE_DISABLE_ZONES
+#define WXE_COUNTED_ZONE(name) ::WxeUI::Profiling::ScopedCounterZone WXE_ZONE_CONCAT(wxe_counted_zone_, __LINE__)(name)
+#else
+#define WXE_COUNTED_ZONE(name) ((void)0)
+#endif
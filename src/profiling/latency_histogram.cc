@@ -0,0 +1,149 @@
+#include "profiling/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace WxeUI {
+namespace Profiling {
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+        if (count) {
+            counts_[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    total_count_.fetch_add(other.total_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total_sum_.fetch_add(other.total_sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t other_max = other.max_.load(std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (other_max > max && !max_.compare_exchange_weak(max, other_max, std::memory_order_relaxed)) {
+    }
+    uint64_t other_min = other.min_.load(std::memory_order_relaxed);
+    uint64_t min = min_.load(std::memory_order_relaxed);
+    while (other_min < min && !min_.compare_exchange_weak(min, other_min, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total_count_.store(0, std::memory_order_relaxed);
+    total_sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetMean() const {
+    uint64_t count = GetCount();
+    return count ? static_cast<double>(total_sum_.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (const auto& count : counts_) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(GetBucketUpperBound(i), GetMax());
+        }
+    }
+    return GetMax();
+}
+
+LatencyHistogram::Summary LatencyHistogram::GetSummary() const {
+    Summary summary;
+    summary.count = GetCount();
+    summary.min = GetMin();
+    summary.mean = GetMean();
+    summary.p50 = GetPercentile(50.0);
+    summary.p90 = GetPercentile(90.0);
+    summary.p99 = GetPercentile(99.0);
+    summary.p999 = GetPercentile(99.9);
+    summary.max = GetMax();
+    return summary;
+}
+
+void LatencyHistogram::WritePercentileDistribution(std::ostream& out, double value_scale,
+                                                   unsigned ticks_per_half_distance) const {
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    char line[128];
+    out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+
+    // Шаг перцентилей уменьшается вдвое с каждой половиной оставшегося
+    // расстояния до 100% - как в HdrHistogram
+    uint64_t seen = 0;
+    double next_percentile = 0.0;
+    for (size_t i = 0; i < kBucketCount && total; ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        seen += counts[i];
+
+        double reached = 100.0 * static_cast<double>(seen) / static_cast<double>(total);
+        if (reached < next_percentile && seen != total) {
+            continue;
+        }
+
+        double value = static_cast<double>(std::min(GetBucketUpperBound(i), GetMax())) / value_scale;
+        if (seen == total) {
+            std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu\n", value, 1.0,
+                          static_cast<unsigned long long>(seen));
+        } else {
+            std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu %14.2f\n", value, reached / 100.0,
+                          static_cast<unsigned long long>(seen), 1.0 / (1.0 - reached / 100.0));
+        }
+        out << line;
+
+        double remaining = 100.0 - reached;
+        double half_distance = std::pow(2.0, std::floor(std::log2(100.0 / std::max(remaining, 1e-9))) + 1.0);
+        next_percentile = reached + 100.0 / (half_distance * ticks_per_half_distance);
+    }
+
+    Summary summary = GetSummary();
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, Max        = %12.3f]\n",
+                  summary.mean / value_scale, static_cast<double>(summary.max) / value_scale);
+    out << line;
+    std::snprintf(line, sizeof(line), "#[Total count    = %12llu]\n", static_cast<unsigned long long>(summary.count));
+    out << line;
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(size_t index) {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / kSubBuckets) - 1;
+    uint64_t sub_bucket = index - static_cast<uint64_t>(shift) * kSubBuckets;
+    return sub_bucket << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index) {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / kSubBuckets) - 1;
+    uint64_t sub_bucket = index - static_cast<uint64_t>(shift) * kSubBuckets;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+} // namespace Profiling
+} // namespace WxeUI
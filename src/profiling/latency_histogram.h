@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace WxeUI {
+namespace Profiling {
+
+// Гистограмма задержек в стиле HDR: логарифмические группы по степеням двойки,
+// каждая делится на kSubBuckets линейных корзин - относительная погрешность
+// не больше 1/kSubBuckets (~1.6%) во всем диапазоне от 1 нс до ~68 с.
+// Запись - одна атомарная операция без блокировок, из любых потоков;
+// гистограммы окон и потоков объединяются через Merge
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 6;
+    static constexpr uint64_t kSubBuckets = 1ull << kSubBucketBits;        // Корзин в группе
+    static constexpr unsigned kMaxValueBits = 36;                           // 2^36 нс ~ 68.7 с
+    static constexpr uint64_t kMaxValue = (1ull << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount = 2 * kSubBuckets + (kMaxValueBits - kSubBucketBits - 1) * kSubBuckets;
+
+    LatencyHistogram() { Reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Значения сверх kMaxValue попадают в последнюю корзину
+    void Record(uint64_t value_ns) {
+        counts_[GetBucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        total_count_.fetch_add(1, std::memory_order_relaxed);
+        total_sum_.fetch_add(value_ns, std::memory_order_relaxed);
+
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (value_ns > max && !max_.compare_exchange_weak(max, value_ns, std::memory_order_relaxed)) {
+        }
+        uint64_t min = min_.load(std::memory_order_relaxed);
+        while (value_ns < min && !min_.compare_exchange_weak(min, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    template<typename Rep, typename Period>
+    void Record(std::chrono::duration<Rep, Period> duration) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        Record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    void RecordMilliseconds(float ms) { Record(ms > 0.0f ? static_cast<uint64_t>(ms * 1e6) : 0); }
+
+    // Прибавляет счетчики other; other может записываться в это время
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t GetCount() const { return total_count_.load(std::memory_order_relaxed); }
+    uint64_t GetMin() const { return GetCount() ? min_.load(std::memory_order_relaxed) : 0; }
+    uint64_t GetMax() const { return max_.load(std::memory_order_relaxed); }
+    double GetMean() const;
+
+    // Значение, не меньшее percentile процентов записей (percentile в [0, 100]):
+    // верхняя граница корзины, не больше GetMax()
+    uint64_t GetPercentile(double percentile) const;
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t min = 0;
+        double mean = 0.0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+        uint64_t max = 0;
+    };
+    Summary GetSummary() const;
+
+    // Распределение в текстовом формате HdrHistogram (.hgrm), value_scale -
+    // делитель значений (1e6 - миллисекунды)
+    void WritePercentileDistribution(std::ostream& out, double value_scale = 1e6,
+                                     unsigned ticks_per_half_distance = 5) const;
+
+    static size_t GetBucketIndex(uint64_t value) {
+        if (value > kMaxValue) {
+            value = kMaxValue;
+        }
+        if (value < 2 * kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+
+        // value >> shift попадает в [kSubBuckets, 2 * kSubBuckets)
+        unsigned shift = static_cast<unsigned>(std::bit_width(value)) - kSubBucketBits - 1;
+        return static_cast<size_t>(kSubBuckets + shift * kSubBuckets + (value >> shift) - kSubBuckets);
+    }
+
+    static uint64_t GetBucketLowerBound(size_t index);
+    static uint64_t GetBucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> total_count_;
+    std::atomic<uint64_t> total_sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace Profiling
+} // namespace WxeUI
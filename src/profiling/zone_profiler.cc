@@ -0,0 +1,557 @@
+#include "profiling/zone_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+namespace WxeUI {
+namespace Profiling {
+
+// Буфер потока: пишет только поток-владелец, остальные читают записи
+// [0, count) захвата generation. Сброс при новом захвате - тоже владельцем
+struct ZoneProfiler::ThreadBuffer {
+    std::unique_ptr<ZoneRecord[]> records;
+    size_t capacity = 0;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> generation{0};
+    std::atomic<uint64_t> dropped{0};
+    ZoneTrackId track = 0;
+};
+
+namespace {
+
+struct ThreadZoneState {
+    std::shared_ptr<void> buffer;   // ZoneProfiler::ThreadBuffer
+    uint16_t depth = 0;
+};
+
+thread_local ThreadZoneState t_zone_state;
+
+// Идентификаторы в трассе: процесс - 1, дорожки - с 1
+constexpr int kTracePid = 1;
+constexpr uint64_t kProcessTrackUuid = 1;
+constexpr uint64_t kTrackUuidBase = 0x100;
+constexpr uint64_t kCounterTrackUuidBase = 0x1000000;
+
+void WriteJsonString(std::string& out, const char* text) {
+    out.push_back('"');
+    for (const char* c = text; *c; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            out.push_back('\\');
+            out.push_back(*c);
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out += escaped;
+        } else {
+            out.push_back(*c);
+        }
+    }
+    out.push_back('"');
+}
+
+// Минимальная запись protobuf: varint, fixed64 и вложенные сообщения
+class ProtoWriter {
+public:
+    void Varint(uint32_t field, uint64_t value) {
+        Tag(field, 0);
+        Raw(value);
+    }
+
+    void Double(uint32_t field, double value) {
+        Tag(field, 1);
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            data_.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void Bytes(uint32_t field, const std::string& value) {
+        Tag(field, 2);
+        Raw(value.size());
+        data_ += value;
+    }
+
+    void Message(uint32_t field, const ProtoWriter& message) { Bytes(field, message.data_); }
+
+    const std::string& Data() const { return data_; }
+
+private:
+    std::string data_;
+
+    void Tag(uint32_t field, uint32_t wire_type) { Raw((static_cast<uint64_t>(field) << 3) | wire_type); }
+
+    void Raw(uint64_t value) {
+        while (value >= 0x80) {
+            data_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        data_.push_back(static_cast<char>(value));
+    }
+};
+
+// Поля perfetto/trace/trace_packet.proto и track_event/*.proto
+namespace perfetto_fields {
+constexpr uint32_t kTracePacket = 1;                // Trace.packet
+
+constexpr uint32_t kTimestamp = 8;                  // TracePacket
+constexpr uint32_t kSequenceId = 10;
+constexpr uint32_t kTrackEvent = 11;
+constexpr uint32_t kSequenceFlags = 13;
+constexpr uint32_t kTimestampClockId = 58;
+constexpr uint32_t kTrackDescriptor = 60;
+
+constexpr uint32_t kTrackUuid = 1;                  // TrackDescriptor
+constexpr uint32_t kTrackName = 2;
+constexpr uint32_t kTrackProcess = 3;
+constexpr uint32_t kTrackThread = 4;
+constexpr uint32_t kTrackParentUuid = 5;
+constexpr uint32_t kTrackCounter = 8;
+
+constexpr uint32_t kPid = 1;                        // ProcessDescriptor / ThreadDescriptor
+constexpr uint32_t kTid = 2;
+constexpr uint32_t kThreadName = 5;
+constexpr uint32_t kProcessName = 6;
+
+constexpr uint32_t kEventType = 9;                  // TrackEvent
+constexpr uint32_t kEventTrackUuid = 11;
+constexpr uint32_t kEventName = 23;
+constexpr uint32_t kEventDoubleCounterValue = 44;
+
+constexpr uint64_t kSliceBegin = 1;                 // TrackEvent.Type
+constexpr uint64_t kSliceEnd = 2;
+constexpr uint64_t kInstant = 3;
+constexpr uint64_t kCounter = 4;
+
+constexpr uint64_t kIncrementalStateCleared = 1;
+constexpr uint64_t kClockMonotonic = 3;             // BuiltinClock
+constexpr uint64_t kSequence = 1;
+}
+
+} // namespace
+
+ZoneProfiler& ZoneProfiler::Get() {
+    static ZoneProfiler profiler;
+    return profiler;
+}
+
+// ============================================================================
+// Захват
+// ============================================================================
+
+void ZoneProfiler::StartCapture(const Config& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Буферы завершившихся потоков больше не нужны: держит только список
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+        return buffer.use_count() == 1;
+    }), buffers_.end());
+
+    records_per_thread_.store(std::max<size_t>(config.records_per_thread, 1), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    capturing_.store(true, std::memory_order_relaxed);
+}
+
+void ZoneProfiler::StopCapture() {
+    capturing_.store(false, std::memory_order_relaxed);
+}
+
+int64_t ZoneProfiler::BeginZone() {
+    ++t_zone_state.depth;
+    return Get().IsCapturing() ? Now() : 0;
+}
+
+void ZoneProfiler::EndZone(const char* name, int64_t begin_ns) {
+    uint16_t depth = --t_zone_state.depth;
+
+    // begin_ns == 0: зона открыта до начала захвата
+    ZoneProfiler& profiler = Get();
+    if (begin_ns == 0 || !profiler.IsCapturing()) {
+        return;
+    }
+
+    ZoneRecord record;
+    record.begin_ns = begin_ns;
+    record.end_ns = Now();
+    record.name = name;
+    record.depth = depth;
+    record.kind = ZoneRecordKind::ZONE;
+    record.reserved = 0;
+
+    ThreadBuffer* buffer = profiler.GetThreadBuffer();
+    record.track = buffer->track;
+    profiler.Append(buffer, record);
+}
+
+void ZoneProfiler::Counter(const char* name, double value) {
+    ZoneProfiler& profiler = Get();
+    if (!profiler.IsCapturing()) {
+        return;
+    }
+
+    ZoneRecord record;
+    record.begin_ns = Now();
+    record.value = value;
+    record.name = name;
+    record.depth = 0;
+    record.kind = ZoneRecordKind::COUNTER;
+    record.reserved = 0;
+
+    ThreadBuffer* buffer = profiler.GetThreadBuffer();
+    record.track = buffer->track;
+    profiler.Append(buffer, record);
+}
+
+void ZoneProfiler::RecordInstant(ZoneTrackId track, const char* name, int64_t timestamp_ns, uint64_t argument) {
+    if (!IsCapturing()) {
+        return;
+    }
+
+    ZoneRecord record;
+    record.begin_ns = timestamp_ns;
+    record.argument = argument;
+    record.name = name;
+    record.track = track;
+    record.depth = 0;
+    record.kind = ZoneRecordKind::INSTANT;
+    record.reserved = 0;
+    Append(GetThreadBuffer(), record);
+}
+
+void ZoneProfiler::RecordZone(ZoneTrackId track, const char* name, int64_t begin_ns, int64_t end_ns) {
+    if (!IsCapturing()) {
+        return;
+    }
+
+    ZoneRecord record;
+    record.begin_ns = begin_ns;
+    record.end_ns = end_ns;
+    record.name = name;
+    record.track = track;
+    record.depth = 0;
+    record.kind = ZoneRecordKind::ZONE;
+    record.reserved = 0;
+    Append(GetThreadBuffer(), record);
+}
+
+void ZoneProfiler::SetThreadName(const std::string& name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    tracks_[buffer->track].name = name;
+}
+
+ZoneTrackId ZoneProfiler::RegisterTrack(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        if (!tracks_[i].is_thread && tracks_[i].name == name) {
+            return static_cast<ZoneTrackId>(i);
+        }
+    }
+
+    tracks_.push_back(Track{name, false});
+    return static_cast<ZoneTrackId>(tracks_.size() - 1);
+}
+
+const char* ZoneProfiler::InternName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.insert(name).first->c_str();
+}
+
+ZoneProfiler::ThreadBuffer* ZoneProfiler::GetThreadBuffer() {
+    ThreadZoneState& state = t_zone_state;
+    if (state.buffer) {
+        return static_cast<ThreadBuffer*>(state.buffer.get());
+    }
+
+    auto buffer = std::make_shared<ThreadBuffer>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->track = static_cast<ZoneTrackId>(tracks_.size());
+        tracks_.push_back(Track{"Thread " + std::to_string(buffers_.size() + 1), true});
+        buffers_.push_back(buffer);
+    }
+
+    state.buffer = buffer;
+    return buffer.get();
+}
+
+void ZoneProfiler::Append(ThreadBuffer* buffer, const ZoneRecord& record) {
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+        // Первая запись нового захвата: читатели видят буфер только после смены generation
+        size_t capacity = records_per_thread_.load(std::memory_order_relaxed);
+        if (buffer->capacity != capacity) {
+            buffer->records = std::make_unique<ZoneRecord[]>(capacity);
+            buffer->capacity = capacity;
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    size_t count = buffer->count.load(std::memory_order_relaxed);
+    if (count == buffer->capacity) {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->records[count] = record;
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void ZoneProfiler::Collect(std::vector<ZoneRecord>& records, std::vector<Track>& tracks) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tracks = tracks_;
+
+    uint64_t generation = generation_.load(std::memory_order_relaxed);
+    for (const auto& buffer : buffers_) {
+        if (buffer->generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        records.insert(records.end(), buffer->records.get(), buffer->records.get() + count);
+    }
+}
+
+ZoneProfiler::CaptureStats ZoneProfiler::GetCaptureStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    CaptureStats stats;
+    uint64_t generation = generation_.load(std::memory_order_relaxed);
+    for (const auto& buffer : buffers_) {
+        if (buffer->generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        stats.records += buffer->count.load(std::memory_order_acquire);
+        stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+        ++stats.threads;
+    }
+    return stats;
+}
+
+// ============================================================================
+// Экспорт
+// ============================================================================
+
+bool ZoneProfiler::ExportChromeTrace(const std::string& filename) const {
+    std::vector<ZoneRecord> records;
+    std::vector<Track> tracks;
+    Collect(records, tracks);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Trace Event Format: ts/dur - микросекунды; дорожка - tid
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char buffer[160];
+    bool first = true;
+    auto separator = [&] {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        separator();
+        std::snprintf(buffer, sizeof(buffer), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%zu,\"args\":{\"name\":",
+                      kTracePid, i + 1);
+        out += buffer;
+        WriteJsonString(out, tracks[i].name.c_str());
+        out += "}}";
+    }
+
+    for (const ZoneRecord& record : records) {
+        separator();
+        out += "{\"name\":";
+        WriteJsonString(out, record.name);
+
+        switch (record.kind) {
+            case ZoneRecordKind::ZONE:
+                std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                              kTracePid, record.track + 1, record.begin_ns / 1000.0,
+                              (record.end_ns - record.begin_ns) / 1000.0);
+                break;
+            case ZoneRecordKind::COUNTER:
+                std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"C\",\"pid\":%d,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+                              kTracePid, record.begin_ns / 1000.0, record.value);
+                break;
+            case ZoneRecordKind::INSTANT:
+                std::snprintf(buffer, sizeof(buffer),
+                              ",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"args\":{\"arg\":\"0x%016llx\"}}",
+                              kTracePid, record.track + 1, record.begin_ns / 1000.0,
+                              static_cast<unsigned long long>(record.argument));
+                break;
+        }
+        out += buffer;
+    }
+
+    out += "\n]}\n";
+    file.write(out.data(), out.size());
+    return static_cast<bool>(file);
+}
+
+bool ZoneProfiler::ExportPerfetto(const std::string& filename) const {
+    namespace pf = perfetto_fields;
+
+    std::vector<ZoneRecord> records;
+    std::vector<Track> tracks;
+    Collect(records, tracks);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    ProtoWriter trace;
+    auto emit_packet = [&](ProtoWriter& packet) {
+        packet.Varint(pf::kSequenceId, pf::kSequence);
+        trace.Message(pf::kTracePacket, packet);
+    };
+
+    // Дескрипторы: процесс, дорожки потоков и прочие дорожки, дорожки счетчиков
+    {
+        ProtoWriter process;
+        process.Varint(pf::kPid, kTracePid);
+        process.Bytes(pf::kProcessName, "WxeUI");
+
+        ProtoWriter descriptor;
+        descriptor.Varint(pf::kTrackUuid, kProcessTrackUuid);
+        descriptor.Message(pf::kTrackProcess, process);
+
+        ProtoWriter packet;
+        packet.Varint(pf::kSequenceFlags, pf::kIncrementalStateCleared);
+        packet.Message(pf::kTrackDescriptor, descriptor);
+        emit_packet(packet);
+    }
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        ProtoWriter descriptor;
+        descriptor.Varint(pf::kTrackUuid, kTrackUuidBase + i);
+        if (tracks[i].is_thread) {
+            ProtoWriter thread;
+            thread.Varint(pf::kPid, kTracePid);
+            thread.Varint(pf::kTid, i + 1);
+            thread.Bytes(pf::kThreadName, tracks[i].name);
+            descriptor.Message(pf::kTrackThread, thread);
+        } else {
+            descriptor.Varint(pf::kTrackParentUuid, kProcessTrackUuid);
+            descriptor.Bytes(pf::kTrackName, tracks[i].name);
+        }
+
+        ProtoWriter packet;
+        packet.Message(pf::kTrackDescriptor, descriptor);
+        emit_packet(packet);
+    }
+
+    std::unordered_map<const char*, uint64_t> counters;
+    for (const ZoneRecord& record : records) {
+        if (record.kind != ZoneRecordKind::COUNTER || counters.count(record.name)) {
+            continue;
+        }
+
+        uint64_t uuid = kCounterTrackUuidBase + counters.size();
+        counters.emplace(record.name, uuid);
+
+        ProtoWriter descriptor;
+        descriptor.Varint(pf::kTrackUuid, uuid);
+        descriptor.Varint(pf::kTrackParentUuid, kProcessTrackUuid);
+        descriptor.Bytes(pf::kTrackName, record.name);
+        descriptor.Message(pf::kTrackCounter, ProtoWriter());
+
+        ProtoWriter packet;
+        packet.Message(pf::kTrackDescriptor, descriptor);
+        emit_packet(packet);
+    }
+
+    // Зоны - пары SLICE_BEGIN/SLICE_END: на каждой дорожке по началу (родитель
+    // раньше вложенной зоны), концы открытых зон - из стека
+    struct TrackEvent {
+        int64_t timestamp;
+        uint64_t type;
+        uint64_t track_uuid;
+        const char* name;
+        double value;
+    };
+    std::vector<TrackEvent> events;
+    events.reserve(records.size() * 2);
+
+    std::stable_sort(records.begin(), records.end(), [](const ZoneRecord& a, const ZoneRecord& b) {
+        if (a.track != b.track) {
+            return a.track < b.track;
+        }
+        if (a.begin_ns != b.begin_ns) {
+            return a.begin_ns < b.begin_ns;
+        }
+        return a.depth < b.depth;
+    });
+
+    std::vector<std::pair<int64_t, uint64_t>> open;     // Конец зоны и дорожка
+    auto close_until = [&](int64_t timestamp) {
+        while (!open.empty() && open.back().first <= timestamp) {
+            events.push_back({open.back().first, pf::kSliceEnd, open.back().second, nullptr, 0.0});
+            open.pop_back();
+        }
+    };
+
+    ZoneTrackId current_track = 0;
+    for (const ZoneRecord& record : records) {
+        uint64_t track_uuid = kTrackUuidBase + record.track;
+        if (record.track != current_track) {
+            close_until(std::numeric_limits<int64_t>::max());
+            current_track = record.track;
+        }
+
+        switch (record.kind) {
+            case ZoneRecordKind::ZONE:
+                close_until(record.begin_ns);
+                // Зона, выходящая за родителя (неверная вложенность), обрезается по нему
+                events.push_back({record.begin_ns, pf::kSliceBegin, track_uuid, record.name, 0.0});
+                open.emplace_back(open.empty() ? record.end_ns : std::min(record.end_ns, open.back().first), track_uuid);
+                break;
+            case ZoneRecordKind::COUNTER:
+                events.push_back({record.begin_ns, pf::kCounter, counters[record.name], nullptr, record.value});
+                break;
+            case ZoneRecordKind::INSTANT:
+                events.push_back({record.begin_ns, pf::kInstant, track_uuid, record.name, 0.0});
+                break;
+        }
+    }
+    close_until(std::numeric_limits<int64_t>::max());
+
+    // Устойчивая сортировка: при равных отметках на дорожке сохраняется порядок
+    // стека (конец соседней зоны - раньше начала следующей)
+    std::stable_sort(events.begin(), events.end(), [](const TrackEvent& a, const TrackEvent& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    for (const TrackEvent& event : events) {
+        ProtoWriter track_event;
+        track_event.Varint(pf::kEventType, event.type);
+        track_event.Varint(pf::kEventTrackUuid, event.track_uuid);
+        if (event.name) {
+            track_event.Bytes(pf::kEventName, event.name);
+        }
+        if (event.type == pf::kCounter) {
+            track_event.Double(pf::kEventDoubleCounterValue, event.value);
+        }
+
+        ProtoWriter packet;
+        packet.Varint(pf::kTimestamp, static_cast<uint64_t>(event.timestamp));
+        packet.Varint(pf::kTimestampClockId, pf::kClockMonotonic);
+        packet.Message(pf::kTrackEvent, track_event);
+        emit_packet(packet);
+    }
+
+    file.write(trace.Data().data(), trace.Data().size());
+    return static_cast<bool>(file);
+}
+
+} // namespace Profiling
+} // namespace WxeUI
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace WxeUI {
+namespace Profiling {
+
+// ============================================================================
+// Зоны профилирования
+// ============================================================================
+//
+// WXE_ZONE("LayoutText") отмечает область до конца блока; зоны вкладываются.
+// Записи - в буфер своего потока, без блокировок; захват включается
+// StartCapture() и выгружается в Chrome Trace Event JSON (chrome://tracing,
+// ui.perfetto.dev) или в protobuf-трассу Perfetto. События CacheProfiler
+// попадают в ту же трассу на дорожки кэшей
+
+using ZoneTrackId = uint32_t;
+
+enum class ZoneRecordKind : uint8_t {
+    ZONE,       // Область [begin_ns, end_ns]
+    COUNTER,    // Значение счетчика в begin_ns
+    INSTANT     // Мгновенное событие в begin_ns
+};
+
+struct ZoneRecord {
+    int64_t begin_ns;           // steady_clock
+    union {
+        int64_t end_ns;         // ZONE
+        double value;           // COUNTER
+        uint64_t argument;      // INSTANT: произвольное значение (хэш ключа кэша)
+    };
+    const char* name;           // Строка со статическим временем жизни
+    ZoneTrackId track;
+    uint16_t depth;
+    ZoneRecordKind kind;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(void*) != 8 || sizeof(ZoneRecord) == 32, "ZoneRecord must stay two records per cache line");
+
+class ZoneProfiler {
+public:
+    struct Config {
+        Config() {}
+
+        size_t records_per_thread = 65536;      // 2 МБ на поток; сверх - потеря
+    };
+
+    static ZoneProfiler& Get();
+
+    // Новый захват сбрасывает записи предыдущего. Export* - после StopCapture
+    // (или во время захвата: выгружаются уже завершенные записи)
+    void StartCapture(const Config& config = Config{});
+    void StopCapture();
+    bool IsCapturing() const { return capturing_.load(std::memory_order_relaxed); }
+
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Ручные зоны (ScopedZone - обертка): вызовы парные, в порядке LIFO в пределах потока
+    static int64_t BeginZone();
+    static void EndZone(const char* name, int64_t begin_ns);
+
+    static void Counter(const char* name, double value);
+
+    // Запись на отдельную дорожку (не дорожку потока) с явной отметкой времени
+    void RecordInstant(ZoneTrackId track, const char* name, int64_t timestamp_ns, uint64_t argument = 0);
+    void RecordZone(ZoneTrackId track, const char* name, int64_t begin_ns, int64_t end_ns);
+
+    // Дорожка потока называется по имени потока; прочие дорожки - по имени
+    void SetThreadName(const std::string& name);
+    ZoneTrackId RegisterTrack(const std::string& name);
+
+    // Стабильный указатель на копию строки - для имен, известных только во время выполнения
+    const char* InternName(const std::string& name);
+
+    bool ExportChromeTrace(const std::string& filename) const;
+    bool ExportPerfetto(const std::string& filename) const;
+
+    struct CaptureStats {
+        uint64_t records = 0;
+        uint64_t dropped = 0;
+        size_t threads = 0;
+    };
+    CaptureStats GetCaptureStats() const;
+
+private:
+    struct ThreadBuffer;
+    struct Track {
+        std::string name;
+        bool is_thread = false;
+    };
+
+    ZoneProfiler() = default;
+
+    std::atomic<bool> capturing_{false};
+    std::atomic<uint64_t> generation_{0};               // Номер захвата; буфер сбрасывает владелец
+    std::atomic<size_t> records_per_thread_{Config().records_per_thread};
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    std::vector<Track> tracks_;
+    std::unordered_set<std::string> names_;
+    mutable std::mutex mutex_;
+
+    ThreadBuffer* GetThreadBuffer();
+    void Append(ThreadBuffer* buffer, const ZoneRecord& record);
+    void Collect(std::vector<ZoneRecord>& records, std::vector<Track>& tracks) const;
+};
+
+class ScopedZone {
+public:
+    explicit ScopedZone(const char* name) : name_(name), begin_ns_(ZoneProfiler::BeginZone()) {}
+    ~ScopedZone() { ZoneProfiler::EndZone(name_, begin_ns_); }
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    const char* name_;
+    int64_t begin_ns_;
+};
+
+} // namespace Profiling
+} // namespace WxeUI
+
+// Имя зоны и счетчика - строковый литерал. WXE_DISABLE_ZONES убирает разметку
+#define WXE_ZONE_CONCAT_IMPL(a, b) a##b
+#define WXE_ZONE_CONCAT(a, b) WXE_ZONE_CONCAT_IMPL(a, b)
+
+#ifndef WXE_DISABLE_ZONES
+#define WXE_ZONE(name) ::WxeUI::Profiling::ScopedZone WXE_ZONE_CONCAT(wxe_zone_, __LINE__)(name)
+#define WXE_COUNTER(name, value) ::WxeUI::Profiling::ZoneProfiler::Counter(name, static_cast<double>(value))
+#else
+#define WXE_ZONE(name) ((void)0)
+#define WXE_COUNTER(name, value) ((void)0)
+#endif
@@ -12,10 +12,18 @@ AdvancedEffects::~AdvancedEffects() {
 }
 // Размытие и фильтры
 sk_sp<SkImageFilter> AdvancedEffects::CreateBlurFilter(const BlurSettings& settings) {
-
+    if (!quality_.enableBlur) {
+        return nullptr;
+    }
+    float scale = quality_.blurQuality;
+    return SkImageFilters::Blur(settings.sigmaX * scale, settings.sigmaY * scale, settings.tileMode, nullptr);
 }
 sk_sp<SkImageFilter> AdvancedEffects::CreateGaussianBlur(float sigma) {
-    
+    if (!quality_.enableBlur) {
+        return nullptr;
+    }
+    sigma *= quality_.blurQuality;
+    return SkImageFilters::Blur(sigma, sigma, nullptr);
 }
 sk_sp<SkImageFilter> AdvancedEffects::CreateMotionBlur(float angle, float distance) {
 
@@ -26,7 +34,14 @@ sk_sp<SkImageFilter> AdvancedEffects::CreateRadialBlur(const SkPoint& center, fl
 
 // Тени и свечение
 sk_sp<SkImageFilter> AdvancedEffects::CreateDropShadow(const ShadowSettings& settings) {
-
+    if (!quality_.enableShadows) {
+        return nullptr;
+    }
+    
+    // Радиус размытия -> sigma по соглашению Skia; без размытия тень жесткая
+    float sigma = settings.blurRadius > 0.0f ? settings.blurRadius * 0.57735f + 0.5f : 0.0f;
+    sigma = quality_.enableBlur ? sigma * quality_.blurQuality : 0.0f;
+    return SkImageFilters::DropShadow(settings.offsetX, settings.offsetY, sigma, sigma, settings.color, nullptr);
 }
 sk_sp<SkImageFilter> AdvancedEffects::CreateInnerShadow(const ShadowSettings& settings) {}
 sk_sp<SkImageFilter> AdvancedEffects::CreateGlow(SkColor color, float radius, float intensity) {}
@@ -36,7 +51,16 @@ sk_sp<SkImageFilter> AdvancedEffects::CreateBevel(float depth, float angle, SkCo
 
 // Градиенты
 sk_sp<SkShader> AdvancedEffects::CreateLinearGradient(const SkPoint& start, const SkPoint& end, const GradientSettings& settings) {
-
+    if (settings.colors.size() < 2 ||
+        (!settings.positions.empty() && settings.positions.size() != settings.colors.size())) {
+        return nullptr;
+    }
+    
+    SkPoint points[2] = {start, end};
+    return SkGradientShader::MakeLinear(points, settings.colors.data(),
+                                        settings.positions.empty() ? nullptr : settings.positions.data(),
+                                        static_cast<int>(settings.colors.size()), settings.tileMode, 0,
+                                        &settings.localMatrix);
 }
 sk_sp<SkShader> AdvancedEffects::CreateRadialGradient(const SkPoint& center, float radius, const GradientSettings& settings) {
 
@@ -96,7 +120,7 @@ sk_sp<SkImageFilter> AdvancedEffects::CreateTurbulence(float baseFreqX, float ba
 
 // Композиция эффектов
 sk_sp<SkImageFilter> AdvancedEffects::ComposeFilters(sk_sp<SkImageFilter> outer, sk_sp<SkImageFilter> inner) {
-    
+    return SkImageFilters::Compose(std::move(outer), std::move(inner));
 }
 sk_sp<SkImageFilter> AdvancedEffects::BlendFilters(sk_sp<SkImageFilter> background, sk_sp<SkImageFilter> foreground, SkBlendMode mode) {
 
@@ -1,12 +1,16 @@
 #pragma once
 
-#include "window_winapi.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPath.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkGradientShader.h"
-#include "include/effects/SkBlurImageFilter.h"
-#include "include/effects/SkDropShadowImageFilter.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPathEffect.h"
+#include "rendering/quality_settings.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace WxeUI {
 namespace rendering {
@@ -49,6 +53,11 @@ public:
     AdvancedEffects();
     ~AdvancedEffects();
     
+    // Ступень качества (QualityManager): радиус размытия умножается на
+    // blurQuality; выключенные размытие или тени дают nullptr - рисование без фильтра
+    void SetQualitySettings(const QualitySettings& settings) { quality_ = settings; }
+    const QualitySettings& GetQualitySettings() const { return quality_; }
+    
     // Размытие и фильтры
     sk_sp<SkImageFilter> CreateBlurFilter(const BlurSettings& settings);
     sk_sp<SkImageFilter> CreateGaussianBlur(float sigma);
@@ -102,6 +111,8 @@ public:
     sk_sp<SkShader> CreateTextureShader(sk_sp<SkImage> texture, SkTileMode tmx, SkTileMode tmy);
     
 private:
+    QualitySettings quality_;
+    
     // Кэширование часто используемых фильтров
     std::unordered_map<std::string, sk_sp<SkImageFilter>> filterCache_;
     std::unordered_map<std::string, sk_sp<SkShader>> shaderCache_;
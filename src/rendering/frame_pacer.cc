@@ -0,0 +1,179 @@
+#include "rendering/frame_pacer.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WXE_CPU_RELAX() _mm_pause()
+#else
+#define WXE_CPU_RELAX() std::this_thread::yield()
+#endif
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace WxeUI {
+namespace rendering {
+
+namespace {
+
+using Clock = FramePacer::Clock;
+
+#if defined(_WIN32)
+// Таймер потока: высокого разрешения (Windows 10 1803+), иначе обычный с
+// точностью системного тика - ее покрывает калиброванный порог
+struct ThreadTimer {
+    HANDLE handle = nullptr;
+
+    ThreadTimer() {
+        handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!handle) {
+            handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+    }
+
+    ~ThreadTimer() {
+        if (handle) {
+            CloseHandle(handle);
+        }
+    }
+};
+#endif
+
+void OsSleepUntil(Clock::time_point deadline) {
+#if defined(_WIN32)
+    // Абсолютное время таймера - системные часы, не QPC: срок переводится в
+    // относительный (отрицательный, в единицах 100 нс)
+    thread_local ThreadTimer timer;
+    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now()).count();
+    if (remaining <= 0) {
+        return;
+    }
+    if (!timer.handle) {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+
+    LARGE_INTEGER due;
+    due.QuadPart = -static_cast<LONGLONG>(remaining / 100);
+    if (due.QuadPart < 0 && SetWaitableTimer(timer.handle, &due, 0, nullptr, nullptr, FALSE)) {
+        WaitForSingleObject(timer.handle, INFINITE);
+    }
+#elif defined(__linux__)
+    // steady_clock в libstdc++ и libc++ - CLOCK_MONOTONIC с той же эпохой
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+} // namespace
+
+FramePacer::FramePacer(float targetFPS)
+    : targetFPS_(targetFPS), frameInterval_(ToInterval(targetFPS)), spinThreshold_(CalibrateSpinThreshold()) {
+    Reset();
+}
+
+void FramePacer::SetTargetFPS(float fps) {
+    targetFPS_ = fps;
+    frameInterval_ = ToInterval(fps);
+    nextDeadline_ = lastDeadline_ + frameInterval_;
+}
+
+void FramePacer::Reset() {
+    lastDeadline_ = Clock::now();
+    nextDeadline_ = lastDeadline_ + frameInterval_;
+}
+
+void FramePacer::WaitForNextFrame() {
+    if (vsyncEnabled_) {
+        return;
+    }
+
+    auto now = Clock::now();
+    if (now >= nextDeadline_) {
+        // Кадр не уложился: догонять пропущенные сроки пачкой кадров хуже,
+        // чем начать сетку заново
+        missedDeadlines_.fetch_add(1, std::memory_order_relaxed);
+        lastDeadline_ = now;
+        nextDeadline_ = now + frameInterval_;
+        return;
+    }
+
+    SleepUntil(nextDeadline_, spinThreshold_);
+    wakeErrorHistogram_.Record(Clock::now() - nextDeadline_);
+
+    lastDeadline_ = nextDeadline_;
+    nextDeadline_ += frameInterval_;
+}
+
+FramePacer::JitterStats FramePacer::GetJitterStats() const {
+    JitterStats stats;
+    stats.frames = wakeErrorHistogram_.GetCount();
+    stats.missedDeadlines = missedDeadlines_.load(std::memory_order_relaxed);
+    stats.meanErrorUs = wakeErrorHistogram_.GetMean() / 1e3;
+    stats.p50ErrorUs = static_cast<double>(wakeErrorHistogram_.GetPercentile(50.0)) / 1e3;
+    stats.p99ErrorUs = static_cast<double>(wakeErrorHistogram_.GetPercentile(99.0)) / 1e3;
+    stats.p999ErrorUs = static_cast<double>(wakeErrorHistogram_.GetPercentile(99.9)) / 1e3;
+    stats.maxErrorUs = static_cast<double>(wakeErrorHistogram_.GetMax()) / 1e3;
+    return stats;
+}
+
+void FramePacer::ResetStats() {
+    missedDeadlines_.store(0, std::memory_order_relaxed);
+    wakeErrorHistogram_.Reset();
+}
+
+void FramePacer::SleepUntil(Clock::time_point deadline, Clock::duration spinThreshold) {
+    auto wake = deadline - spinThreshold;
+    if (Clock::now() < wake) {
+        OsSleepUntil(wake);
+    }
+    while (Clock::now() < deadline) {
+        WXE_CPU_RELAX();
+    }
+}
+
+FramePacer::Clock::duration FramePacer::CalibrateSpinThreshold(int samples) {
+    static const Clock::duration threshold = [samples] {
+        // Короткие сны: опоздание почти не зависит от длины сна, а калибровка
+        // не задерживает запуск
+        constexpr auto kSleep = std::chrono::microseconds(200);
+        std::vector<Clock::duration> overshoots;
+        overshoots.reserve(static_cast<size_t>(std::max(samples, 1)));
+        for (int i = 0; i < std::max(samples, 1); ++i) {
+            auto deadline = Clock::now() + kSleep;
+            OsSleepUntil(deadline);
+            overshoots.push_back(Clock::now() - deadline);
+        }
+
+        // 95-й перцентиль с запасом: редкие выбросы планировщика покрывать
+        // активным ожиданием дороже, чем пропустить
+        std::sort(overshoots.begin(), overshoots.end());
+        Clock::duration p95 = overshoots[overshoots.size() * 95 / 100];
+        Clock::duration margin = p95 / 4 + std::chrono::microseconds(20);
+        return std::clamp<Clock::duration>(p95 + margin, std::chrono::microseconds(50), std::chrono::milliseconds(4));
+    }();
+    return threshold;
+}
+
+FramePacer::Clock::duration FramePacer::ToInterval(float fps) {
+    fps = std::max(fps, 1.0f);
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+}
+
+}} // namespace WxeUI::rendering
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "profiling/latency_histogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace WxeUI {
+namespace rendering {
+
+// Frame Pacing - сглаживание кадров.
+//
+// Кадры привязаны к сетке абсолютных сроков: следующий срок = предыдущий +
+// интервал, поэтому ошибка пробуждения не накапливается (в отличие от
+// "sleep_for(интервал - время кадра)"). Ожидание - сон ОС до (срок - порог),
+// затем короткое активное ожидание до самого срока: clock_nanosleep с
+// TIMER_ABSTIME на Linux, таймер высокого разрешения на Windows. Порог
+// калибруется по фактическому опозданию сна на этой машине
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct JitterStats {
+        uint64_t frames = 0;            // Дождавшиеся своего срока
+        uint64_t missedDeadlines = 0;   // Кадр не уложился в интервал: без ожидания
+        double meanErrorUs = 0.0;       // Опоздание пробуждения относительно срока
+        double p50ErrorUs = 0.0;
+        double p99ErrorUs = 0.0;
+        double p999ErrorUs = 0.0;
+        double maxErrorUs = 0.0;
+    };
+
+    FramePacer(float targetFPS = 60.0f);
+
+    // Новый интервал отсчитывается от последнего срока - без скачка фазы
+    void SetTargetFPS(float fps);
+    float GetTargetFPS() const { return targetFPS_; }
+    Clock::duration GetFrameInterval() const { return frameInterval_; }
+
+    // Ожидание следующего кадра. Если кадр опоздал, возвращается сразу, а
+    // сетка сроков начинается заново от текущего момента
+    void WaitForNextFrame();
+    Clock::time_point GetNextDeadline() const { return nextDeadline_; }
+    void Reset();                       // Сетка от текущего момента
+
+    // VSync управление: при VSync кадры выравнивает Present, ожидания нет
+    void EnableVSync(bool enable) { vsyncEnabled_ = enable; }
+    bool IsVSyncEnabled() const { return vsyncEnabled_; }
+
+    // Длительность активного ожидания перед сроком; 0 - только сон ОС
+    void SetSpinThreshold(Clock::duration threshold) { spinThreshold_ = threshold; }
+    Clock::duration GetSpinThreshold() const { return spinThreshold_; }
+
+    JitterStats GetJitterStats() const;
+    const Profiling::LatencyHistogram& GetWakeErrorHistogram() const { return wakeErrorHistogram_; }
+    void ResetStats();
+
+    // Сон до абсолютного срока: ОС до (deadline - spinThreshold), затем активно
+    static void SleepUntil(Clock::time_point deadline, Clock::duration spinThreshold);
+
+    // Порог активного ожидания: высокий перцентиль опоздания сна ОС на
+    // коротких интервалах с запасом. Занимает около samples * 1 мс;
+    // результат кэшируется на процесс
+    static Clock::duration CalibrateSpinThreshold(int samples = 64);
+
+private:
+    float targetFPS_;
+    Clock::duration frameInterval_;
+    Clock::duration spinThreshold_;
+    bool vsyncEnabled_ = true;
+    Clock::time_point lastDeadline_;
+    Clock::time_point nextDeadline_;
+
+    std::atomic<uint64_t> missedDeadlines_{0};     // Читается и из других потоков
+    Profiling::LatencyHistogram wakeErrorHistogram_;
+
+    static Clock::duration ToInterval(float fps);
+};
+
+}} // namespace WxeUI::rendering
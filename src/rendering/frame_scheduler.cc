@@ -0,0 +1,180 @@
+#include "rendering/frame_scheduler.h"
+#include "rendering/frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WxeUI {
+namespace rendering {
+
+void SystemSchedulerClock::SleepUntil(Clock::time_point deadline) {
+    FramePacer::SleepUntil(deadline, FramePacer::CalibrateSpinThreshold());
+}
+
+void SimulatedSchedulerClock::SleepUntil(Clock::time_point deadline) {
+    if (deadline <= now_) {
+        return;
+    }
+    now_ = deadline;
+    if (maxWakeDelay_ > Clock::duration::zero()) {
+        std::uniform_int_distribution<int64_t> delay(0, maxWakeDelay_.count());
+        now_ += Clock::duration(delay(random_));
+    }
+}
+
+FrameScheduler::FrameScheduler(SchedulerClock& clock, const Config& config)
+    : clock_(clock), margin_(config.minMargin) {
+    SetConfig(config);
+    Reset();
+}
+
+void FrameScheduler::SetConfig(const Config& config) {
+    config_ = config;
+    interval_ = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(config_.targetFPS, 1.0f)));
+    margin_ = std::clamp(margin_, config_.minMargin, config_.maxMargin);
+
+    size_t historySize = std::max<size_t>(config_.historySize, 1);
+    if (costs_.size() != historySize) {
+        costs_.assign(historySize, 0);
+        costNext_ = 0;
+        costCount_ = 0;
+    }
+}
+
+void FrameScheduler::Reset() {
+    lastDeadline_ = clock_.Now();
+}
+
+FrameScheduler::FrameTiming FrameScheduler::BeginFrame() {
+    auto now = clock_.Now();
+    if (config_.externalPacing) {
+        // Ждет Present: кадр начинается сразу, срок - интервал от начала,
+        // пропуск - кадр дольше интервала
+        predictedCostNs_.store(0, std::memory_order_relaxed);
+        FrameTiming timing;
+        timing.frame = frame_++;
+        timing.deadline = now + interval_;
+        timing.plannedStart = now;
+        timing.start = now;
+        timing.inputLatch = now;
+        return timing;
+    }
+
+    bool predicting = false;
+    Clock::duration predicted = Clock::duration::zero();
+    if (config_.justInTime && costCount_ >= std::max<size_t>(config_.warmupFrames, 1)) {
+        predicted = PredictCost();
+        Clock::duration spread = predicted - CostPercentile(50.0);
+        predicting = spread <= interval_ * config_.maxCostSpread && predicted <= interval_ * config_.maxPredictedLoad;
+        if (!predicting) {
+            predicted = Clock::duration::zero();
+        }
+    }
+    predictedCostNs_.store(predicted.count(), std::memory_order_relaxed);
+    marginNs_.store(margin_.count(), std::memory_order_relaxed);
+
+    // Срок, к которому кадр не успеть даже при старте сейчас, пропускается
+    // целиком - фаза сетки сохраняется
+    Clock::time_point deadline = lastDeadline_ + interval_;
+    if (now + predicted > deadline) {
+        auto skipped = (now + predicted - deadline) / interval_ + 1;
+        deadline += interval_ * skipped;
+        skippedDeadlines_.fetch_add(static_cast<uint64_t>(skipped), std::memory_order_relaxed);
+    }
+
+    // Без прогноза кадр начинается сразу после показа предыдущего
+    if (predicting) {
+        justInTimeFrames_.fetch_add(1, std::memory_order_relaxed);
+    }
+    Clock::duration lead = predicting ? predicted : interval_;
+    FrameTiming timing;
+    timing.frame = frame_++;
+    timing.deadline = deadline;
+    timing.predictedCost = predicted;
+    timing.plannedStart = std::max(now, deadline - lead);
+
+    if (timing.plannedStart > now) {
+        clock_.SleepUntil(timing.plannedStart);
+        timing.start = clock_.Now();
+        wakeErrorHistogram_.Record(timing.start - timing.plannedStart);
+    } else {
+        timing.start = now;
+    }
+    timing.inputLatch = timing.start;
+    return timing;
+}
+
+void FrameScheduler::EndFrame(const FrameTiming& timing) {
+    EndFrame(timing, clock_.Now() - timing.start);
+}
+
+void FrameScheduler::EndFrame(const FrameTiming& timing, Clock::duration renderCost) {
+    RecordCost(renderCost);
+    lastDeadline_ = timing.deadline;
+
+    Clock::time_point finish = timing.start + renderCost;
+    if (finish > timing.deadline) {
+        // Кадр покажется на следующем сроке; запас растет сразу, чтобы не
+        // пропустить и следующий
+        missedDeadlines_.fetch_add(1, std::memory_order_relaxed);
+        auto grown = std::chrono::duration_cast<Clock::duration>(margin_ * config_.marginGrowth);
+        margin_ = std::min(config_.maxMargin, std::max(grown, margin_ + (finish - timing.deadline)));
+        inputAgeHistogram_.Record(finish - timing.inputLatch);
+        return;
+    }
+
+    auto decayed = std::chrono::duration_cast<Clock::duration>(margin_ * config_.marginDecay);
+    margin_ = std::max(config_.minMargin, decayed);
+    inputAgeHistogram_.Record(timing.deadline - timing.inputLatch);
+}
+
+void FrameScheduler::SeedCost(Clock::duration renderCost) {
+    RecordCost(renderCost);
+}
+
+FrameScheduler::Clock::duration FrameScheduler::PredictCost() const {
+    if (costCount_ == 0) {
+        return Clock::duration::zero();
+    }
+    return CostPercentile(config_.costPercentile) + margin_;
+}
+
+FrameScheduler::Clock::duration FrameScheduler::CostPercentile(double percentile) const {
+    sortBuffer_.assign(costs_.begin(), costs_.begin() + costCount_);
+    double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(costCount_ - 1);
+    auto index = static_cast<size_t>(std::ceil(rank));
+    std::nth_element(sortBuffer_.begin(), sortBuffer_.begin() + index, sortBuffer_.end());
+    return Clock::duration(sortBuffer_[index]);
+}
+
+void FrameScheduler::RecordCost(Clock::duration cost) {
+    costs_[costNext_] = std::max<int64_t>(0, cost.count());
+    costNext_ = (costNext_ + 1) % costs_.size();
+    costCount_ = std::min(costCount_ + 1, costs_.size());
+}
+
+FrameScheduler::Stats FrameScheduler::GetStats() const {
+    Stats stats;
+    stats.frames = inputAgeHistogram_.GetCount();
+    stats.missedDeadlines = missedDeadlines_.load(std::memory_order_relaxed);
+    stats.skippedDeadlines = skippedDeadlines_.load(std::memory_order_relaxed);
+    stats.droppedFrames = stats.missedDeadlines + stats.skippedDeadlines;
+    stats.justInTimeFrames = justInTimeFrames_.load(std::memory_order_relaxed);
+    stats.predictedCostMs = static_cast<double>(predictedCostNs_.load(std::memory_order_relaxed)) / 1e6;
+    stats.marginMs = static_cast<double>(marginNs_.load(std::memory_order_relaxed)) / 1e6;
+    stats.inputAgeP50Ms = static_cast<double>(inputAgeHistogram_.GetPercentile(50.0)) / 1e6;
+    stats.inputAgeP99Ms = static_cast<double>(inputAgeHistogram_.GetPercentile(99.0)) / 1e6;
+    stats.wakeErrorP50Us = static_cast<double>(wakeErrorHistogram_.GetPercentile(50.0)) / 1e3;
+    stats.wakeErrorP99Us = static_cast<double>(wakeErrorHistogram_.GetPercentile(99.0)) / 1e3;
+    return stats;
+}
+
+void FrameScheduler::ResetStats() {
+    missedDeadlines_.store(0, std::memory_order_relaxed);
+    skippedDeadlines_.store(0, std::memory_order_relaxed);
+    justInTimeFrames_.store(0, std::memory_order_relaxed);
+    inputAgeHistogram_.Reset();
+    wakeErrorHistogram_.Reset();
+}
+
+}} // namespace WxeUI::rendering
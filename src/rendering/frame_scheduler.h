@@ -0,0 +1,161 @@
+#pragma once
+
+#include "profiling/latency_histogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace WxeUI {
+namespace rendering {
+
+// ============================================================================
+// Источник времени планировщика
+// ============================================================================
+
+class SchedulerClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~SchedulerClock() = default;
+
+    virtual Clock::time_point Now() const = 0;
+    virtual void SleepUntil(Clock::time_point deadline) = 0;
+};
+
+// steady_clock; ожидание - FramePacer::SleepUntil (сон ОС + активное ожидание)
+class SystemSchedulerClock : public SchedulerClock {
+public:
+    Clock::time_point Now() const override { return Clock::now(); }
+    void SleepUntil(Clock::time_point deadline) override;
+};
+
+// Имитируемое время для тестов и моделирования: сон переводит часы на срок
+// плюс случайное опоздание пробуждения, работа кадра - Advance()
+class SimulatedSchedulerClock : public SchedulerClock {
+public:
+    explicit SimulatedSchedulerClock(Clock::duration maxWakeDelay = Clock::duration::zero(), uint32_t seed = 1)
+        : maxWakeDelay_(maxWakeDelay), random_(seed) {}
+
+    Clock::time_point Now() const override { return now_; }
+    void SleepUntil(Clock::time_point deadline) override;
+    void Advance(Clock::duration duration) { now_ += duration; }
+
+private:
+    Clock::time_point now_{};
+    Clock::duration maxWakeDelay_;
+    std::mt19937 random_;
+};
+
+// ============================================================================
+// Планировщик кадров "точно в срок"
+// ============================================================================
+//
+// Кадр показывается на сетке сроков (vblank или интервал targetFPS). Вместо
+// "отрисовать сразу, затем ждать" кадр начинается как можно позже: срок -
+// прогноз стоимости - запас. Ввод, собранный в начале кадра, к показу
+// старше лишь на время отрисовки, а не на целый интервал.
+// Прогноз - перцентиль стоимости недавних кадров; запас растет при каждом
+// пропуске срока и медленно убывает, пока кадры успевают. Поздний старт -
+// только пока прогноз держится: при большом разбросе стоимости или прогнозе
+// почти на весь интервал он чаще пропускает сроки, чем молодит ввод, и кадр
+// начинается сразу
+class FrameScheduler {
+public:
+    using Clock = SchedulerClock::Clock;
+
+    struct Config {
+        Config() {}
+
+        float targetFPS = 60.0f;
+        bool justInTime = true;                 // false - старт сразу после предыдущего срока
+        bool externalPacing = false;            // Срок задает Present (VSync): BeginFrame не ждет
+        size_t historySize = 120;               // Кадров в окне прогноза
+        size_t warmupFrames = 8;                // До набора истории - старт сразу
+        double costPercentile = 99.0;
+        double maxCostSpread = 0.2;             // (прогноз - медиана) / интервал; больше - старт сразу
+        double maxPredictedLoad = 0.75;         // Прогноз / интервал; больше - старт сразу
+        Clock::duration minMargin = std::chrono::microseconds(500);
+        Clock::duration maxMargin = std::chrono::milliseconds(8);
+        double marginGrowth = 2.0;              // Множитель запаса при пропуске срока
+        double marginDecay = 0.995;             // Множитель (к минимуму) на успевший кадр
+    };
+
+    struct FrameTiming {
+        uint64_t frame = 0;
+        Clock::time_point deadline;             // Показ кадра
+        Clock::time_point plannedStart;
+        Clock::time_point start;                // Фактическое пробуждение
+        Clock::time_point inputLatch;           // Сбор ввода: BeginFrame ставит start, вызывающий уточняет до EndFrame
+        Clock::duration predictedCost{};
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t missedDeadlines = 0;           // Кадр закончен после своего срока
+        uint64_t skippedDeadlines = 0;          // Сроки, пропущенные из-за длинных кадров
+        uint64_t droppedFrames = 0;             // Сроки без нового кадра: пропущенные и сорванные
+        uint64_t justInTimeFrames = 0;          // Кадры, начатые по прогнозу
+        double predictedCostMs = 0.0;
+        double marginMs = 0.0;
+        double inputAgeP50Ms = 0.0;             // Срок - сбор ввода: возраст ввода при показе
+        double inputAgeP99Ms = 0.0;
+        double wakeErrorP50Us = 0.0;            // Опоздание старта относительно плана
+        double wakeErrorP99Us = 0.0;
+    };
+
+    // clock должен жить дольше планировщика
+    explicit FrameScheduler(SchedulerClock& clock, const Config& config = Config{});
+
+    void SetConfig(const Config& config);
+    const Config& GetConfig() const { return config_; }
+
+    // Выбирает срок, ждет планового старта и возвращает его. Сразу после -
+    // сбор ввода (EventDispatcher::FlushCoalesced/DeliverFrameEvents) и отрисовка;
+    // момент сбора - в FrameTiming::inputLatch
+    FrameTiming BeginFrame();
+
+    // Работа кадра закончена (до Present). Стоимость для прогноза - время с
+    // начала кадра или renderCost, если она измерена точнее (PerformanceMonitor)
+    void EndFrame(const FrameTiming& timing);
+    void EndFrame(const FrameTiming& timing, Clock::duration renderCost);
+
+    // Начальная история прогноза, например из PerformanceMonitor::GetFrameHistory()
+    void SeedCost(Clock::duration renderCost);
+    Clock::duration PredictCost() const;
+
+    // Сетка сроков от текущего момента; история прогноза сохраняется
+    void Reset();
+
+    Stats GetStats() const;
+    const Profiling::LatencyHistogram& GetInputAgeHistogram() const { return inputAgeHistogram_; }
+    void ResetStats();
+
+private:
+    SchedulerClock& clock_;
+    Config config_;
+    Clock::duration interval_;
+
+    Clock::time_point lastDeadline_;
+    uint64_t frame_ = 0;
+
+    std::vector<int64_t> costs_;                // Кольцо стоимостей, нс
+    size_t costNext_ = 0;
+    size_t costCount_ = 0;
+    Clock::duration margin_;
+    mutable std::vector<int64_t> sortBuffer_;
+
+    std::atomic<uint64_t> missedDeadlines_{0};
+    std::atomic<uint64_t> skippedDeadlines_{0};
+    std::atomic<uint64_t> justInTimeFrames_{0};
+    std::atomic<int64_t> predictedCostNs_{0};
+    std::atomic<int64_t> marginNs_{0};
+    Profiling::LatencyHistogram inputAgeHistogram_;
+    Profiling::LatencyHistogram wakeErrorHistogram_;
+
+    void RecordCost(Clock::duration cost);
+    Clock::duration CostPercentile(double percentile) const;
+};
+
+}} // namespace WxeUI::rendering
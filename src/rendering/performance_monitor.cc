@@ -1,6 +1,5 @@
 #include "rendering/performance_monitor.h"
 #include <fstream>
-#include <thread>
 #include <algorithm>
 #include <iostream>
 
@@ -22,14 +21,34 @@ void PerformanceMonitor::Initialize(const MonitoringOptions& options) {
 
 void PerformanceMonitor::BeginFrame() {
     frameStartTime_ = std::chrono::high_resolution_clock::now();
+    frameCpuTime_ = 0.0f;
+    frameZoneBegin_ = Profiling::ZoneProfiler::BeginZone();
+    frameCountersSampled_ = SampleHardwareCounters(frameCounters_);
 }
 
 void PerformanceMonitor::EndFrame() {
+    Profiling::HardwareCounterValues frameEndCounters;
+    bool countersSampled = frameCountersSampled_ && SampleHardwareCounters(frameEndCounters);
     auto now = std::chrono::high_resolution_clock::now();
+    Profiling::ZoneProfiler::EndZone("Frame", frameZoneBegin_);
     
     FrameMetrics metrics;
     metrics.timestamp = now;
     metrics.frameTime = std::chrono::duration<float, std::milli>(now - frameStartTime_).count();
+    metrics.cpuTime = frameCpuTime_;
+    WXE_COUNTER("Frame time, ms", metrics.frameTime);
+    
+    if (countersSampled) {
+        metrics.counters = frameEndCounters - frameCounters_;
+        Profiling::HardwareCounterProfiler::Get().Accumulate("Frame", metrics.counters);
+        if (metrics.counters.Has(Profiling::HardwareCounter::CYCLES)) {
+            WXE_COUNTER("Frame IPC", metrics.counters.GetIPC());
+            WXE_COUNTER("Frame LLC miss rate, %", metrics.counters.GetLLCMissRate() * 100.0);
+        }
+    }
+    
+    frameTimeHistogram_.Record(now - frameStartTime_);
+    cpuTimeHistogram_.RecordMilliseconds(frameCpuTime_);
     
     // Добавляем метрики в историю
     frameHistory_.push_back(metrics);
@@ -69,20 +88,60 @@ void PerformanceMonitor::EndGPUWork() {
 
 void PerformanceMonitor::BeginCPUWork(const std::string& name) {
     if (options_.enableFrameProfiling) {
-        cpuTimers_[name] = std::chrono::high_resolution_clock::now();
+        CPUWork work{name, {}, Profiling::ZoneProfiler::BeginZone(), {}, false};
+        work.countersSampled = SampleHardwareCounters(work.counters);
+        work.startTime = std::chrono::high_resolution_clock::now();
+        cpuWork_.push_back(std::move(work));
     }
 }
 
 void PerformanceMonitor::EndCPUWork(const std::string& name) {
     if (options_.enableFrameProfiling) {
-        auto it = cpuTimers_.find(name);
-        if (it != cpuTimers_.end() && !frameHistory_.empty()) {
-            auto now = std::chrono::high_resolution_clock::now();
-            float workTime = std::chrono::duration<float, std::milli>(now - it->second).count();
-            frameHistory_.back().cpuTime += workTime;
-            cpuTimers_.erase(it);
+        auto it = std::find_if(cpuWork_.rbegin(), cpuWork_.rend(),
+            [&name](const CPUWork& work) { return work.name == name; });
+        if (it == cpuWork_.rend()) {
+            return;
+        }
+        
+        auto now = std::chrono::high_resolution_clock::now();
+        Profiling::HardwareCounterValues counters;
+        if (it->countersSampled && SampleHardwareCounters(counters)) {
+            Profiling::HardwareCounterProfiler::Get().Accumulate(name, counters - it->counters);
+        }
+        
+        if (it.base() - 1 == cpuWork_.begin()) {
+            frameCpuTime_ += std::chrono::duration<float, std::milli>(now - it->startTime).count();
+        }
+        
+        auto& histogram = workTimeHistograms_[name];
+        if (!histogram) {
+            histogram = std::make_unique<Profiling::LatencyHistogram>();
         }
+        histogram->Record(now - it->startTime);
+        
+        // Имя зоны должно жить до экспорта трассы
+        auto& zones = Profiling::ZoneProfiler::Get();
+        Profiling::ZoneProfiler::EndZone(it->zoneBegin != 0 ? zones.InternName(name) : nullptr, it->zoneBegin);
+        cpuWork_.erase(it.base() - 1);
+    }
+}
+
+bool PerformanceMonitor::SampleHardwareCounters(Profiling::HardwareCounterValues& values) {
+    if (!options_.enableHardwareCounters) {
+        return false;
     }
+    
+    // Включается по первому замеру: опция может прийти и через SetOptions
+    auto& profiler = Profiling::HardwareCounterProfiler::Get();
+    if (!profiler.IsEnabled()) {
+        profiler.Enable();
+    }
+    return profiler.Sample(values);
+}
+
+const Profiling::LatencyHistogram* PerformanceMonitor::GetWorkTimeHistogram(const std::string& name) const {
+    auto it = workTimeHistograms_.find(name);
+    return it != workTimeHistograms_.end() ? it->second.get() : nullptr;
 }
 
 void PerformanceMonitor::TrackDrawCall(size_t triangles) {
@@ -144,6 +203,9 @@ bool PerformanceMonitor::ShouldIncreaseQuality() const {
 
 void PerformanceMonitor::ResetStats() {
     stats_ = PerformanceStats();
+    frameTimeHistogram_.Reset();
+    cpuTimeHistogram_.Reset();
+    workTimeHistograms_.clear();
     frameCount_ = 0;
     fpsCounterStart_ = std::chrono::high_resolution_clock::now();
 }
@@ -154,9 +216,15 @@ void PerformanceMonitor::PrintReport() const {
         std::cout << "Current FPS: " << stats_.currentFPS << "\n";
         std::cout << "Average FPS: " << stats_.averageFPS << "\n";
         std::cout << "Frame Time: " << stats_.currentFrameTime << "ms\n";
+        std::cout << "Frame Time p50/p90/p99/p99.9: " << stats_.p50FrameTime << "/" << stats_.p90FrameTime << "/"
+                  << stats_.p99FrameTime << "/" << stats_.p999FrameTime << "ms\n";
         std::cout << "CPU Time: " << stats_.currentCpuTime << "ms\n";
         std::cout << "GPU Time: " << stats_.currentGpuTime << "ms\n";
         std::cout << "Memory Usage: " << stats_.usedMemory / (1024 * 1024) << "MB\n";
+        if (stats_.averageIPC > 0.0f) {
+            std::cout << "IPC: " << stats_.averageIPC << ", LLC miss rate: " << stats_.averageLLCMissRate * 100 << "%\n";
+            std::cout << Profiling::HardwareCounterProfiler::Get().FormatReport();
+        }
         std::cout << "Frame Drops: " << stats_.frameDrops << " (" << stats_.frameDropRate * 100 << "%)\n";
     }
 }
@@ -168,14 +236,35 @@ void PerformanceMonitor::SaveReportToFile(const std::string& filename) const {
         file << "Current FPS: " << stats_.currentFPS << "\n";
         file << "Average FPS: " << stats_.averageFPS << "\n";
         file << "Frame Time: " << stats_.currentFrameTime << "ms\n";
+        file << "Frame Time p50/p90/p99/p99.9: " << stats_.p50FrameTime << "/" << stats_.p90FrameTime << "/"
+             << stats_.p99FrameTime << "/" << stats_.p999FrameTime << "ms\n";
         file << "CPU Time: " << stats_.currentCpuTime << "ms\n";
         file << "GPU Time: " << stats_.currentGpuTime << "ms\n";
         file << "Memory Usage: " << stats_.usedMemory / (1024 * 1024) << "MB\n";
         file << "Frame Drops: " << stats_.frameDrops << "\n";
+        if (stats_.averageIPC > 0.0f) {
+            file << "IPC: " << stats_.averageIPC << ", LLC miss rate: " << stats_.averageLLCMissRate * 100 << "%\n";
+            file << Profiling::HardwareCounterProfiler::Get().FormatReport();
+        }
         file.close();
     }
 }
 
+void PerformanceMonitor::SaveHistogramsToFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (file.is_open()) {
+        file << "# Frame time, ms\n";
+        frameTimeHistogram_.WritePercentileDistribution(file);
+        file << "\n# CPU time, ms\n";
+        cpuTimeHistogram_.WritePercentileDistribution(file);
+        
+        for (const auto& [name, histogram] : workTimeHistograms_) {
+            file << "\n# " << name << ", ms\n";
+            histogram->WritePercentileDistribution(file);
+        }
+    }
+}
+
 void PerformanceMonitor::UpdateStats() {
     if (frameHistory_.empty()) return;
     
@@ -191,6 +280,12 @@ void PerformanceMonitor::UpdateStats() {
     
     if (elapsed >= 1.0f) {
         stats_.currentFPS = frameCount_ / elapsed;
+        
+        // Перцентили - раз в секунду: запрос проходит все корзины
+        stats_.p50FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(50.0) / 1e6);
+        stats_.p90FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(90.0) / 1e6);
+        stats_.p99FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(99.0) / 1e6);
+        stats_.p999FrameTime = static_cast<float>(frameTimeHistogram_.GetPercentile(99.9) / 1e6);
         if (OnFrameRateChanged) {
             OnFrameRateChanged(stats_.currentFPS);
         }
@@ -203,13 +298,21 @@ void PerformanceMonitor::UpdateStats() {
         float totalFrameTime = 0.0f;
         float totalCpuTime = 0.0f;
         float totalGpuTime = 0.0f;
+        Profiling::HardwareCounterValues totalCounters;
         
         for (const auto& frame : frameHistory_) {
             totalFrameTime += frame.frameTime;
             totalCpuTime += frame.cpuTime;
             totalGpuTime += frame.gpuTime;
+            if (frame.counters.valid_mask) {
+                totalCounters += frame.counters;
+            }
         }
         
+        // Отношения сумм, а не среднее отношений: кадры взвешены по циклам
+        stats_.averageIPC = static_cast<float>(totalCounters.GetIPC());
+        stats_.averageLLCMissRate = static_cast<float>(totalCounters.GetLLCMissRate());
+        
         size_t count = frameHistory_.size();
         stats_.averageFrameTime = totalFrameTime / count;
         stats_.averageCpuTime = totalCpuTime / count;
@@ -249,24 +352,4 @@ void PerformanceMonitor::DetectPerformanceIssues() {
     }
 }
 
-// FramePacer реализация
-FramePacer::FramePacer(float targetFPS) 
-    : targetFPS_(targetFPS), frameInterval_(1.0f / targetFPS) {
-    lastFrameTime_ = std::chrono::high_resolution_clock::now();
-}
-
-void FramePacer::WaitForNextFrame() {
-    if (!vsyncEnabled_) {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration<float>(now - lastFrameTime_).count();
-        
-        if (elapsed < frameInterval_) {
-            float sleepTime = frameInterval_ - elapsed;
-            std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
-        }
-        
-        lastFrameTime_ = std::chrono::high_resolution_clock::now();
-    }
-}
-
 }} // namespace window_winapi::rendering
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "window_winapi.h"
+#include "profiling/hardware_counters.h"
+#include "profiling/latency_histogram.h"
+#include "profiling/zone_profiler.h"
+#include "rendering/frame_pacer.h"
 #include <chrono>
 #include <deque>
 
@@ -17,6 +21,7 @@ struct FrameMetrics {
     size_t drawCalls = 0;        // Количество draw calls
     size_t triangles = 0;        // Количество треугольников
     size_t textureMemory = 0;    // Память текстур
+    Profiling::HardwareCounterValues counters;  // Счетчики CPU за кадр (enableHardwareCounters)
 };
 
 // Статистика производительности
@@ -39,6 +44,16 @@ struct PerformanceStats {
     float minFrameTime = FLT_MAX;
     float maxFrameTime = 0.0f;
     
+    // Аппаратные счетчики по истории кадров; 0 - недоступны
+    float averageIPC = 0.0f;
+    float averageLLCMissRate = 0.0f;    // 0..1
+    
+    // Перцентили времени кадра с момента ResetStats (мс)
+    float p50FrameTime = 0.0f;
+    float p90FrameTime = 0.0f;
+    float p99FrameTime = 0.0f;
+    float p999FrameTime = 0.0f;
+    
     // Память
     size_t usedMemory = 0;
     size_t totalMemory = 0;
@@ -56,6 +71,7 @@ struct MonitoringOptions {
     bool enableGPUProfiling = true;
     bool enableMemoryTracking = true;
     bool enableHitchDetection = true;
+    bool enableHardwareCounters = false;   // perf_event_open (Linux): кадры и участки CPU по подсистемам
     size_t historySize = 300;  // Количество кадров для статистики
     float hitchThreshold = 33.33f; // Порог для определения просадок
 };
@@ -74,6 +90,9 @@ public:
     void EndFrame();
     void BeginGPUWork();
     void EndGPUWork();
+    // Участки CPU вкладываются; в cpuTime кадра входят только внешние. При
+    // захвате ZoneProfiler участки и кадр попадают в трассу как зоны, при
+    // enableHardwareCounters счетчики участков копятся в HardwareCounterProfiler
     void BeginCPUWork(const std::string& name);
     void EndCPUWork(const std::string& name);
     
@@ -86,6 +105,11 @@ public:
     const PerformanceStats& GetStats() const { return stats_; }
     const std::deque<FrameMetrics>& GetFrameHistory() const { return frameHistory_; }
     
+    // Распределения с момента ResetStats; для сводки по окнам - LatencyHistogram::Merge
+    const Profiling::LatencyHistogram& GetFrameTimeHistogram() const { return frameTimeHistogram_; }
+    const Profiling::LatencyHistogram& GetCpuTimeHistogram() const { return cpuTimeHistogram_; }
+    const Profiling::LatencyHistogram* GetWorkTimeHistogram(const std::string& name) const;
+    
     // FPS управление
     void SetTargetFPS(float targetFPS) { targetFPS_ = targetFPS; }
     float GetTargetFPS() const { return targetFPS_; }
@@ -99,6 +123,7 @@ public:
     // Отчеты и логирование
     void PrintReport() const;
     void SaveReportToFile(const std::string& filename) const;
+    void SaveHistogramsToFile(const std::string& filename) const;   // Формат HdrHistogram (.hgrm)
     void EnableLogging(bool enable) { loggingEnabled_ = enable; }
     
     // Коллбэки для событий
@@ -114,7 +139,23 @@ private:
     // Таймеры
     std::chrono::high_resolution_clock::time_point frameStartTime_;
     std::chrono::high_resolution_clock::time_point gpuStartTime_;
-    std::unordered_map<std::string, std::chrono::high_resolution_clock::time_point> cpuTimers_;
+    struct CPUWork {
+        std::string name;
+        std::chrono::high_resolution_clock::time_point startTime;
+        int64_t zoneBegin;
+        Profiling::HardwareCounterValues counters;
+        bool countersSampled;
+    };
+    std::vector<CPUWork> cpuWork_;              // Стек открытых участков
+    float frameCpuTime_ = 0.0f;
+    int64_t frameZoneBegin_ = 0;
+    Profiling::HardwareCounterValues frameCounters_;
+    bool frameCountersSampled_ = false;
+    
+    // Распределения времени кадра, CPU кадра и участков BeginCPUWork по имени
+    Profiling::LatencyHistogram frameTimeHistogram_;
+    Profiling::LatencyHistogram cpuTimeHistogram_;
+    std::unordered_map<std::string, std::unique_ptr<Profiling::LatencyHistogram>> workTimeHistograms_;
     
     // Подсчет FPS
     float targetFPS_ = 60.0f;
@@ -126,29 +167,8 @@ private:
     
     void UpdateStats();
     void DetectPerformanceIssues();
+    bool SampleHardwareCounters(Profiling::HardwareCounterValues& values);
     float CalculateFrameTime(const FrameMetrics& metrics) const;
 };
 
-// Frame Pacing - сглаживание кадров
-class FramePacer {
-public:
-    FramePacer(float targetFPS = 60.0f);
-    
-    void SetTargetFPS(float fps) { targetFPS_ = fps; frameInterval_ = 1.0f / fps; }
-    float GetTargetFPS() const { return targetFPS_; }
-    
-    // Ожидание следующего кадра
-    void WaitForNextFrame();
-    
-    // VSync управление
-    void EnableVSync(bool enable) { vsyncEnabled_ = enable; }
-    bool IsVSyncEnabled() const { return vsyncEnabled_; }
-    
-private:
-    float targetFPS_;
-    float frameInterval_;
-    bool vsyncEnabled_ = true;
-    std::chrono::high_resolution_clock::time_point lastFrameTime_;
-};
-
 }} // namespace window_winapi::rendering
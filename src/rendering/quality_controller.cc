@@ -0,0 +1,241 @@
+#include "rendering/quality_controller.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace WxeUI {
+namespace rendering {
+
+namespace {
+
+constexpr uint32_t kMaxUpgradeFailures = 16;
+
+} // namespace
+
+QualityController::QualityController(const Config& config) {
+    SetConfig(config);
+    SetLadder(BuildLadder(QualitySettings{}));
+}
+
+void QualityController::SetConfig(const Config& config) {
+    config_ = config;
+    size_t windowFrames = std::max<size_t>(config_.windowFrames, 1);
+    if (window_.size() != windowFrames) {
+        window_.assign(windowFrames, 0.0f);
+        windowNext_ = 0;
+        windowCount_ = 0;
+    }
+}
+
+void QualityController::SetLadder(std::vector<QualitySettings> ladder) {
+    ladder_ = std::move(ladder);
+    if (ladder_.empty()) {
+        ladder_.push_back(QualitySettings{});
+    }
+    Reset();
+}
+
+std::vector<QualitySettings> QualityController::BuildLadder(const QualitySettings& top) {
+    std::vector<QualitySettings> ladder{top};
+    auto step = [&ladder](bool (*change)(QualitySettings&)) {
+        QualitySettings next = ladder.back();
+        if (change(next)) {
+            ladder.push_back(next);
+        }
+    };
+
+    // Только ручки, которые применяет Window::ApplyQualitySettings (размытие и
+    // тени AdvancedEffects, разрешение FragmentCache): ступень, ничего не
+    // меняющая в кадре, тратила бы понижение впустую. Антиалиасинг и LOD
+    // текстур рендерер пока не читает. Порядок - по заметности потери:
+    // половина размытия видна меньше всего, без теней и размытия - сильнее всего
+    step([](QualitySettings& s) {
+        if (!s.enableBlur || s.blurQuality <= 0.5f) return false;
+        s.blurQuality = 0.5f;
+        return true;
+    });
+    step([](QualitySettings& s) {
+        if (s.fragmentCacheScale <= 0.75f) return false;
+        s.fragmentCacheScale = 0.75f;
+        return true;
+    });
+    step([](QualitySettings& s) {
+        if (!s.enableShadows) return false;
+        s.enableShadows = false;
+        return true;
+    });
+    step([](QualitySettings& s) {
+        if (s.fragmentCacheScale <= 0.5f) return false;
+        s.fragmentCacheScale = 0.5f;
+        return true;
+    });
+    step([](QualitySettings& s) {
+        if (!s.enableBlur) return false;
+        s.enableBlur = false;
+        return true;
+    });
+
+    std::reverse(ladder.begin(), ladder.end());
+    return ladder;
+}
+
+bool QualityController::AddFrame(float frameTimeMs) {
+    frame_++;
+    window_[windowNext_] = frameTimeMs;
+    windowNext_ = (windowNext_ + 1) % window_.size();
+    windowCount_ = std::min(windowCount_ + 1, window_.size());
+
+    uint64_t sinceChange = frame_ - lastChangeFrame_;
+    if (lastUpgradedRung_ != SIZE_MAX && sinceChange >= config_.upgradeProbation) {
+        // Повышение удержалось: ступень снова доступна без удвоенной выдержки
+        upgradeFailures_[lastUpgradedRung_] = 0;
+        lastUpgradedRung_ = SIZE_MAX;
+    }
+
+    // Перегрузка видна по самим кадрам: окно после смены ступени и интервал
+    // решений ее не задерживают
+    float budget = std::max(config_.targetFrameMs, 0.001f);
+    overloadRun_ = frameTimeMs / budget > config_.emergencyAbove ? overloadRun_ + 1 : 0;
+    if (rung_ > 0 && overloadRun_ >= std::max<size_t>(config_.emergencyFrames, 1)) {
+        ChangeRung(rung_ - 1);
+        return true;
+    }
+
+    // Окно набирается заново после каждой смены ступени: кадры прежней
+    // ступени не говорят о стоимости текущей
+    if (windowCount_ < window_.size() || sinceEvaluation_++ % std::max<size_t>(config_.evaluateEvery, 1) != 0) {
+        return false;
+    }
+
+    float p90 = EvaluateP90();
+    if (!haveP90_ && changeP90_ > 0.0f && p90 > 0.0f) {
+        // Первое измерение после шага на соседнюю ступень: отношение их
+        // стоимостей почти не зависит от нагрузки сцены
+        size_t upper = std::max(rung_, changeFromRung_);
+        stepCost_[upper] = upper == rung_ ? p90 / changeP90_ : changeP90_ / p90;
+        changeP90_ = 0.0f;
+    }
+    smoothedP90_ = haveP90_ ? smoothedP90_ + config_.smoothing * (p90 - smoothedP90_) : p90;
+    haveP90_ = true;
+
+    float load = smoothedP90_ / budget;
+    float error = 0.0f;
+    if (load < config_.upgradeBelow) {
+        error = config_.upgradeBelow - load;
+    } else if (load > config_.downgradeAbove) {
+        error = config_.downgradeAbove - load;
+    }
+
+    // Интеграл ограничен соседними ступенями: долгая выдержка перед
+    // повышением не должна копить запас, мешающий потом понизить
+    float rung = static_cast<float>(rung_);
+    float top = static_cast<float>(ladder_.size() - 1);
+    integral_ = std::clamp(integral_ + config_.ki * error, std::max(rung - 1.0f, 0.0f), std::min(rung + 1.0f, top));
+    level_ = std::clamp(integral_ + config_.kp * error, 0.0f, top);
+
+    if (rung_ > 0 && p90 / budget > config_.emergencyAbove) {
+        // Перегрузка: сразу на ступень, которую называет регулятор, без выдержки
+        auto target = static_cast<size_t>(std::floor(level_));
+        ChangeRung(std::min(rung_ - 1, target));
+        return true;
+    }
+    if (rung_ > 0 && level_ < rung - config_.hysteresis && sinceChange >= config_.downgradeCooldown) {
+        ChangeRung(rung_ - 1);
+        return true;
+    }
+    if (rung_ + 1 < ladder_.size() && level_ > rung + config_.hysteresis &&
+        sinceChange >= GetUpgradeCooldown(rung_ + 1)) {
+        float stepCost = stepCost_[rung_ + 1];
+        if (stepCost > 0.0f && load * stepCost > config_.downgradeAbove) {
+            // Ступень выше уже измерена и не уложится: попытка дала бы откат
+            predictedRejects_++;
+            return false;
+        }
+        ChangeRung(rung_ + 1);
+        return true;
+    }
+    return false;
+}
+
+float QualityController::GetQuality() const {
+    if (ladder_.size() < 2) {
+        return 1.0f;
+    }
+    return static_cast<float>(rung_) / static_cast<float>(ladder_.size() - 1);
+}
+
+void QualityController::Reset() {
+    upgradeFailures_.assign(ladder_.size(), 0);
+    stepCost_.assign(ladder_.size(), 0.0f);
+    changeP90_ = 0.0f;
+    overloadRun_ = 0;
+    lastUpgradedRung_ = SIZE_MAX;
+    rung_ = ladder_.size() - 1;
+    integral_ = static_cast<float>(rung_);
+    level_ = integral_;
+    windowNext_ = 0;
+    windowCount_ = 0;
+    sinceEvaluation_ = 0;
+    haveP90_ = false;
+    smoothedP90_ = 0.0f;
+    lastChangeFrame_ = frame_;
+}
+
+QualityController::Stats QualityController::GetStats() const {
+    Stats stats;
+    stats.rung = rung_;
+    stats.rungCount = ladder_.size();
+    stats.quality = GetQuality();
+    stats.level = level_;
+    stats.smoothedP90Ms = smoothedP90_;
+    stats.frames = frame_;
+    stats.upgrades = upgrades_;
+    stats.downgrades = downgrades_;
+    stats.failedUpgrades = failedUpgrades_;
+    stats.predictedRejects = predictedRejects_;
+    return stats;
+}
+
+float QualityController::EvaluateP90() {
+    sortBuffer_.assign(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(windowCount_));
+    auto index = static_cast<std::ptrdiff_t>((windowCount_ * 9) / 10);
+    index = std::min(index, static_cast<std::ptrdiff_t>(windowCount_) - 1);
+    std::nth_element(sortBuffer_.begin(), sortBuffer_.begin() + index, sortBuffer_.end());
+    return sortBuffer_[static_cast<size_t>(index)];
+}
+
+size_t QualityController::GetUpgradeCooldown(size_t rung) const {
+    size_t cooldown = config_.upgradeCooldown << upgradeFailures_[rung];
+    return std::min(cooldown, std::max(config_.maxUpgradeCooldown, config_.upgradeCooldown));
+}
+
+void QualityController::ChangeRung(size_t rung) {
+    if (rung < rung_) {
+        downgrades_++;
+        // Откат недавнего повышения: следующая попытка на эту ступень - позже
+        if (lastUpgradedRung_ == rung_) {
+            upgradeFailures_[rung_] = std::min(upgradeFailures_[rung_] + 1, kMaxUpgradeFailures);
+            failedUpgrades_++;
+        }
+        lastUpgradedRung_ = SIZE_MAX;
+    } else {
+        upgrades_++;
+        lastUpgradedRung_ = rung;
+    }
+
+    bool neighbour = rung + 1 == rung_ || rung == rung_ + 1;
+    changeP90_ = neighbour && haveP90_ ? smoothedP90_ : 0.0f;
+    changeFromRung_ = rung_;
+    overloadRun_ = 0;
+
+    rung_ = rung;
+    integral_ = static_cast<float>(rung_);
+    level_ = integral_;
+    windowNext_ = 0;
+    windowCount_ = 0;
+    sinceEvaluation_ = 0;
+    haveP90_ = false;
+    lastChangeFrame_ = frame_;
+}
+
+}} // namespace WxeUI::rendering
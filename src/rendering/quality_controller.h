@@ -0,0 +1,124 @@
+#pragma once
+
+#include "rendering/quality_settings.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WxeUI {
+namespace rendering {
+
+// ============================================================================
+// Адаптивное качество: ПИ-регулятор по сглаженному p90 времени кадра
+// ============================================================================
+//
+// Качество - лестница QualitySettings: каждая ступень вниз меняет одну ручку,
+// которую применяет окно (качество размытия, тени, разрешение кэша
+// фрагментов). Регулятор интегрирует отклонение p90 от полосы
+// [upgradeBelow, downgradeAbove] бюджета кадра в непрерывный уровень;
+// ступень следует за уровнем с гистерезисом. Против колебаний:
+// - внутри полосы ошибка нулевая - уровень стоит;
+// - после смены ступени окно p90 набирается заново, затем выдержка
+//   (понижение - короткая, повышение - длинная);
+// - повышение не делается, если p90, пересчитанный через измеренное
+//   отношение стоимостей соседних ступеней, превысит порог понижения;
+// - повышение, откатившееся в течение испытательного срока, удваивает
+//   выдержку перед следующей попыткой на эту ступень.
+// Перегрузка (emergencyFrames кадров подряд дольше emergencyAbove бюджета)
+// понижает ступень сразу, не дожидаясь окна и очередного решения.
+// Состояние - у экземпляра: у каждого окна свой регулятор
+class QualityController {
+public:
+    struct Config {
+        Config() {}
+
+        float targetFrameMs = 1000.0f / 60.0f;  // Бюджет кадра
+        float upgradeBelow = 0.70f;             // p90 ниже этой доли бюджета - повышать
+        float downgradeAbove = 0.95f;           // p90 выше - понижать
+        float emergencyAbove = 1.5f;            // Кадры или p90 выше - понижение сразу, без выдержки
+        size_t emergencyFrames = 3;             // Подряд кадров выше emergencyAbove; одиночный всплеск не в счет
+        size_t windowFrames = 30;               // Окно p90
+        size_t evaluateEvery = 10;              // Кадров между решениями
+        float smoothing = 0.5f;                 // Вес нового p90 в скользящем среднем
+        float kp = 2.0f;
+        float ki = 0.5f;
+        float hysteresis = 0.6f;                // Отрыв уровня от ступени для ее смены
+        size_t downgradeCooldown = 20;          // Кадров после смены ступени
+        size_t upgradeCooldown = 120;
+        size_t maxUpgradeCooldown = 3840;       // Предел выдержки после неудачных повышений
+        size_t upgradeProbation = 300;          // Откат раньше - повышение неудачно
+    };
+
+    struct Stats {
+        size_t rung = 0;
+        size_t rungCount = 0;
+        float quality = 0.0f;                   // 0 - нижняя ступень, 1 - верхняя
+        float level = 0.0f;                     // Непрерывный уровень регулятора
+        float smoothedP90Ms = 0.0f;
+        uint64_t frames = 0;
+        uint64_t upgrades = 0;
+        uint64_t downgrades = 0;
+        uint64_t failedUpgrades = 0;            // Откаты в испытательный срок
+        uint64_t predictedRejects = 0;          // Повышения, отклоненные прогнозом стоимости
+    };
+
+    explicit QualityController(const Config& config = Config{});
+
+    void SetConfig(const Config& config);
+    const Config& GetConfig() const { return config_; }
+
+    // [0] - самое дешевое качество, последняя ступень - потолок. Ступень
+    // сбрасывается на потолок
+    void SetLadder(std::vector<QualitySettings> ladder);
+    const std::vector<QualitySettings>& GetLadder() const { return ladder_; }
+
+    // Лестница вниз от top: дешевые для глаза ручки - первыми
+    static std::vector<QualitySettings> BuildLadder(const QualitySettings& top);
+
+    // Время кадра, измеренное на текущей ступени; true - ступень сменилась
+    bool AddFrame(float frameTimeMs);
+
+    size_t GetRung() const { return rung_; }
+    const QualitySettings& GetSettings() const { return ladder_[rung_]; }
+    float GetQuality() const;
+
+    // Потолок лестницы, история неудачных повышений забывается
+    void Reset();
+
+    Stats GetStats() const;
+
+private:
+    Config config_;
+    std::vector<QualitySettings> ladder_;
+    size_t rung_ = 0;
+    float integral_ = 0.0f;                     // Уровень без пропорциональной части
+    float level_ = 0.0f;
+
+    std::vector<float> window_;                 // Кольцо времен кадров текущей ступени, мс
+    size_t windowNext_ = 0;
+    size_t windowCount_ = 0;
+    std::vector<float> sortBuffer_;
+    float smoothedP90_ = 0.0f;
+    bool haveP90_ = false;
+
+    uint64_t frame_ = 0;
+    uint64_t lastChangeFrame_ = 0;
+    size_t sinceEvaluation_ = 0;
+    size_t lastUpgradedRung_ = SIZE_MAX;        // Ступень последнего повышения
+    std::vector<uint32_t> upgradeFailures_;     // Подряд неудачных повышений на ступень
+    std::vector<float> stepCost_;               // p90 ступени / p90 ступени ниже; 0 - не измерено
+    float changeP90_ = 0.0f;                    // p90 до смены на соседнюю ступень
+    size_t overloadRun_ = 0;                    // Подряд кадров выше emergencyAbove
+    size_t changeFromRung_ = 0;
+
+    uint64_t upgrades_ = 0;
+    uint64_t downgrades_ = 0;
+    uint64_t failedUpgrades_ = 0;
+    uint64_t predictedRejects_ = 0;
+
+    float EvaluateP90();
+    size_t GetUpgradeCooldown(size_t rung) const;
+    void ChangeRung(size_t rung);
+};
+
+}} // namespace WxeUI::rendering
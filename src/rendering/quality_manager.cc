@@ -9,6 +9,7 @@ namespace rendering {
 QualityManager::QualityManager() {
     DetectHardwareCapabilities();
     settings_ = GetRecommendedSettings();
+    ResetQualityLadder();
 }
 
 QualityManager::~QualityManager() {
@@ -55,10 +56,12 @@ void QualityManager::SetQualityLevel(QualityLevel level) {
             settings_.enableMipmaps = true;
             break;
     }
+    ResetQualityLadder();
 }
 
 void QualityManager::SetQualitySettings(const QualitySettings& settings) {
     settings_ = settings;
+    ResetQualityLadder();
 }
 
 void QualityManager::UpdatePerformanceInfo(const PerformanceInfo& info) {
@@ -70,22 +73,29 @@ void QualityManager::UpdatePerformanceInfo(const PerformanceInfo& info) {
 }
 
 void QualityManager::AdaptQualityToPerformance() {
-    // Проверяем производительность
-    bool shouldReduce = performanceInfo_.frameTime > maxFrameTime_ ||
-                    performanceInfo_.cpuTime > maxCpuUsage_ ||
-                    performanceInfo_.gpuTime > maxGpuUsage_ ||
-                    performanceInfo_.isThrottling;
-    
-    bool shouldIncrease = performanceInfo_.frameTime < maxFrameTime_ * 0.7f &&
-                    performanceInfo_.cpuTime < maxCpuUsage_ * 0.7f &&
-                    performanceInfo_.gpuTime < maxGpuUsage_ * 0.7f &&
-                    !performanceInfo_.isThrottling;
-    
-    if (shouldReduce) {
-        OptimizeForPerformance();
-    } else if (shouldIncrease) {
-        OptimizeForQuality();
+    // Троттлинг и загрузка CPU/GPU видны во времени кадра - решение только по нему
+    AddFrameTime(performanceInfo_.frameTime);
+}
+
+bool QualityManager::AddFrameTime(float frameTimeMs) {
+    if (!qualityController_.AddFrame(frameTimeMs)) {
+        return false;
     }
+    settings_ = qualityController_.GetSettings();
+    return true;
+}
+
+void QualityManager::SetTargetFrameRate(float fps) {
+    QualityController::Config config = qualityController_.GetConfig();
+    config.targetFrameMs = 1000.0f / std::max(fps, 1.0f);
+    qualityController_.SetConfig(config);
+}
+
+void QualityManager::SetPerformanceThresholds(float minFPS, float targetFPS) {
+    QualityController::Config config = qualityController_.GetConfig();
+    config.targetFrameMs = 1000.0f / std::max(targetFPS, 1.0f);
+    config.emergencyAbove = std::max(targetFPS / std::max(minFPS, 1.0f), config.downgradeAbove);
+    qualityController_.SetConfig(config);
 }
 
 void QualityManager::ApplyToSkiaContext(GrDirectContext* context) {
@@ -148,40 +158,9 @@ QualitySettings QualityManager::GetRecommendedSettings() const {
     return recommended;
 }
 
-void QualityManager::OptimizeForPerformance() {
-    // Понижаем настройки для улучшения производительности
-    if (settings_.antiAliasing == AntiAliasingType::MSAA_8X) {
-        settings_.antiAliasing = AntiAliasingType::MSAA_4X;
-    } else if (settings_.antiAliasing == AntiAliasingType::MSAA_4X) {
-        settings_.antiAliasing = AntiAliasingType::MSAA_2X;
-    } else if (settings_.antiAliasing == AntiAliasingType::MSAA_2X) {
-        settings_.antiAliasing = AntiAliasingType::None;
-    }
-    
-    if (settings_.maxTextureSize > 2048) {
-        settings_.maxTextureSize /= 2;
-    }
-    
-    settings_.enableBlur = false;
-    settings_.enableShadows = false;
-}
-
-void QualityManager::OptimizeForQuality() {
-    // Повышаем настройки при достаточной производительности
-    if (settings_.antiAliasing == AntiAliasingType::None) {
-        settings_.antiAliasing = AntiAliasingType::MSAA_2X;
-    } else if (settings_.antiAliasing == AntiAliasingType::MSAA_2X) {
-        settings_.antiAliasing = AntiAliasingType::MSAA_4X;
-    } else if (settings_.antiAliasing == AntiAliasingType::MSAA_4X) {
-        settings_.antiAliasing = AntiAliasingType::MSAA_8X;
-    }
-    
-    if (settings_.maxTextureSize < 8192) {
-        settings_.maxTextureSize *= 2;
-    }
-    
-    settings_.enableBlur = true;
-    settings_.enableShadows = true;
+void QualityManager::ResetQualityLadder() {
+    // Явно заданные настройки - новый потолок; регулятор начинает с него
+    qualityController_.SetLadder(QualityController::BuildLadder(settings_));
 }
 
 }} // namespace window_winapi::rendering
@@ -3,43 +3,12 @@
 #include "window_winapi.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/core/SkImageInfo.h"
+#include "rendering/quality_controller.h"
+#include "rendering/quality_settings.h"
 
 namespace WxeUI {
 namespace rendering {
 
-// Уровни качества рендеринга
-enum class QualityLevel {
-    Low,     // Базовая производительность, минимальные эффекты
-    Medium,  // Сбалансированные настройки
-    High,    // Высокое качество с расширенными эффектами
-    Ultra    // Максимальное качество, все возможные улучшения
-};
-
-// Типы антиалиасинга
-enum class AntiAliasingType {
-    None,
-    MSAA_2X,
-    MSAA_4X,
-    MSAA_8X,
-    FXAA,
-    TAA
-};
-
-// Настройки качества
-struct QualitySettings {
-    QualityLevel level = QualityLevel::Medium;
-    AntiAliasingType antiAliasing = AntiAliasingType::MSAA_4X;
-    bool enableHDR = false;
-    bool enableWideColorGamut = false;
-    bool enableGPUAcceleration = true;
-    bool enableTextureFiltering = true;
-    bool enableShadows = true;
-    bool enableBlur = true;
-    int maxTextureSize = 8192;
-    float lodBias = 0.0f;
-    bool enableMipmaps = true;
-};
-
 // Информация о производительности
 struct PerformanceInfo {
     float frameTime = 0.0f;
@@ -62,13 +31,23 @@ public:
     void SetQualitySettings(const QualitySettings& settings);
     const QualitySettings& GetQualitySettings() const { return settings_; }
     
-    // Адаптивное управление качеством
+    // Адаптивное управление качеством: текущие настройки - потолок лестницы
+    // QualityController, регулятор опускает и поднимает ступени под ним
     void EnableAdaptiveQuality(bool enable) { adaptiveQuality_ = enable; }
     bool IsAdaptiveQualityEnabled() const { return adaptiveQuality_; }
     
     void UpdatePerformanceInfo(const PerformanceInfo& info);
     void AdaptQualityToPerformance();
     
+    // Время кадра для регулятора; true - настройки сменились
+    bool AddFrameTime(float frameTimeMs);
+    void SetTargetFrameRate(float fps);
+    // Кадры дольше 1/minFPS - понижение без выдержки
+    void SetPerformanceThresholds(float minFPS, float targetFPS);
+    
+    QualityController& GetQualityController() { return qualityController_; }
+    const QualityController& GetQualityController() const { return qualityController_; }
+    
     // Применение настроек к Skia контексту
     void ApplyToSkiaContext(GrDirectContext* context);
     SkImageInfo CreateOptimalImageInfo(int width, int height);
@@ -81,15 +60,9 @@ private:
     QualitySettings settings_;
     PerformanceInfo performanceInfo_;
     bool adaptiveQuality_ = false;
+    QualityController qualityController_;
     
-    // Целевые значения производительности
-    float targetFrameRate_ = 60.0f;
-    float maxFrameTime_ = 16.67f; // 60 FPS
-    float maxCpuUsage_ = 80.0f;
-    float maxGpuUsage_ = 85.0f;
-    
-    void OptimizeForPerformance();
-    void OptimizeForQuality();
+    void ResetQualityLadder();
 };
 
 }} // namespace window_winapi::rendering
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace WxeUI {
+namespace rendering {
+
+// Уровни качества рендеринга
+enum class QualityLevel {
+    Low,     // Базовая производительность, минимальные эффекты
+    Medium,  // Сбалансированные настройки
+    High,    // Высокое качество с расширенными эффектами
+    Ultra    // Максимальное качество, все возможные улучшения
+};
+
+// Типы антиалиасинга
+enum class AntiAliasingType {
+    None,
+    MSAA_2X,
+    MSAA_4X,
+    MSAA_8X,
+    FXAA,
+    TAA
+};
+
+// Настройки качества
+struct QualitySettings {
+    QualityLevel level = QualityLevel::Medium;
+    AntiAliasingType antiAliasing = AntiAliasingType::MSAA_4X;
+    bool enableHDR = false;
+    bool enableWideColorGamut = false;
+    bool enableGPUAcceleration = true;
+    bool enableTextureFiltering = true;
+    bool enableShadows = true;
+    bool enableBlur = true;
+    float blurQuality = 1.0f;           // Доля радиуса и выборок размытия
+    int maxTextureSize = 8192;
+    float lodBias = 0.0f;
+    bool enableMipmaps = true;
+    float fragmentCacheScale = 1.0f;    // Разрешение кэшированных фрагментов относительно экрана
+};
+
+}} // namespace WxeUI::rendering
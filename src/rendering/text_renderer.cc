@@ -1,9 +1,14 @@
 #include "rendering/text_renderer.h"
+#include "memory/memory_tags.h"
+#include "include/core/SkFontMetrics.h"
 #include <iostream>
+#include <sstream>
 
 namespace WxeUI {
 namespace rendering {
 
+static const Memory::MemoryTagId kTextRendererTag = Memory::MemoryTags::Register("TextRenderer");
+
 TextRenderer::TextRenderer() {
     fontMgr_ = SkFontMgr::RefDefault();
 }
@@ -99,6 +104,8 @@ void TextRenderer::DrawText(SkCanvas* canvas, const std::u16string& text, float
 }
 
 sk_sp<SkTextBlob> TextRenderer::ShapeText(const std::string& text, const TextStyle& style, const TextFeatures& features) {
+    Memory::ScopedMemoryTag memory_tag(kTextRendererTag);
+
     if (!shaper_ || text.empty()) return nullptr;
     
     SkFont font = CreateSkFont(style);
@@ -117,6 +124,8 @@ sk_sp<SkTextBlob> TextRenderer::ShapeText(const std::u16string& text, const Text
 }
 
 TextLayout TextRenderer::LayoutText(const std::string& text, const TextStyle& style, float maxWidth) {
+    Memory::ScopedMemoryTag memory_tag(kTextRendererTag);
+
     TextLayout layout;
     
     if (text.empty() || maxWidth <= 0) {
@@ -127,13 +136,15 @@ TextLayout TextRenderer::LayoutText(const std::string& text, const TextStyle& st
     SkPaint paint;
     paint.setColor(style.color);
     
-    std::vector<std::string> words;
+    // Слова живут только до конца раскладки - берем память из арены кадра
+    std::pmr::memory_resource* resource = frameArena_ ? frameArena_->GetResource() : std::pmr::get_default_resource();
+    std::pmr::vector<std::pmr::string> words(resource);
     std::stringstream ss(text);
     std::string word;
     
     // Разбиваем на слова
     while (ss >> word) {
-        words.push_back(word);
+        words.emplace_back(word);
     }
     
     std::string currentLine;
@@ -1,11 +1,19 @@
 #pragma once
 
-#include "window_winapi.h"
+#include "memory/frame_arena.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkFontStyle.h"
 #include "modules/skshaper/include/SkShaper.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace WxeUI {
 namespace rendering {
@@ -87,12 +95,16 @@ public:
     bool SupportsEmoji() const;
     void EnableColorEmoji(bool enable) { colorEmoji_ = enable; }
     
+    // Временные буферы раскладки берутся из арены кадра (nullptr - обычная куча)
+    void SetFrameArena(Memory::FrameArena* arena) { frameArena_ = arena; }
+    
 private:
     sk_sp<SkFontMgr> fontMgr_;
     std::unique_ptr<SkShaper> shaper_;
     std::unordered_map<std::string, sk_sp<SkTypeface>> loadedFonts_;
     TextFeatures defaultFeatures_;
     bool colorEmoji_ = true;
+    Memory::FrameArena* frameArena_ = nullptr;
     
     sk_sp<SkTextBlob> CreateTextBlob(const std::string& text, const SkFont& font);
     SkFont CreateSkFont(const TextStyle& style);
@@ -1,4 +1,6 @@
 #include "rendering/vector_graphics.h"
+#include "include/effects/SkDashPathEffect.h"
+#include <cmath>
 
 namespace WxeUI {
 namespace rendering {
@@ -14,10 +16,24 @@ namespace rendering {
     // Создание путей
     SkPath VectorGraphics::CreatePath(const std::vector<PathCommandData>& commands) {}
     SkPath VectorGraphics::CreateRectPath(const SkRect& rect, float rx, float ry) {}
-    SkPath VectorGraphics::CreateCirclePath(const SkPoint& center, float radius) {}
+    SkPath VectorGraphics::CreateCirclePath(const SkPoint& center, float radius) {
+        return SkPath::Circle(center.x(), center.y(), radius);
+    }
     SkPath VectorGraphics::CreateEllipsePath(const SkRect& bounds) {}
-    SkPath VectorGraphics::CreatePolygonPath(const std::vector<SkPoint>& points, bool closed) {}
-    SkPath VectorGraphics::CreateStarPath(const SkPoint& center, float outerRadius, float innerRadius, int points) {}
+    SkPath VectorGraphics::CreatePolygonPath(const std::vector<SkPoint>& points, bool closed) {
+        return SkPath::Polygon(points.data(), static_cast<int>(points.size()), closed);
+    }
+    SkPath VectorGraphics::CreateStarPath(const SkPoint& center, float outerRadius, float innerRadius, int points) {
+        // Вершины чередуются по внешнему и внутреннему радиусу, первая - сверху
+        std::vector<SkPoint> vertices;
+        vertices.reserve(points * 2);
+        for (int i = 0; i < points * 2; ++i) {
+            float angle = SK_ScalarPI * i / points - SK_ScalarPI / 2.0f;
+            float radius = (i % 2 == 0) ? outerRadius : innerRadius;
+            vertices.push_back(SkPoint::Make(center.x() + radius * std::cos(angle), center.y() + radius * std::sin(angle)));
+        }
+        return CreatePolygonPath(vertices, true);
+    }
     
     // SVG-подобные операции
     SkPath VectorGraphics::ParseSVGPath(const std::string& pathData) {}
@@ -48,20 +64,84 @@ namespace rendering {
     SkVector VectorGraphics::GetTangentAtDistance(const SkPath& path, float distance) {}
     
     // Рендеринг
-    void VectorGraphics::DrawPath(SkCanvas* canvas, const SkPath& path, const VectorStyle& style) {}
+    void VectorGraphics::DrawPath(SkCanvas* canvas, const SkPath& path, const VectorStyle& style) {
+        if (!canvas) {
+            return;
+        }
+        
+        if (style.hasFill) {
+            if (style.fillType != path.getFillType()) {
+                SkPath filled = path;
+                filled.setFillType(style.fillType);
+                canvas->drawPath(filled, CreateFillPaint(style));
+            } else {
+                canvas->drawPath(path, CreateFillPaint(style));
+            }
+        }
+        if (style.hasStroke) {
+            canvas->drawPath(path, CreateStrokePaint(style));
+        }
+    }
     void VectorGraphics::DrawMultiplePaths(SkCanvas* canvas, const std::vector<SkPath>& paths, const std::vector<VectorStyle>& styles) {}
     
     // Сложные формы
     SkPath VectorGraphics::CreateArrowPath(const SkPoint& start, const SkPoint& end, float headSize, float tailWidth) {}
     SkPath VectorGraphics::CreateBezierCurve(const SkPoint& start, const SkPoint& control1, const SkPoint& control2, const SkPoint& end) {}
-    SkPath VectorGraphics::CreateSpline(const std::vector<SkPoint>& points, float tension) {}
+    SkPath VectorGraphics::CreateSpline(const std::vector<SkPoint>& points, float tension) {
+        // Catmull-Rom через точки; tension 0.5 - классический сплайн
+        SkPathBuilder builder;
+        if (points.empty()) {
+            return builder.detach();
+        }
+        
+        builder.moveTo(points[0]);
+        float scale = tension / 3.0f;
+        for (size_t i = 0; i + 1 < points.size(); ++i) {
+            const SkPoint& p0 = points[i > 0 ? i - 1 : i];
+            const SkPoint& p1 = points[i];
+            const SkPoint& p2 = points[i + 1];
+            const SkPoint& p3 = points[i + 2 < points.size() ? i + 2 : i + 1];
+            
+            builder.cubicTo(p1 + (p2 - p0) * scale, p2 - (p3 - p1) * scale, p2);
+        }
+        return builder.detach();
+    }
     SkPath VectorGraphics::CreateTextPath(const std::string& text, const SkFont& font, const SkPoint& origin) {}
     
     void VectorGraphics::ClearPathCache() {}
     void VectorGraphics::OptimizeForRendering(SkPath& path) {}
     
-    SkPaint VectorGraphics::CreateStrokePaint(const VectorStyle& style) {}
-    SkPaint VectorGraphics::CreateFillPaint(const VectorStyle& style) {}
+    SkPaint VectorGraphics::CreateStrokePaint(const VectorStyle& style) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setColor(style.strokeColor);
+        paint.setAlphaf(paint.getAlphaf() * style.opacity);
+        paint.setStrokeWidth(style.strokeWidth);
+        paint.setStrokeCap(style.strokeCap);
+        paint.setStrokeJoin(style.strokeJoin);
+        paint.setStrokeMiter(style.miterLimit);
+        paint.setBlendMode(style.blendMode);
+        paint.setImageFilter(style.filter);
+        
+        if (style.dashPattern.size() >= 2) {
+            paint.setPathEffect(SkDashPathEffect::Make(style.dashPattern.data(),
+                                                       static_cast<int>(style.dashPattern.size() & ~size_t(1)),
+                                                       style.dashOffset));
+        }
+        return paint;
+    }
+    SkPaint VectorGraphics::CreateFillPaint(const VectorStyle& style) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setColor(style.fillColor);
+        paint.setAlphaf(paint.getAlphaf() * style.opacity);
+        paint.setShader(style.fillShader);
+        paint.setBlendMode(style.blendMode);
+        paint.setImageFilter(style.filter);
+        return paint;
+    }
     std::string VectorGraphics::HashVectorStyle(const VectorStyle& style) {}
     
     // Помощники для SVG парсинга
@@ -1,10 +1,18 @@
 #pragma once
 
-#include "window_winapi.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImageFilter.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathBuilder.h"
 #include "include/core/SkRRect.h"
 #include "include/pathops/SkPathOps.h"
+#include "include/core/SkShader.h"
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace WxeUI {
 namespace rendering {
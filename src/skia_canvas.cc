@@ -1,4 +1,6 @@
 #include "window_winapi.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace WxeUI {
@@ -6,6 +8,9 @@ namespace WxeUI {
 // ================== FragmentCache ==================
 
 sk_sp<SkSurface> FragmentCache::GetCachedSurface(const std::string& key, int width, int height) {
+    int surfaceWidth = std::max(1, static_cast<int>(std::ceil(static_cast<float>(width) * resolutionScale_)));
+    int surfaceHeight = std::max(1, static_cast<int>(std::ceil(static_cast<float>(height) * resolutionScale_)));
+    
     auto it = cache_.find(key);
     
     if (it != cache_.end()) {
@@ -14,7 +19,7 @@ sk_sp<SkSurface> FragmentCache::GetCachedSurface(const std::string& key, int wid
         
         // Проверяем, подходит ли размер
         auto surface = it->second.surface;
-        if (surface && surface->width() == width && surface->height() == height) {
+        if (surface && surface->width() == surfaceWidth && surface->height() == surfaceHeight) {
             return surface;
         }
         
@@ -23,10 +28,14 @@ sk_sp<SkSurface> FragmentCache::GetCachedSurface(const std::string& key, int wid
     }
     
     // Создаем новую поверхность
-    SkImageInfo info = SkImageInfo::MakeN32Premul(width, height);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(surfaceWidth, surfaceHeight);
     sk_sp<SkSurface> surface = SkSurface::MakeRaster(info);
     
     if (surface) {
+        if (resolutionScale_ != 1.0f) {
+            surface->getCanvas()->scale(resolutionScale_, resolutionScale_);
+        }
+        
         // Добавляем в кэш
         CacheEntry entry;
         entry.surface = surface;
@@ -63,6 +72,18 @@ void FragmentCache::SetMaxCacheSize(size_t maxSize) {
     }
 }
 
+void FragmentCache::SetResolutionScale(float scale) {
+    scale = std::clamp(scale, 0.1f, 1.0f);
+    if (scale == resolutionScale_) {
+        return;
+    }
+    
+    // Поверхности прежнего разрешения не пригодны: память освобождается сразу,
+    // а не по мере запросов
+    resolutionScale_ = scale;
+    ClearCache();
+}
+
 void FragmentCache::GarbageCollect() {
     // Удаляем старые записи
     auto now = std::chrono::steady_clock::now();
@@ -107,7 +107,9 @@ void SkiaCanvas::BeginFragment(const std::string& fragmentId) {
         // Использование кэшированного фрагмента
         auto cachedSurface = cache_->GetCachedSurface(fragmentId, surface_->width(), surface_->height());
         if (cachedSurface) {
-            canvas_->drawImage(cachedSurface->makeImageSnapshot(), 0, 0);
+            // Поверхность кэша может быть уменьшена (FragmentCache::SetResolutionScale)
+            SkRect bounds = SkRect::MakeIWH(surface_->width(), surface_->height());
+            canvas_->drawImageRect(cachedSurface->makeImageSnapshot(), bounds, SkSamplingOptions(SkFilterMode::kLinear), nullptr);
         }
     }
 }
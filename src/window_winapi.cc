@@ -32,6 +32,8 @@ Window::Window(const WindowConfig& config)
     memoryManager_.Initialize();
     qualityManager_.Initialize();
     performanceMonitor_.Initialize();
+    textRenderer_.Initialize();
+    textRenderer_.SetFrameArena(&frameArena_);
     
     // Включение event system по умолчанию
     EnableEventSystem(true);
@@ -39,7 +41,11 @@ Window::Window(const WindowConfig& config)
 
 // Деструктор Window
 Window::~Window() {
+    // Поток FrameHigh рисует это окно: он останавливается раньше, чем
+    // разрушаются члены и освобождается канал рендеринга
+    frameHigh_.StopHighFrequencyRendering();
     Destroy();
+    events::EventSystem::GetDispatcher().ReleaseFrameChannel(frameChannel_);
 }
 
 // Создание окна
@@ -187,9 +193,7 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 
                 // Уведомление через event system
                 if (eventSystemEnabled_) {
-                    events::EventSystem::Dispatch(
-                        std::make_unique<events::WindowResizeEvent>(width_, height_)
-                    );
+                    events::EventSystem::DispatchTo<events::WindowResizeEvent>(GetInputChannel(), width_, height_);
                 }
                 
                 if (OnResize) {
@@ -222,9 +226,7 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             
             // Уведомление через event system
             if (eventSystemEnabled_) {
-                events::EventSystem::Dispatch(
-                    std::make_unique<events::DPIChangedEvent>(oldDPI, dpiScale_)
-                );
+                events::EventSystem::DispatchTo<events::DPIChangedEvent>(GetInputChannel(), oldDPI, dpiScale_);
             }
             
             if (OnDPIChanged) {
@@ -238,10 +240,12 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             int y = HIWORD(lParam);
             
             if (eventSystemEnabled_) {
-                events::EventSystem::Dispatch(
-                    std::make_unique<events::MouseMoveEvent>(x, y)
-                );
+                int deltaX = lastMouseX_ >= 0 ? x - lastMouseX_ : 0;
+                int deltaY = lastMouseY_ >= 0 ? y - lastMouseY_ : 0;
+                events::EventSystem::DispatchTo<events::MouseMoveEvent>(GetInputChannel(), x, y, deltaX, deltaY);
             }
+            lastMouseX_ = x;
+            lastMouseY_ = y;
             
             if (OnMouseMove) {
                 OnMouseMove(x, y, static_cast<UINT>(wParam));
@@ -268,9 +272,7 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             }
             
             if (eventSystemEnabled_) {
-                events::EventSystem::Dispatch(
-                    std::make_unique<events::MouseButtonEvent>(button, pressed)
-                );
+                events::EventSystem::DispatchTo<events::MouseButtonEvent>(GetInputChannel(), button, pressed);
             }
             
             if (OnMouseButton) {
@@ -285,9 +287,7 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             bool repeat = (lParam & 0x40000000) != 0;
             
             if (eventSystemEnabled_) {
-                events::EventSystem::Dispatch(
-                    std::make_unique<events::KeyboardEvent>(static_cast<int>(wParam), pressed, repeat)
-                );
+                events::EventSystem::DispatchTo<events::KeyboardEvent>(GetInputChannel(), static_cast<int>(wParam), pressed, repeat);
             }
             
             if (OnKeyboard) {
@@ -298,9 +298,7 @@ LRESULT Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         
         case WM_CLOSE:
             if (eventSystemEnabled_) {
-                events::EventSystem::Dispatch(
-                    std::make_unique<events::WindowCloseEvent>()
-                );
+                events::EventSystem::DispatchTo<events::WindowCloseEvent>(GetInputChannel());
             }
             
             if (OnClose) {
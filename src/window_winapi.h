@@ -14,6 +14,7 @@
 #include <unordered_map>
 #include <string>
 #include <chrono>
+#include <atomic>
 
 // Подключение Skia
 #include "include/core/SkCanvas.h"
@@ -23,8 +24,11 @@
 // Подключение новых компонентов
 #include "graphics/graphics_manager.h"
 #include "memory/memory_manager.h"
+#include "memory/frame_arena.h"
 #include "rendering/quality_manager.h"
 #include "rendering/performance_monitor.h"
+#include "rendering/advanced_effects.h"
+#include "rendering/text_renderer.h"
 #include "features/openscreen.h"
 #include "events/event_system.h"
 
@@ -155,9 +159,16 @@ public:
     void SetMaxCacheSize(size_t maxSize);
     void GarbageCollect();
     
+    // Разрешение поверхностей относительно запрошенного размера (ступень
+    // качества). Канва поверхности уже масштабирована: рисуют в координатах
+    // фрагмента, на экран - растягивая снимок на полный размер
+    void SetResolutionScale(float scale);
+    float GetResolutionScale() const { return resolutionScale_; }
+    
 private:
     std::unordered_map<std::string, CacheEntry> cache_;
     size_t maxCacheSize_ = 100;
+    float resolutionScale_ = 1.0f;
     std::chrono::minutes maxAge_{10};
 };
 
@@ -244,13 +255,25 @@ public:
     // Graphics management
     graphics::GraphicsManager& GetGraphicsManager() { return graphicsManager_; }
     memory::MemoryManager& GetMemoryManager() { return memoryManager_; }
+    Memory::FrameArena& GetFrameArena() { return frameArena_; }
     rendering::QualityManager& GetQualityManager() { return qualityManager_; }
+    // Фильтры с размытием и тенями текущей ступени качества
+    rendering::AdvancedEffects& GetEffects() { return effects_; }
+    // Раскладка текста - в потоке рендеринга: временные буферы из арены кадра
+    rendering::TextRenderer& GetTextRenderer() { return textRenderer_; }
     rendering::PerformanceMonitor& GetPerformanceMonitor() { return performanceMonitor_; }
     
     // Event system
     void EnableEventSystem(bool enable = true);
     bool IsEventSystemEnabled() const { return eventSystemEnabled_; }
     
+    // Ввод окна - через его канал рендеринга: доставляется потоком рендеринга
+    // этого окна в начале Render(), перед layout, а не потоками обработки (FrameHigh)
+    void SetRenderThreadInput(bool enable) { renderThreadInput_ = enable; }
+    bool IsRenderThreadInput() const { return renderThreadInput_; }
+    // Момент сбора ввода последнего кадра (поток рендеринга)
+    std::chrono::steady_clock::time_point GetInputLatchTime() const { return inputLatchTime_; }
+    
 protected:
     virtual LRESULT WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
     
@@ -259,7 +282,11 @@ private:
     
     void UpdateDPI();
     void UpdateRenderStats();
+    events::EventChannel GetInputChannel() const {
+        return renderThreadInput_ && events::EventDispatcher::IsFrameChannel(frameChannel_) ? frameChannel_ : eventChannel_;
+    }
     void Render();
+    void ApplyQualitySettings();
     void Update(float deltaTime);
     
     HWND hwnd_;
@@ -282,10 +309,19 @@ private:
     
     graphics::GraphicsManager graphicsManager_;
     memory::MemoryManager memoryManager_;
+    Memory::FrameArena frameArena_;          // Временные данные кадра, сброс в Render()
     rendering::QualityManager qualityManager_;
+    rendering::AdvancedEffects effects_;
+    rendering::TextRenderer textRenderer_;
     rendering::PerformanceMonitor performanceMonitor_;
     
     bool eventSystemEnabled_ = false;
+    events::EventChannel eventChannel_ = events::EventDispatcher::CreateChannel();  // Ввод окна - в порядке поступления
+    events::EventChannel frameChannel_ = events::EventSystem::GetDispatcher().CreateFrameChannel();  // Ввод окна в потоке рендеринга
+    std::atomic<bool> renderThreadInput_{false};
+    std::chrono::steady_clock::time_point inputLatchTime_;
+    int lastMouseX_ = -1;                    // Для приращений MouseMoveEvent
+    int lastMouseY_ = -1;
     
     static const wchar_t* ClassName;
     static bool classRegistered_;
@@ -89,9 +89,7 @@ void Window::Update(float deltaTime) {
     
     // Уведомление через event system
     if (eventSystemEnabled_) {
-        events::EventSystem::Dispatch(
-            std::make_unique<events::UpdateEvent>(deltaTime)
-        );
+        events::EventSystem::Dispatch<events::UpdateEvent>(deltaTime);
     }
     
     if (OnUpdate) {
@@ -99,6 +97,12 @@ void Window::Update(float deltaTime) {
     }
 }
 
+void Window::ApplyQualitySettings() {
+    const rendering::QualitySettings& settings = qualityManager_.GetQualitySettings();
+    effects_.SetQualitySettings(settings);
+    fragmentCache_.SetResolutionScale(settings.fragmentCacheScale);
+}
+
 // Дополнение метода Render
 void Window::Render() {
     if (!graphicsContext_) {
@@ -119,6 +123,27 @@ void Window::Render() {
     // Начало кадра для PerformanceMonitor
     performanceMonitor_.BeginFrame();
     
+    // Буфер кадра, отрисованного buffer_count кадров назад, сбрасывается целиком
+    frameArena_.BeginFrame();
+    
+    // Коалесцированный ввод окна (мышь, resize) уходит в очередь один раз за
+    // кадр, затем - события канала рендеринга, доставляемые в этом потоке. С
+    // SetRenderThreadInput здесь же синхронно доставляется весь ввод окна.
+    // Ввод других окон ждет их кадров
+    if (eventSystemEnabled_) {
+        WXE_ZONE("FrameEvents");
+        events::EventDispatcher& dispatcher = events::EventSystem::GetDispatcher();
+        dispatcher.FlushCoalesced(eventChannel_);
+        if (events::EventDispatcher::IsFrameChannel(frameChannel_)) {
+            dispatcher.FlushCoalesced(frameChannel_);
+            dispatcher.DeliverFrameEvents(frameChannel_);
+        }
+    }
+    inputLatchTime_ = std::chrono::steady_clock::now();
+    
+    // Ступень, выбранная регулятором по прошлым кадрам, действует с этого кадра
+    ApplyQualitySettings();
+    
     // Очистка canvas с учетом качества
     float quality = qualityManager_.GetCurrentQuality();
     canvas->clear(SK_ColorBLACK);
@@ -127,17 +152,19 @@ void Window::Render() {
     SkPaint::Hinting hinting = quality > 0.8f ? SkPaint::kFull_Hinting : SkPaint::kSlight_Hinting;
     
     // Рендеринг слоев
-    layerSystem_.RenderLayers(canvas);
+    {
+        WXE_COUNTED_ZONE("RenderLayers");
+        layerSystem_.RenderLayers(canvas);
+    }
     
     // Уведомление через event system
     if (eventSystemEnabled_) {
-        events::EventSystem::DispatchImmediate(
-            std::make_unique<events::RenderEvent>(canvas)
-        );
+        events::EventSystem::DispatchImmediate(events::RenderEvent(canvas));
     }
     
     // Пользовательский рендеринг
     if (OnRender) {
+        WXE_COUNTED_ZONE("OnRender");
         OnRender(canvas);
     }
     
@@ -145,7 +172,10 @@ void Window::Render() {
     performanceMonitor_.EndFrame();
     
     // Презентация
-    graphicsContext_->Present();
+    {
+        WXE_ZONE("Present");
+        graphicsContext_->Present();
+    }
     
     // Обновление статистики
     UpdateRenderStats();